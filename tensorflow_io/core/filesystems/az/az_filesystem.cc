@@ -24,6 +24,7 @@ limitations under the License.
 #include <io.h>
 #endif
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
@@ -31,6 +32,7 @@ limitations under the License.
 #include "azure/storage/blobs/block_blob_client.hpp"
 #include "tensorflow/c/logging.h"
 #include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/expiring_lru_cache.h"
 #include "tensorflow_io/core/filesystems/filesystem_plugins.h"
 
 namespace tensorflow {
@@ -80,6 +82,13 @@ void ParseURI(const absl::string_view& fname, absl::string_view* scheme,
 
 constexpr char kAzBlobEndpoint[] = ".blob.core.windows.net";
 
+// The environment variables that override the stat cache configuration. A max
+// age of 0 disables the cache.
+constexpr char kStatCacheMaxAge[] = "TF_AZURE_STAT_CACHE_MAX_AGE";
+constexpr uint64_t kStatCacheDefaultMaxAge = 5;
+constexpr char kStatCacheMaxEntries[] = "TF_AZURE_STAT_CACHE_MAX_ENTRIES";
+constexpr size_t kStatCacheDefaultMaxEntries = 1024;
+
 /// \brief Splits a Azure path to a account, container and object.
 ///
 /// For example,
@@ -334,10 +343,13 @@ class AzBlobRandomAccessFile {
 class AzBlobWritableFile {
  public:
   AzBlobWritableFile(const std::string& account, const std::string& container,
-                     const std::string& object)
+                     const std::string& object, const std::string& path,
+                     ExpiringLRUCache<TF_FileStatistics>* stat_cache)
       : account_(account),
         container_(container),
         object_(object),
+        path_(path),
+        stat_cache_(stat_cache),
         sync_needed_(true) {
     if (GetTmpFilename(&tmp_content_filename_)) {
       outfile_.open(tmp_content_filename_,
@@ -400,6 +412,7 @@ class AzBlobWritableFile {
       TF_SetStatus(status, TF_INTERNAL, error_message.c_str());
       return;
     }
+    stat_cache_->Delete(path_);
     sync_needed_ = false;
     TF_SetStatus(status, TF_OK, "");
   }
@@ -420,6 +433,8 @@ class AzBlobWritableFile {
   std::string account_;
   std::string container_;
   std::string object_;
+  std::string path_;
+  ExpiringLRUCache<TF_FileStatistics>* stat_cache_;
   std::string tmp_content_filename_;
   std::ofstream outfile_;
   bool sync_needed_;  // whether there is buffered data that needs to be synced
@@ -461,6 +476,24 @@ Status GetMatchingPaths(const std::string& pattern, std::vector<std::string>* re
 }
 #endif
 
+typedef struct AzFile {
+  // Caches `Stat` results, also populated from `GetChildren` listings.
+  std::unique_ptr<ExpiringLRUCache<TF_FileStatistics>> stat_cache;
+  AzFile() {
+    uint64_t value;
+    uint64_t stat_cache_max_age = kStatCacheDefaultMaxAge;
+    size_t stat_cache_max_entries = kStatCacheDefaultMaxEntries;
+    if (absl::SimpleAtoi(std::getenv(kStatCacheMaxAge), &value)) {
+      stat_cache_max_age = value;
+    }
+    if (absl::SimpleAtoi(std::getenv(kStatCacheMaxEntries), &value)) {
+      stat_cache_max_entries = static_cast<size_t>(value);
+    }
+    stat_cache = std::make_unique<ExpiringLRUCache<TF_FileStatistics>>(
+        stat_cache_max_age, stat_cache_max_entries);
+  }
+} AzFile;
+
 // SECTION 1. Implementation for `TF_RandomAccessFile`
 // ----------------------------------------------------------------------------
 namespace tf_random_access_file {
@@ -531,10 +564,14 @@ uint64_t Length(const TF_ReadOnlyMemoryRegion* region) { return 0; }
 namespace tf_az_filesystem {
 
 static void Init(TF_Filesystem* filesystem, TF_Status* status) {
+  filesystem->plugin_filesystem = new AzFile();
   TF_SetStatus(status, TF_OK, "");
 }
 
-static void Cleanup(TF_Filesystem* filesystem) {}
+static void Cleanup(TF_Filesystem* filesystem) {
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  delete az_file;
+}
 
 static void NewRandomAccessFile(const TF_Filesystem* filesystem,
                                 const char* path, TF_RandomAccessFile* file,
@@ -556,7 +593,9 @@ static void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
-  file->plugin_file = new AzBlobWritableFile(account, container, object);
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  file->plugin_file = new AzBlobWritableFile(account, container, object, path,
+                                             az_file->stat_cache.get());
 
   TF_SetStatus(status, TF_OK, "");
 }
@@ -568,7 +607,9 @@ static void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
-  file->plugin_file = new AzBlobWritableFile(account, container, object);
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  file->plugin_file = new AzBlobWritableFile(account, container, object, path,
+                                             az_file->stat_cache.get());
 
   TF_SetStatus(status, TF_OK, "");
 }
@@ -620,6 +661,8 @@ static void DeleteFile(const TF_Filesystem* filesystem, const char* path,
   auto blob_container_client = CreateAzBlobClientWrapper(account, container);
 
   auto blob_client = blob_container_client->GetBlobClient(object);
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  az_file->stat_cache->Delete(path);
 
   try {
     auto response = blob_client.Delete();
@@ -651,6 +694,8 @@ static void DeleteDir(const TF_Filesystem* filesystem, const char* path,
   }
 
   auto blob_container_client = CreateAzBlobClientWrapper(account, container);
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  az_file->stat_cache->DeletePrefix(path);
 
   // Check container exists
   // Just pull out the first path component representing the container
@@ -738,6 +783,9 @@ static void RenameFile(const TF_Filesystem* filesystem, const char* src,
   auto blob_container_client =
       CreateAzBlobClientWrapper(dst_account, dst_container);
   auto blob_client = blob_container_client->GetBlobClient(dst_object);
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  az_file->stat_cache->Delete(src);
+  az_file->stat_cache->Delete(dst);
 
   try {
     const std::string src_uri =
@@ -804,8 +852,9 @@ static void CopyFile(const TF_Filesystem* filesystem, const char* src,
   if (TF_GetCode(status) != TF_OK) {
     return;
   }
-  std::unique_ptr<AzBlobWritableFile> dst_file(
-      new AzBlobWritableFile(dst_account, dst_container, dst_object));
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  std::unique_ptr<AzBlobWritableFile> dst_file(new AzBlobWritableFile(
+      dst_account, dst_container, dst_object, dst, az_file->stat_cache.get()));
 
   uint64_t offset = 0;
   std::unique_ptr<char[]> buffer(new char[kCopyFileBufferSize]);
@@ -834,6 +883,13 @@ static void PathExists(const TF_Filesystem* filesystem, const char* path,
     return;
   }
 
+  TF_FileStatistics stats;
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  if (az_file->stat_cache->Lookup(path, &stats)) {
+    TF_SetStatus(status, TF_OK, "");
+    return;
+  }
+
   auto blob_container_client = CreateAzBlobClientWrapper(account, container);
   auto blob_client = blob_container_client->GetBlobClient(object);
 
@@ -881,6 +937,19 @@ static bool IsDirectory(const TF_Filesystem* filesystem, const char* path,
     //                                      account, " was not found.");
   }
 
+  TF_FileStatistics stats;
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  if (az_file->stat_cache->Lookup(path, &stats)) {
+    if (!stats.is_directory) {
+      const std::string error_message =
+          absl::StrCat("The specified folder ", path, " is not a directory");
+      TF_SetStatus(status, TF_FAILED_PRECONDITION, error_message.c_str());
+      return false;
+    }
+    TF_SetStatus(status, TF_OK, "");
+    return true;
+  }
+
   auto blob_container_client = CreateAzBlobClientWrapper(account, container);
 
   try {
@@ -926,18 +995,13 @@ static bool IsDirectory(const TF_Filesystem* filesystem, const char* path,
   return true;
 }
 
-static void Stat(const TF_Filesystem* filesystem, const char* path,
-                 TF_FileStatistics* stats, TF_Status* status) {
-  TF_VLog(1, "Stat on path: %s\n", path);
-
+static void StatUncached(const TF_Filesystem* filesystem, const char* path,
+                         const std::string& account,
+                         const std::string& container,
+                         const std::string& object, TF_FileStatistics* stats,
+                         TF_Status* status) {
   using namespace std::chrono;
 
-  std::string account, container, object;
-  ParseAzBlobPath(path, false, &account, &container, &object, status);
-  if (TF_GetCode(status) != TF_OK) {
-    return;
-  }
-
   auto blob_container_client = CreateAzBlobClientWrapper(account, container);
 
   if (IsDirectory(filesystem, path, status)) {
@@ -970,6 +1034,27 @@ static void Stat(const TF_Filesystem* filesystem, const char* path,
   TF_SetStatus(status, TF_OK, "");
 }
 
+static void Stat(const TF_Filesystem* filesystem, const char* path,
+                 TF_FileStatistics* stats, TF_Status* status) {
+  TF_VLog(1, "Stat on path: %s\n", path);
+
+  std::string account, container, object;
+  ParseAzBlobPath(path, false, &account, &container, &object, status);
+  if (TF_GetCode(status) != TF_OK) {
+    return;
+  }
+
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  if (az_file->stat_cache->Lookup(path, stats)) {
+    TF_SetStatus(status, TF_OK, "");
+    return;
+  }
+  StatUncached(filesystem, path, account, container, object, stats, status);
+  if (TF_GetCode(status) == TF_OK) {
+    az_file->stat_cache->Insert(path, *stats);
+  }
+}
+
 static int GetChildren(const TF_Filesystem* filesystem, const char* path,
                        char*** entries, TF_Status* status) {
   TF_VLog(1, "GetChildren on path: %s\n", path);
@@ -996,32 +1081,55 @@ static int GetChildren(const TF_Filesystem* filesystem, const char* path,
   Azure::Storage::Blobs::ListBlobsOptions options;
   options.Prefix = object;
 
+  // Stats of the listed children, used to warm the stat cache.
+  std::string parent = path;
+  if (parent.back() != '/') {
+    parent += "/";
+  }
+  std::vector<std::pair<std::string, TF_FileStatistics>> files, dirs;
+
   for (auto response =
            blob_container_client->ListBlobsByHierarchy("/", options);
        response.HasPage(); response.MoveToNextPage()) {
-    std::transform(response.Blobs.begin(), response.Blobs.end(),
-                   std::back_inserter(result),
-                   [&object](auto const& list_blob_item) -> std::string {
-                     // Remove the prefix from the name
-                     auto blob_name = list_blob_item.Name;
-                     blob_name.erase(0, object.size());
-                     // Remove the trailing slash from folders
-                     if (blob_name.back() == '/') {
-                       blob_name.pop_back();
-                     }
-                     return blob_name;
-                   });
-    std::transform(response.BlobPrefixes.begin(), response.BlobPrefixes.end(),
-                   std::back_inserter(result),
-                   [&object](std::string blob_prefix) -> std::string {
-                     // Remove the prefix from the name
-                     blob_prefix.erase(0, object.size());
-                     // Remove the trailing slash from folders
-                     if (blob_prefix.back() == '/') {
-                       blob_prefix.pop_back();
-                     }
-                     return blob_prefix;
-                   });
+    for (auto const& list_blob_item : response.Blobs) {
+      // Remove the prefix from the name
+      auto blob_name = list_blob_item.Name;
+      blob_name.erase(0, object.size());
+      // Remove the trailing slash from folders
+      if (blob_name.back() == '/') {
+        blob_name.pop_back();
+      }
+      auto az_last_modified =
+          list_blob_item.Details.LastModified.time_since_epoch();
+      TF_FileStatistics stats;
+      stats.length = list_blob_item.BlobSize;
+      stats.mtime_nsec =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(az_last_modified)
+              .count();
+      stats.is_directory = false;
+      files.push_back({parent + blob_name, stats});
+      result.push_back(std::move(blob_name));
+    }
+    for (std::string blob_prefix : response.BlobPrefixes) {
+      // Remove the prefix from the name
+      blob_prefix.erase(0, object.size());
+      // Remove the trailing slash from folders
+      if (blob_prefix.back() == '/') {
+        blob_prefix.pop_back();
+      }
+      dirs.push_back({parent + blob_prefix, {0, 0, true}});
+      result.push_back(std::move(blob_prefix));
+    }
+  }
+
+  // As in `Stat`, a blob shadows a virtual folder of the same name, so files
+  // are inserted last.
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  for (const auto& dir : dirs) {
+    az_file->stat_cache->Insert(dir.first, dir.second);
+  }
+  for (const auto& file : files) {
+    az_file->stat_cache->Insert(file.first, file.second);
   }
 
   int num_entries = result.size();
@@ -1045,6 +1153,13 @@ static int64_t GetFileSize(const TF_Filesystem* filesystem, const char* path,
     return 0;
   }
 
+  TF_FileStatistics stats;
+  auto az_file = static_cast<AzFile*>(filesystem->plugin_filesystem);
+  if (az_file->stat_cache->Lookup(path, &stats) && !stats.is_directory) {
+    TF_SetStatus(status, TF_OK, "");
+    return stats.length;
+  }
+
   auto blob_container_client = CreateAzBlobClientWrapper(account, container);
   auto blob_client = blob_container_client->GetBlobClient(object);
   try {
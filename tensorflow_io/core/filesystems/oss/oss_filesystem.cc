@@ -19,6 +19,10 @@ limitations under the License.
 #include <ctime>
 #include <fstream>
 #include <iostream>
+#include <list>
+#include <map>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include "aos_string.h"
@@ -26,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/file_system_helper.h"
@@ -47,6 +52,15 @@ constexpr char kOSSAccessIdKey[] = "id";
 constexpr char kOSSAccessKeyKey[] = "key";
 constexpr char kOSSHostKey[] = "host";
 constexpr char kDelim[] = "/";
+// The environment variables that override the block size and the size (both
+// in MB) of the block cache shared by random access files. A cache size of 0
+// disables the cache.
+constexpr char kOSSBlockSize[] = "OSS_BLOCK_SIZE_MB";
+constexpr char kOSSMaxCacheSize[] = "OSS_MAX_CACHE_SIZE_MB";
+// The environment variables that override the size (in MB) of each range
+// request, and the number of range requests in flight for one read.
+constexpr char kOSSReadPartSize[] = "OSS_READ_PART_SIZE_MB";
+constexpr char kOSSReadParallelism[] = "OSS_READ_PARALLELISM";
 static char oss_user_agent[256] = "";
 
 void oss_initialize_with_throwable() {
@@ -123,19 +137,157 @@ class OSSConnection {
   oss_request_options_t* _options = NULL;
 };
 
+// Downloads bytes [offset, offset + n) of an object straight into buffer.
+Status OSSGetObjectRange(const std::string& host, const std::string& access_id,
+                         const std::string& access_key,
+                         const std::string& bucket, const std::string& object,
+                         uint64 offset, size_t n, char* buffer) {
+  if (n == 0) {
+    return OkStatus();
+  }
+  OSSConnection conn(host, access_id, access_key);
+  aos_pool_t* _pool = conn.getPool();
+  oss_request_options_t* _options = conn.getRequestOptions();
+  aos_string_t bucket_;
+  aos_string_t object_;
+  aos_table_t* headers_;
+  aos_list_t tmp_buffer;
+  aos_table_t* resp_headers;
+
+  aos_list_init(&tmp_buffer);
+  aos_str_set(&bucket_, bucket.c_str());
+  aos_str_set(&object_, object.c_str());
+  headers_ = aos_table_make(_pool, 1);
+
+  std::string range("bytes=");
+  range.append(std::to_string(offset))
+      .append("-")
+      .append(std::to_string(offset + n - 1));
+  apr_table_set(headers_, "Range", range.c_str());
+  VLOG(1) << "read from OSS with " << range.c_str();
+
+  aos_status_t* s = oss_get_object_to_buffer(
+      _options, &bucket_, &object_, headers_, NULL, &tmp_buffer, &resp_headers);
+  if (!aos_status_is_ok(s)) {
+    string msg;
+    oss_error_message(s, &msg);
+    VLOG(0) << "read " << object << " failed, errMsg: " << msg;
+    return errors::Internal("read failed: ", object, " errMsg: ", msg);
+  }
+
+  aos_buf_t* content = NULL;
+  size_t pos = 0;
+  aos_list_for_each_entry(aos_buf_t, content, &tmp_buffer, node) {
+    size_t size = aos_buf_size(content);
+    if (pos + size > n) {
+      return errors::Internal("read failed: ", object, " received more than ",
+                              n, " bytes at ", offset);
+    }
+    memcpy(buffer + pos, content->pos, size);
+    pos += size;
+  }
+  if (pos != n) {
+    return errors::Internal("read failed: ", object, " received ", pos,
+                            " bytes out of ", n, " at ", offset);
+  }
+  return OkStatus();
+}
+
+// Bounded LRU cache of object blocks, shared by all random access files of
+// a filesystem so that re-reads of the same objects (e.g. multiple epochs,
+// or several readers of one file) do not go back to OSS.
+class OSSBlockCache {
+ public:
+  OSSBlockCache(size_t block_size, size_t max_bytes)
+      : block_size_(block_size), max_bytes_(max_bytes) {}
+
+  size_t block_size() const { return block_size_; }
+
+  bool IsCacheEnabled() const { return block_size_ > 0 && max_bytes_ > 0; }
+
+  std::shared_ptr<const std::string> Lookup(const std::string& key,
+                                            uint64 index) {
+    mutex_lock lock(mu_);
+    auto entry = blocks_.find(std::make_pair(key, index));
+    if (entry == blocks_.end()) {
+      return nullptr;
+    }
+    lru_.splice(lru_.begin(), lru_, entry->second.second);
+    return entry->second.first;
+  }
+
+  void Insert(const std::string& key, uint64 index,
+              std::shared_ptr<const std::string> block) {
+    mutex_lock lock(mu_);
+    const auto block_key = std::make_pair(key, index);
+    auto entry = blocks_.find(block_key);
+    if (entry != blocks_.end()) {
+      size_ -= entry->second.first->size();
+      lru_.erase(entry->second.second);
+      blocks_.erase(entry);
+    }
+    while (!lru_.empty() && size_ + block->size() > max_bytes_) {
+      auto evict = blocks_.find(lru_.back());
+      size_ -= evict->second.first->size();
+      blocks_.erase(evict);
+      lru_.pop_back();
+    }
+    size_ += block->size();
+    lru_.push_front(block_key);
+    blocks_[block_key] = std::make_pair(std::move(block), lru_.begin());
+  }
+
+  // Marks a block as being fetched in the background, returns false if it
+  // is already cached or being fetched.
+  bool StartFetch(const std::string& key, uint64 index) {
+    mutex_lock lock(mu_);
+    const auto block_key = std::make_pair(key, index);
+    if (blocks_.find(block_key) != blocks_.end()) {
+      return false;
+    }
+    return fetching_.insert(block_key).second;
+  }
+
+  void EndFetch(const std::string& key, uint64 index) {
+    mutex_lock lock(mu_);
+    fetching_.erase(std::make_pair(key, index));
+  }
+
+ private:
+  typedef std::pair<std::string, uint64> BlockKey;
+
+  const size_t block_size_;
+  const size_t max_bytes_;
+  mutex mu_;
+  size_t size_ TF_GUARDED_BY(mu_) = 0;
+  std::list<BlockKey> lru_ TF_GUARDED_BY(mu_);
+  std::map<BlockKey, std::pair<std::shared_ptr<const std::string>,
+                               std::list<BlockKey>::iterator>>
+      blocks_ TF_GUARDED_BY(mu_);
+  std::set<BlockKey> fetching_ TF_GUARDED_BY(mu_);
+};
+
 class OSSRandomAccessFile : public RandomAccessFile {
  public:
   OSSRandomAccessFile(const std::string& endPoint, const std::string& accessKey,
                       const std::string& accessKeySecret,
                       const std::string& bucket, const std::string& object,
-                      size_t read_ahead_bytes, size_t file_length)
+                      size_t read_ahead_bytes, size_t file_length,
+                      std::shared_ptr<OSSBlockCache> block_cache,
+                      size_t part_bytes, size_t max_parallel_parts)
       : shost(endPoint),
         sak(accessKey),
         ssk(accessKeySecret),
         sbucket(bucket),
         sobject(object),
-        total_file_length_(file_length) {
+        total_file_length_(file_length),
+        block_cache_(std::move(block_cache)),
+        part_bytes_(std::max<size_t>(part_bytes, 1)),
+        max_parallel_parts_(std::max<size_t>(max_parallel_parts, 1)),
+        prefetching_(std::make_shared<std::atomic<bool>>(false)) {
     read_ahead_bytes_ = std::min(read_ahead_bytes, file_length);
+    cache_key_ = strings::StrCat(shost, "/", sbucket, "/", sobject, "#",
+                                 total_file_length_);
   }
 
   Status Read(uint64 offset, size_t n, StringPiece* result,
@@ -148,116 +300,177 @@ class OSSRandomAccessFile : public RandomAccessFile {
                                 total_file_length_);
     }
 
+    const size_t requested = n;
     if (offset + n > total_file_length_) {
       n = total_file_length_ - offset;
     }
 
     VLOG(1) << "read " << sobject << " from " << offset << " to " << offset + n;
 
-    mutex_lock lock(mu_);
-    const bool range_start_included = offset >= buffer_start_offset_;
-    const bool range_end_included =
-        offset + n <= buffer_start_offset_ + buffer_size_;
-    if (range_start_included && range_end_included) {
-      // The requested range can be filled from the buffer.
-      const size_t offset_in_buffer =
-          std::min<uint64>(offset - buffer_start_offset_, buffer_size_);
-      const auto copy_size = std::min(n, buffer_size_ - offset_in_buffer);
-      VLOG(1) << "read from buffer " << offset_in_buffer << " to "
-              << offset_in_buffer + copy_size << " total " << buffer_size_;
-      std::copy(buffer_.begin() + offset_in_buffer,
-                buffer_.begin() + offset_in_buffer + copy_size, scratch);
-      *result = StringPiece(scratch, copy_size);
-    } else {
-      // Update the buffer content based on the new requested range.
-      const size_t desired_buffer_size =
-          std::min(n + read_ahead_bytes_, total_file_length_);
-      if (n > buffer_.capacity() ||
-          desired_buffer_size > 2 * buffer_.capacity()) {
-        // Re-allocate only if buffer capacity increased significantly.
-        VLOG(1) << "reserve buffer to " << desired_buffer_size;
-        buffer_.reserve(desired_buffer_size);
-      }
+    // Nothing to fetch, and ReadBlocks cannot compute a last block for an
+    // empty range.
+    if (n == 0) {
+      *result = StringPiece(scratch, 0);
+      return OkStatus();
+    }
 
-      buffer_start_offset_ = offset;
-      VLOG(1) << "load buffer" << buffer_start_offset_;
-      TF_RETURN_IF_ERROR(LoadBufferFromOSS(desired_buffer_size));
+    bool sequential = false;
+    {
+      mutex_lock lock(mu_);
+      sequential = (offset == next_offset_);
+      next_offset_ = offset + n;
+    }
+
+    if (!block_cache_->IsCacheEnabled() ||
+        n >= 4 * block_cache_->block_size()) {
+      // Large reads go straight into the destination buffer, split into
+      // concurrent sub-range requests.
+      TF_RETURN_IF_ERROR(ReadParts(offset, n, scratch));
+    } else {
+      TF_RETURN_IF_ERROR(ReadBlocks(offset, n, scratch));
+    }
+    *result = StringPiece(scratch, n);
 
-      // Set the results.
-      memcpy(scratch, buffer_.data(), std::min(buffer_size_, n));
-      *result = StringPiece(scratch, std::min(buffer_size_, n));
+    if (sequential) {
+      Prefetch(offset + n);
     }
 
-    if (result->size() < n) {
+    if (result->size() < requested) {
       // This is not an error per se. The RandomAccessFile interface expects
       // that Read returns OutOfRange if fewer bytes were read than requested.
       return errors::OutOfRange("EOF reached, ", result->size(),
-                                " bytes were read out of ", n,
+                                " bytes were read out of ", requested,
                                 " bytes requested.");
     }
     return OkStatus();
   }
 
  private:
-  /// A helper function to actually read the data from OSS. This function loads
-  /// buffer_ from OSS based on its current capacity.
-  Status LoadBufferFromOSS(size_t desired_buffer_size) const
-      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
-    size_t range_start = buffer_start_offset_;
-    size_t range_end = buffer_start_offset_ + std::min(buffer_.capacity() - 1,
-                                                       desired_buffer_size - 1);
-    range_end = std::min(range_end, total_file_length_ - 1);
-
-    OSSConnection conn(shost, sak, ssk);
-    aos_pool_t* _pool = conn.getPool();
-    oss_request_options_t* _options = conn.getRequestOptions();
-    aos_string_t bucket_;
-    aos_string_t object_;
-    aos_table_t* headers_;
-    aos_list_t tmp_buffer;
-    aos_table_t* resp_headers;
-
-    aos_list_init(&tmp_buffer);
-    aos_str_set(&_options->config->endpoint, shost.c_str());
-    aos_str_set(&_options->config->access_key_id, sak.c_str());
-    aos_str_set(&_options->config->access_key_secret, ssk.c_str());
-    _options->config->is_cname = 0;
-    _options->ctl = aos_http_controller_create(_options->pool, 0);
-    aos_str_set(&bucket_, sbucket.c_str());
-    aos_str_set(&object_, sobject.c_str());
-    headers_ = aos_table_make(_pool, 1);
-
-    std::string range("bytes=");
-    range.append(std::to_string(range_start))
-        .append("-")
-        .append(std::to_string(range_end));
-    apr_table_set(headers_, "Range", range.c_str());
-    VLOG(1) << "read from OSS with " << range.c_str();
-
-    aos_status_t* s =
-        oss_get_object_to_buffer(_options, &bucket_, &object_, headers_, NULL,
-                                 &tmp_buffer, &resp_headers);
-    if (aos_status_is_ok(s)) {
-      aos_buf_t* content = NULL;
-      int64_t size = 0;
-      int64_t pos = 0;
-      buffer_.clear();
-      buffer_size_ = 0;
-
-      // copy data to local buffer
-      aos_list_for_each_entry(aos_buf_t, content, &tmp_buffer, node) {
-        size = aos_buf_size(content);
-        std::copy(content->pos, content->pos + size, buffer_.begin() + pos);
-        pos += size;
+  // Downloads [offset, offset + n) into buffer with up to
+  // max_parallel_parts_ concurrent range requests of part_bytes_ each.
+  Status ReadParts(uint64 offset, size_t n, char* buffer) const {
+    const size_t parts = (n + part_bytes_ - 1) / part_bytes_;
+    if (parts <= 1) {
+      return OSSGetObjectRange(shost, sak, ssk, sbucket, sobject, offset, n,
+                               buffer);
+    }
+    std::vector<Status> status(parts);
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+      for (size_t i = next++; i < parts; i = next++) {
+        const size_t part_offset = i * part_bytes_;
+        const size_t part_size = std::min(part_bytes_, n - part_offset);
+        status[i] =
+            OSSGetObjectRange(shost, sak, ssk, sbucket, sobject,
+                              offset + part_offset, part_size,
+                              buffer + part_offset);
       }
-      buffer_size_ = pos;
-      return OkStatus();
-    } else {
-      string msg;
-      oss_error_message(s, &msg);
-      VLOG(0) << "read " << sobject << " failed, errMsg: " << msg;
-      return errors::Internal("read failed: ", sobject, " errMsg: ", msg);
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(parts, max_parallel_parts_); i++) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+      thread.join();
     }
+    for (const auto& s : status) {
+      TF_RETURN_IF_ERROR(s);
+    }
+    return OkStatus();
+  }
+
+  // Serves [offset, offset + n) from the shared block cache. Runs of
+  // missing blocks are downloaded with ReadParts and added to the cache.
+  Status ReadBlocks(uint64 offset, size_t n, char* buffer) const {
+    const size_t block_size = block_cache_->block_size();
+    const uint64 first = offset / block_size;
+    const uint64 last = (offset + n - 1) / block_size;
+    std::vector<std::shared_ptr<const std::string>> blocks(last - first + 1);
+    for (uint64 index = first; index <= last; index++) {
+      blocks[index - first] = block_cache_->Lookup(cache_key_, index);
+    }
+    for (uint64 index = first; index <= last; index++) {
+      if (blocks[index - first] != nullptr) {
+        continue;
+      }
+      uint64 run = index;
+      while (run < last && blocks[run + 1 - first] == nullptr) {
+        run++;
+      }
+      const uint64 run_offset = index * block_size;
+      const size_t run_size =
+          std::min<uint64>((run + 1) * block_size, total_file_length_) -
+          run_offset;
+      std::string data;
+      data.resize(run_size);
+      TF_RETURN_IF_ERROR(ReadParts(run_offset, run_size, &data[0]));
+      for (uint64 i = index; i <= run; i++) {
+        const size_t begin = (i - index) * block_size;
+        auto block = std::make_shared<const std::string>(
+            data, begin, std::min(block_size, run_size - begin));
+        block_cache_->Insert(cache_key_, i, block);
+        blocks[i - first] = std::move(block);
+      }
+      index = run;
+    }
+    for (uint64 index = first; index <= last; index++) {
+      const std::string& block = *blocks[index - first];
+      const uint64 block_offset = index * block_size;
+      const uint64 begin = std::max<uint64>(offset, block_offset);
+      const uint64 end = std::min<uint64>(offset + n,
+                                          block_offset + block.size());
+      memcpy(buffer + (begin - offset), block.data() + (begin - block_offset),
+             end - begin);
+    }
+    return OkStatus();
+  }
+
+  // Fetches the read-ahead window that follows a sequential read into the
+  // block cache in the background, so that the next read of a sequential
+  // scan is served while the current one is being consumed. Only one window
+  // per file is in flight at a time.
+  void Prefetch(uint64 offset) const {
+    if (!block_cache_->IsCacheEnabled() || read_ahead_bytes_ == 0 ||
+        offset >= total_file_length_ || prefetching_->exchange(true)) {
+      return;
+    }
+    const size_t block_size = block_cache_->block_size();
+    const uint64 first = offset / block_size;
+    const uint64 last =
+        (std::min<uint64>(offset + read_ahead_bytes_, total_file_length_) -
+         1) /
+        block_size;
+    std::thread([shost = shost, sak = sak, ssk = ssk, sbucket = sbucket,
+                 sobject = sobject, cache_key = cache_key_,
+                 total_file_length = total_file_length_,
+                 block_cache = block_cache_, prefetching = prefetching_, first,
+                 last, block_size]() {
+      for (uint64 index = first; index <= last; index++) {
+        if (!block_cache->StartFetch(cache_key, index)) {
+          continue;
+        }
+        const uint64 block_offset = index * block_size;
+        const size_t size =
+            std::min<uint64>(block_offset + block_size, total_file_length) -
+            block_offset;
+        std::string data;
+        data.resize(size);
+        Status status = OSSGetObjectRange(shost, sak, ssk, sbucket, sobject,
+                                          block_offset, size, &data[0]);
+        if (status.ok()) {
+          block_cache->Insert(cache_key, index,
+                              std::make_shared<const std::string>(
+                                  std::move(data)));
+        }
+        block_cache->EndFetch(cache_key, index);
+        if (!status.ok()) {
+          VLOG(1) << "prefetch " << sobject << " failed: " << status;
+          break;
+        }
+      }
+      prefetching->store(false);
+    }).detach();
   }
 
   std::string shost;
@@ -267,12 +480,15 @@ class OSSRandomAccessFile : public RandomAccessFile {
   std::string sobject;
   const size_t total_file_length_;
   size_t read_ahead_bytes_;
+  std::string cache_key_;
+  std::shared_ptr<OSSBlockCache> block_cache_;
+  const size_t part_bytes_;
+  const size_t max_parallel_parts_;
+  std::shared_ptr<std::atomic<bool>> prefetching_;
 
   mutable mutex mu_;
-  mutable std::vector<char> buffer_ TF_GUARDED_BY(mu_);
-  // The original file offset of the first byte in the buffer.
-  mutable size_t buffer_start_offset_ TF_GUARDED_BY(mu_) = 0;
-  mutable size_t buffer_size_ TF_GUARDED_BY(mu_) = 0;
+  // The offset following the last read, used to detect sequential scans.
+  mutable uint64 next_offset_ TF_GUARDED_BY(mu_) = 0;
 };
 
 class OSSReadOnlyMemoryRegion : public ReadOnlyMemoryRegion {
@@ -496,7 +712,27 @@ class OSSWritableFile : public WritableFile {
   int64_t part_number_;
 };
 
-OSSFileSystem::OSSFileSystem() {}
+OSSFileSystem::OSSFileSystem() {
+  size_t block_size = 4 * 1024 * 1024;
+  size_t max_cache_size = 256 * 1024 * 1024;
+  const char* env = std::getenv(kOSSBlockSize);
+  if (env != nullptr) {
+    block_size = std::strtoull(env, nullptr, 10) * 1024 * 1024;
+  }
+  env = std::getenv(kOSSMaxCacheSize);
+  if (env != nullptr) {
+    max_cache_size = std::strtoull(env, nullptr, 10) * 1024 * 1024;
+  }
+  env = std::getenv(kOSSReadPartSize);
+  if (env != nullptr) {
+    read_part_bytes_ = std::strtoull(env, nullptr, 10) * 1024 * 1024;
+  }
+  env = std::getenv(kOSSReadParallelism);
+  if (env != nullptr) {
+    read_parallelism_ = std::strtoull(env, nullptr, 10);
+  }
+  block_cache_ = std::make_shared<OSSBlockCache>(block_size, max_cache_size);
+}
 
 // Splits a oss path to endpoint bucket object and token
 // For example
@@ -578,9 +814,9 @@ Status OSSFileSystem::NewRandomAccessFile(
   OSSConnection conn(host, access_id, access_key);
   TF_RETURN_IF_ERROR(_RetrieveObjectMetadata(
       conn.getPool(), conn.getRequestOptions(), bucket, object, &stat));
-  result->reset(new OSSRandomAccessFile(host, access_id, access_key, bucket,
-                                        object, read_ahead_bytes_,
-                                        stat.length));
+  result->reset(new OSSRandomAccessFile(
+      host, access_id, access_key, bucket, object, read_ahead_bytes_,
+      stat.length, block_cache_, read_part_bytes_, read_parallelism_));
   return OkStatus();
 }
 
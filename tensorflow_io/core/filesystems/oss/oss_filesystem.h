@@ -14,6 +14,7 @@ limitations under the License.
 #define TENSORFLOW_IO_CORE_FILESYSTEMS_OSS_OSS_FILESYSTEM_H_
 
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -34,6 +35,8 @@ namespace tensorflow {
 namespace io {
 namespace oss {
 
+class OSSBlockCache;
+
 /// Aliyun oss implementation of a file system.
 class OSSFileSystem {
  public:
@@ -117,6 +120,16 @@ class OSSFileSystem {
   //  in the RandomAccessFile implementation. Defaults to 5Mb.
   const size_t read_ahead_bytes_ = 5 * 1024 * 1024;
 
+  // The number of bytes for each concurrent range request of a read.
+  // Defaults to 8MB.
+  size_t read_part_bytes_ = 8 * 1024 * 1024;
+
+  // The max number of concurrent range requests of a read.
+  size_t read_parallelism_ = 8;
+
+  // Block cache shared by all random access files of this filesystem.
+  std::shared_ptr<OSSBlockCache> block_cache_;
+
   // The number of bytes for each upload part. Defaults to 64MB
   const size_t upload_part_bytes_ = 64 * 1024 * 1024;
 
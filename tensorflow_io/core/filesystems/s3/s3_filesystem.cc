@@ -61,6 +61,13 @@ constexpr size_t kUploadRetries = 3;
 
 constexpr size_t kS3ReadAppendableFileBufferSize = 1024 * 1024;  // 1 MB
 
+// The environment variables that override the stat cache configuration. A max
+// age of 0 disables the cache.
+constexpr char kStatCacheMaxAge[] = "S3_STAT_CACHE_MAX_AGE";
+constexpr uint64_t kStatCacheDefaultMaxAge = 5;
+constexpr char kStatCacheMaxEntries[] = "S3_STAT_CACHE_MAX_ENTRIES";
+constexpr size_t kStatCacheDefaultMaxEntries = 1024;
+
 static inline void TF_SetStatusFromAWSError(
     const Aws::Client::AWSError<Aws::S3::S3Errors>& error, TF_Status* status) {
   auto http_code = error.GetResponseCode();
@@ -374,13 +381,16 @@ typedef struct S3File {
   std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager;
   bool sync_needed;
   std::shared_ptr<Aws::Utils::TempFile> outfile;
+  ExpiringLRUCache<TF_FileStatistics>* stat_cache;
   S3File(Aws::String bucket, Aws::String object,
          std::shared_ptr<Aws::S3::S3Client> s3_client,
-         std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager)
+         std::shared_ptr<Aws::Transfer::TransferManager> transfer_manager,
+         ExpiringLRUCache<TF_FileStatistics>* stat_cache)
       : bucket(bucket),
         object(object),
         s3_client(s3_client),
         transfer_manager(transfer_manager),
+        stat_cache(stat_cache),
         outfile(Aws::MakeShared<Aws::Utils::TempFile>(
             kS3FileSystemAllocationTag,
 #if defined(_MSC_VER)
@@ -466,6 +476,8 @@ void Sync(const TF_WritableFile* file, TF_Status* status) {
   s3_file->outfile->clear();
   s3_file->outfile->seekp(position);
   s3_file->sync_needed = false;
+  Aws::String path = "s3://" + s3_file->bucket + "/" + s3_file->object;
+  s3_file->stat_cache->Delete(path.c_str());
   TF_SetStatus(status, TF_OK, "");
 }
 
@@ -519,7 +531,32 @@ S3File::S3File()
       transfer_managers(),
       multi_part_chunk_sizes(),
       use_multi_part_download(true),
-      initialization_lock() {}
+      initialization_lock() {
+  uint64_t value;
+  uint64_t stat_cache_max_age = kStatCacheDefaultMaxAge;
+  size_t stat_cache_max_entries = kStatCacheDefaultMaxEntries;
+  if (absl::SimpleAtoi(getenv(kStatCacheMaxAge), &value)) {
+    stat_cache_max_age = value;
+  }
+  if (absl::SimpleAtoi(getenv(kStatCacheMaxEntries), &value)) {
+    stat_cache_max_entries = static_cast<size_t>(value);
+  }
+  stat_cache = std::make_unique<ExpiringLRUCache<TF_FileStatistics>>(
+      stat_cache_max_age, stat_cache_max_entries);
+}
+
+// Drops the cached stats of `path`, with and without a trailing slash.
+static void InvalidateStat(S3File* s3_file, const char* path) {
+  std::string key = path;
+  s3_file->stat_cache->Delete(key);
+  if (!key.empty() && key.back() == '/') {
+    key.pop_back();
+  } else {
+    key.push_back('/');
+  }
+  s3_file->stat_cache->Delete(key);
+}
+
 void Init(TF_Filesystem* filesystem, TF_Status* status) {
   filesystem->plugin_filesystem = new S3File();
   TF_SetStatus(status, TF_OK, "");
@@ -557,7 +594,8 @@ void NewWritableFile(const TF_Filesystem* filesystem, const char* path,
   GetTransferManager(Aws::Transfer::TransferDirection::UPLOAD, s3_file);
   file->plugin_file = new tf_writable_file::S3File(
       bucket, object, s3_file->s3_client,
-      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD]);
+      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD],
+      s3_file->stat_cache.get());
   TF_SetStatus(status, TF_OK, "");
 }
 
@@ -583,7 +621,8 @@ void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
       });
   writer->plugin_file = new tf_writable_file::S3File(
       bucket, object, s3_file->s3_client,
-      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD]);
+      s3_file->transfer_managers[Aws::Transfer::TransferDirection::UPLOAD],
+      s3_file->stat_cache.get());
   TF_SetStatus(status, TF_OK, "");
 
   // Wraping inside a `std::unique_ptr` to prevent memory-leaking.
@@ -626,15 +665,9 @@ void NewAppendableFile(const TF_Filesystem* filesystem, const char* path,
   TF_SetStatus(status, TF_OK, "");
 }
 
-void Stat(const TF_Filesystem* filesystem, const char* path,
-          TF_FileStatistics* stats, TF_Status* status) {
-  TF_VLog(1, "Stat on path: %s\n", path);
-  Aws::String bucket, object;
-  ParseS3Path(path, true, &bucket, &object, status);
-  if (TF_GetCode(status) != TF_OK) return;
-  auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
-  GetS3Client(s3_file);
-
+static void StatUncached(S3File* s3_file, const char* path,
+                         const Aws::String& bucket, const Aws::String& object,
+                         TF_FileStatistics* stats, TF_Status* status) {
   if (object.empty()) {
     Aws::S3::Model::HeadBucketRequest head_bucket_request;
     head_bucket_request.WithBucket(bucket);
@@ -695,6 +728,24 @@ void Stat(const TF_Filesystem* filesystem, const char* path,
   TF_SetStatus(status, TF_OK, "");
 }
 
+void Stat(const TF_Filesystem* filesystem, const char* path,
+          TF_FileStatistics* stats, TF_Status* status) {
+  TF_VLog(1, "Stat on path: %s\n", path);
+  Aws::String bucket, object;
+  ParseS3Path(path, true, &bucket, &object, status);
+  if (TF_GetCode(status) != TF_OK) return;
+  auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
+  if (s3_file->stat_cache->Lookup(path, stats)) {
+    return TF_SetStatus(status, TF_OK, "");
+  }
+  GetS3Client(s3_file);
+
+  // The request is issued without holding the cache lock so that stats of
+  // different objects can be resolved concurrently.
+  StatUncached(s3_file, path, bucket, object, stats, status);
+  if (TF_GetCode(status) == TF_OK) s3_file->stat_cache->Insert(path, *stats);
+}
+
 void PathExists(const TF_Filesystem* filesystem, const char* path,
                 TF_Status* status) {
   TF_FileStatistics stats;
@@ -968,6 +1019,7 @@ void CopyFile(const TF_Filesystem* filesystem, const char* src, const char* dst,
   if (TF_GetCode(status) != TF_OK) return;
 
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
+  InvalidateStat(s3_file, dst);
   GetTransferManager(Aws::Transfer::TransferDirection::UPLOAD, s3_file);
   auto chunk_size =
       s3_file->multi_part_chunk_sizes[Aws::Transfer::TransferDirection::UPLOAD];
@@ -998,6 +1050,7 @@ void DeleteFile(const TF_Filesystem* filesystem, const char* path,
   if (TF_GetCode(status) != TF_OK) return;
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
   GetS3Client(s3_file);
+  InvalidateStat(s3_file, path);
 
   Aws::S3::Model::DeleteObjectRequest delete_object_request;
   delete_object_request.WithBucket(bucket).WithKey(object);
@@ -1033,6 +1086,7 @@ void CreateDir(const TF_Filesystem* filesystem, const char* path,
   Aws::String dir_path = path;
   if (dir_path.back() != '/') dir_path.push_back('/');
 
+  InvalidateStat(s3_file, path);
   PathExists(filesystem, dir_path.c_str(), status);
   if (TF_GetCode(status) == TF_OK) {
     std::unique_ptr<TF_WritableFile, void (*)(TF_WritableFile * file)> file(
@@ -1105,6 +1159,9 @@ void RenameFile(const TF_Filesystem* filesystem, const char* src,
 
   auto s3_file = static_cast<S3File*>(filesystem->plugin_filesystem);
   GetS3Client(s3_file);
+  // A rename moves every object under `src`, so drop all of their stats.
+  s3_file->stat_cache->DeletePrefix(src);
+  s3_file->stat_cache->DeletePrefix(dst);
 
   if (object_src.back() == '/') {
     if (object_dst.back() != '/') {
@@ -1174,6 +1231,9 @@ int GetChildren(const TF_Filesystem* filesystem, const char* path,
 
   Aws::S3::Model::ListObjectsV2Result list_objects_result;
   std::vector<Aws::String> result;
+  // Stats of the listed children, used to warm the stat cache.
+  std::string parent = absl::StrCat("s3://", bucket.c_str(), "/");
+  std::vector<std::pair<std::string, TF_FileStatistics>> files, dirs;
   do {
     auto list_objects_outcome =
         s3_file->s3_client->ListObjectsV2(list_objects_request);
@@ -1189,6 +1249,7 @@ int GetChildren(const TF_Filesystem* filesystem, const char* path,
       Aws::String entry = s.substr(prefix.length());
       if (entry.length() > 0) {
         result.push_back(entry);
+        dirs.push_back({absl::StrCat(parent, s.c_str()), {0, 0, true}});
       }
     }
     for (const auto& object : list_objects_result.GetContents()) {
@@ -1196,12 +1257,26 @@ int GetChildren(const TF_Filesystem* filesystem, const char* path,
       Aws::String entry = s.substr(prefix.length());
       if (entry.length() > 0) {
         result.push_back(entry);
+        TF_FileStatistics stats;
+        stats.length = object.GetSize();
+        stats.mtime_nsec = object.GetLastModified().Millis() * 1e6;
+        stats.is_directory = false;
+        files.push_back({absl::StrCat(parent, s.c_str()), stats});
       }
     }
     list_objects_request.SetContinuationToken(
         list_objects_result.GetNextContinuationToken());
   } while (list_objects_result.GetIsTruncated());
 
+  // As in `Stat`, a prefix shadows an object of the same name, so directories
+  // are inserted last.
+  for (const auto& file : files) {
+    s3_file->stat_cache->Insert(file.first, file.second);
+  }
+  for (const auto& dir : dirs) {
+    s3_file->stat_cache->Insert(dir.first, dir.second);
+  }
+
   int num_entries = result.size();
   *entries = static_cast<char**>(
       plugin_memory_allocate(num_entries * sizeof((*entries)[0])));
@@ -25,6 +25,7 @@ limitations under the License.
 #include "absl/synchronization/mutex.h"
 #include "tensorflow/c/experimental/filesystem/filesystem_interface.h"
 #include "tensorflow/c/tf_status.h"
+#include "tensorflow_io/core/filesystems/expiring_lru_cache.h"
 
 namespace tensorflow {
 namespace io {
@@ -68,6 +69,8 @@ typedef struct S3File {
       multi_part_chunk_sizes;
   bool use_multi_part_download;
   absl::Mutex initialization_lock;
+  // Caches `Stat` results, also populated from `GetChildren` listings.
+  std::unique_ptr<ExpiringLRUCache<TF_FileStatistics>> stat_cache;
   S3File();
 } S3File;
 
@@ -5,8 +5,8 @@ import "C"
 import (
 	"context"
 	"crypto/tls"
-	"fmt"
 	"net/http"
+	"sync"
 	"time"
 
 	"github.com/prometheus/client_golang/api"
@@ -57,37 +57,80 @@ func QuerySpecs(endpoint string, query string, timestamp int64, jobs [][]byte, i
 
 }
 
-//export QueryRange
-func QueryRange(endpoint string, query string, start int64, end int64, job string, instance string, name string, timestamp []int64, value []float64) int {
+// clients caches one API client per endpoint so that concurrent and
+// subsequent range queries share the keep-alive connections of its transport.
+var clients sync.Map
+
+func getAPI(endpoint string) (v1.API, error) {
+	if c, ok := clients.Load(endpoint); ok {
+		return c.(v1.API), nil
+	}
 	client, err := api.NewClient(api.Config{
 		Address: endpoint,
 	})
+	if err != nil {
+		return nil, err
+	}
+	c, _ := clients.LoadOrStore(endpoint, v1.NewAPI(client))
+	return c.(v1.API), nil
+}
+
+// QueryRangeWindow fetches the samples of [start, end) at the given step with
+// one range query, and scatters the values of every requested series into its
+// row of value (a row-major [len(names), stride] buffer) starting at column
+// offset. Samples missing from the response are left as is.
+//
+//export QueryRangeWindow
+func QueryRangeWindow(endpoint string, query string, start int64, end int64, step int64, jobs []string, instances []string, names []string, value []float64, offset int, stride int) int {
+	c, err := getAPI(endpoint)
 	if err != nil {
 		return -1
 	}
+	if end <= start || step <= 0 {
+		return 0
+	}
+	last := end - step
+	if last < start {
+		last = start
+	}
 	r := v1.Range{
 		Start: time.Unix(start/1000, (start%1000)*1000000),
-		End:   time.Unix(end/1000, (end%1000)*1000000),
-		Step:  time.Second,
+		End:   time.Unix(last/1000, (last%1000)*1000000),
+		Step:  time.Duration(step) * time.Millisecond,
 	}
-	v, err := v1.NewAPI(client).QueryRange(context.Background(), query, r)
+	v, err := c.QueryRange(context.Background(), query, r)
 	if err != nil {
 		return -1
 	}
-	if m, ok := v.(model.Matrix); ok && m.Len() > 0 {
-		for index := 0; index < len(m); index++ {
-			if m[index].Metric["job"] == model.LabelValue(job) && m[index].Metric["instance"] == model.LabelValue(instance) && m[index].Metric["__name__"] == model.LabelValue(name) {
-				for i := 0; i < len(m[index].Values) && i < len(timestamp) && i < len(value); i++ {
-					v := m[index].Values[i]
-					timestamp[i] = int64(v.Timestamp)
-					value[i] = float64(v.Value)
-				}
-
-				return len(m[index].Values)
+	m, ok := v.(model.Matrix)
+	if !ok {
+		return 0
+	}
+	rows := make(map[string]int, len(names))
+	for index := 0; index < len(jobs) && index < len(instances) && index < len(names); index++ {
+		rows[jobs[index]+"\x00"+instances[index]+"\x00"+names[index]] = index
+	}
+	count := int((end - start + step - 1) / step)
+	returned := 0
+	for _, series := range m {
+		key := string(series.Metric["job"]) + "\x00" + string(series.Metric["instance"]) + "\x00" + string(series.Metric["__name__"])
+		index, ok := rows[key]
+		if !ok {
+			continue
+		}
+		for _, sample := range series.Values {
+			i := int((int64(sample.Timestamp) - start) / step)
+			if i < 0 || i >= count || offset+i >= stride {
+				continue
+			}
+			position := index*stride + offset + i
+			if position < len(value) {
+				value[position] = float64(sample.Value)
+				returned++
 			}
 		}
 	}
-	return 0
+	return returned
 }
 
 //export Scrape
@@ -129,15 +172,4 @@ func getValue(m *dto.Metric) float64 {
 	return 0.
 }
 
-func main() {
-	key := make([]int64, 20, 20)
-	val := make([]float64, 20, 20)
-	end := time.Now().Unix() * 1000
-	start := end - 5*1000
-	fmt.Println(start, end)
-	returned := QueryRange("http://localhost:9090", "coredns_dns_request_count_total", start, end, "", "", "", key, val)
-	fmt.Println(returned)
-	for i := range key {
-		fmt.Printf("%d, %q, %v\n", i, model.TimeFromUnix(key[i]).Time(), val[i])
-	}
-}
+func main() {}
@@ -26,6 +26,67 @@ extern "C" {
 namespace tensorflow {
 namespace data {
 void FFmpegInit();
+
+// Opening an AAC decoder builds its tables, which for short clips costs more
+// than the decode itself. Opened contexts are kept per (rate, channels) and
+// flushed before they are handed out again.
+class AACDecoderContextPool {
+ public:
+  static AACDecoderContextPool* Global() {
+    static AACDecoderContextPool* pool = new AACDecoderContextPool();
+    return pool;
+  }
+
+  AVCodecContext* Acquire(AVCodec* codec, int64 rate, int64 channels) {
+    {
+      mutex_lock l(mu_);
+      std::vector<AVCodecContext*>& contexts = contexts_[{rate, channels}];
+      if (!contexts.empty()) {
+        AVCodecContext* codec_context = contexts.back();
+        contexts.pop_back();
+        return codec_context;
+      }
+    }
+    AVCodecContext* codec_context = avcodec_alloc_context3(codec);
+    if (codec_context == nullptr) {
+      LOG(ERROR) << "unable to create codec context";
+      return nullptr;
+    }
+    codec_context->channels = channels;
+    codec_context->sample_rate = rate;
+    // avcodec_open2 is not thread-safe with older FFmpeg versions
+    mutex_lock l(open_mu_);
+    if (avcodec_open2(codec_context, codec, NULL) < 0) {
+      LOG(ERROR) << "unable to open codec context";
+      avcodec_free_context(&codec_context);
+      return nullptr;
+    }
+    return codec_context;
+  }
+
+  void Release(int64 rate, int64 channels, AVCodecContext* codec_context) {
+    avcodec_flush_buffers(codec_context);
+    {
+      mutex_lock l(mu_);
+      std::vector<AVCodecContext*>& contexts = contexts_[{rate, channels}];
+      if (contexts.size() < kMaxPooledContexts) {
+        contexts.push_back(codec_context);
+        return;
+      }
+    }
+    avcodec_free_context(&codec_context);
+  }
+
+ private:
+  // Enough for one context per CPU worker thread decoding the same format.
+  static constexpr size_t kMaxPooledContexts = 64;
+
+  mutex mu_;
+  mutex open_mu_;
+  std::map<std::pair<int64, int64>, std::vector<AVCodecContext*>> contexts_
+      TF_GUARDED_BY(mu_);
+};
+
 class DecodeAACFunctionState {
  public:
   DecodeAACFunctionState(const int64 codec)
@@ -54,21 +115,15 @@ class DecodeAACFunctionState {
   int64 Call(const int64 rate, const int64 channels, const char* data_in_chunk,
              const int64_t* size_in_chunk, int64_t chunk, int64_t frames,
              char* data_out, int64_t size_out) {
-    std::unique_ptr<AVCodecContext, void (*)(AVCodecContext*)> codec_context(
-        nullptr, [](AVCodecContext* p) {
-          if (p != nullptr) {
-            avcodec_free_context(&p);
-          }
-        });
-    codec_context.reset(avcodec_alloc_context3(codec_));
+    std::unique_ptr<AVCodecContext, std::function<void(AVCodecContext*)>>
+        codec_context(
+            AACDecoderContextPool::Global()->Acquire(codec_, rate, channels),
+            [rate, channels](AVCodecContext* p) {
+              if (p != nullptr) {
+                AACDecoderContextPool::Global()->Release(rate, channels, p);
+              }
+            });
     if (codec_context.get() == nullptr) {
-      LOG(ERROR) << "unable to create codec context";
-      return -1;
-    }
-    codec_context->channels = channels;
-    codec_context->sample_rate = rate;
-    if (avcodec_open2(codec_context.get(), codec_, NULL) < 0) {
-      LOG(ERROR) << "unable to open codec context";
       return -1;
     }
     std::unique_ptr<AVPacket, void (*)(AVPacket*)> packet(
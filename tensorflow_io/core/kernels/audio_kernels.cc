@@ -15,7 +15,12 @@ limitations under the License.
 
 #include "tensorflow_io/core/kernels/audio_kernels.h"
 
+#include <list>
+
 #include "speex/speex_resampler.h"
+#include "tensorflow/core/platform/hash.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace data {
@@ -50,6 +55,120 @@ Status PartitionsLookup(const std::vector<int64>& partitions, const int64 start,
   }
   return OkStatus();
 }
+
+const AudioSeekIndex::Point* AudioSeekIndex::Lookup(int64 sample) const {
+  auto it = std::upper_bound(
+      points.begin(), points.end(), sample,
+      [](int64 sample, const Point& point) { return sample < point.sample; });
+  if (it == points.begin()) {
+    return nullptr;
+  }
+  return &(*(it - 1));
+}
+
+string AudioSeekIndex::Serialize() const {
+  const int64 count = points.size();
+  string data = "TFIOSEEK";
+  data.append(reinterpret_cast<const char*>(&count), sizeof(count));
+  data.append(reinterpret_cast<const char*>(points.data()),
+              points.size() * sizeof(Point));
+  return data;
+}
+
+Status AudioSeekIndex::Parse(StringPiece data) {
+  int64 count = 0;
+  if (data.size() < 8 + sizeof(count) || data.substr(0, 8) != "TFIOSEEK") {
+    return errors::DataLoss("invalid seek index");
+  }
+  memcpy(&count, data.data() + 8, sizeof(count));
+  if (count < 0 || data.size() != 8 + sizeof(count) + count * sizeof(Point)) {
+    return errors::DataLoss("invalid seek index with ", count, " points");
+  }
+  points.resize(count);
+  memcpy(points.data(), data.data() + 8 + sizeof(count),
+         count * sizeof(Point));
+  return OkStatus();
+}
+
+Status AudioSeekIndexLookup(Env* env, const string& codec,
+                            const string& filename, uint64 size,
+                            std::function<Status(AudioSeekIndex*)> build,
+                            std::shared_ptr<const AudioSeekIndex>* index) {
+  // Entries are evicted least recently used first, `lru` holds the keys with
+  // the most recently used one at the front.
+  struct Entry {
+    std::shared_ptr<const AudioSeekIndex> index;
+    std::list<string>::iterator position;
+  };
+  static mutex mu(LINKER_INITIALIZED);
+  static auto* cache = new std::unordered_map<string, Entry>();
+  static auto* lru = new std::list<string>();
+  // Bounds the memory held by the cache, an hour of audio is well below 1MB.
+  static constexpr size_t kMaxCachedIndices = 1024;
+
+  // A file rewritten in place may keep its size, so the modification time is
+  // part of the key. Without it a stale index cannot be detected, and the
+  // index is built without being cached.
+  FileStatistics stat;
+  if (!env->Stat(filename, &stat).ok() || stat.mtime_nsec == 0) {
+    std::shared_ptr<AudioSeekIndex> built(new AudioSeekIndex());
+    TF_RETURN_IF_ERROR(build(built.get()));
+    *index = std::move(built);
+    return OkStatus();
+  }
+  const string key = strings::StrCat(codec, "-", Hash64(filename), "-", size,
+                                     "-", stat.mtime_nsec);
+  {
+    mutex_lock l(mu);
+    auto lookup = cache->find(key);
+    if (lookup != cache->end()) {
+      lru->splice(lru->begin(), *lru, lookup->second.position);
+      *index = lookup->second.index;
+      return OkStatus();
+    }
+  }
+
+  const char* dir = std::getenv("TFIO_AUDIO_SEEK_INDEX_DIR");
+  const string path =
+      (dir != nullptr && dir[0] != '\0')
+          ? io::JoinPath(dir, strings::StrCat(key, ".index"))
+          : "";
+
+  std::unique_ptr<AudioSeekIndex> built(new AudioSeekIndex());
+  string data;
+  if (path.empty() || !ReadFileToString(env, path, &data).ok() ||
+      !built->Parse(data).ok()) {
+    built->points.clear();
+    TF_RETURN_IF_ERROR(build(built.get()));
+    if (!path.empty()) {
+      // Persisting is best effort, the index is rebuilt if it is missing.
+      Status status = WriteStringToFile(env, path, built->Serialize());
+      if (!status.ok()) {
+        LOG(WARNING) << "unable to persist seek index of " << filename
+                     << " to " << path << ": " << status;
+      }
+    }
+  }
+
+  mutex_lock l(mu);
+  auto lookup = cache->find(key);
+  if (lookup != cache->end()) {
+    // Another reader built the same index concurrently.
+    lru->splice(lru->begin(), *lru, lookup->second.position);
+    *index = lookup->second.index;
+    return OkStatus();
+  }
+  while (cache->size() >= kMaxCachedIndices) {
+    cache->erase(lru->back());
+    lru->pop_back();
+  }
+  lru->push_front(key);
+  Entry& entry = (*cache)[key];
+  entry.index = std::move(built);
+  entry.position = lru->begin();
+  *index = entry.index;
+  return OkStatus();
+}
 namespace {
 
 class AudioReadableResource : public AudioReadableResourceBase {
@@ -217,9 +336,114 @@ class AudioReadableReadOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+typedef std::unique_ptr<SpeexResamplerState,
+                        std::function<void(SpeexResamplerState*)>>
+    SpeexResamplerPtr;
+
+// Designing the polyphase filter dominates the cost of resampling short
+// clips, so initialized states are kept per (channels, rate_in, rate_out,
+// quality) and reused. A state is reset before it is handed out again.
+class SpeexResamplerCache {
+ public:
+  static SpeexResamplerCache* Global() {
+    static SpeexResamplerCache* cache = new SpeexResamplerCache();
+    return cache;
+  }
+
+  Status Acquire(int64 channels, int64 rate_in, int64 rate_out, int64 quality,
+                 SpeexResamplerPtr* state) {
+    if (channels <= 0 || rate_in <= 0 || rate_out <= 0) {
+      return errors::InvalidArgument(
+          "channels and rates must be positive, got channels = ", channels,
+          ", rate_in = ", rate_in, ", rate_out = ", rate_out);
+    }
+    if (quality < SPEEX_RESAMPLER_QUALITY_MIN ||
+        quality > SPEEX_RESAMPLER_QUALITY_MAX) {
+      return errors::InvalidArgument("quality must be in [",
+                                     SPEEX_RESAMPLER_QUALITY_MIN, ", ",
+                                     SPEEX_RESAMPLER_QUALITY_MAX, "], got ",
+                                     quality);
+    }
+    const Key key(channels, rate_in, rate_out, quality);
+    SpeexResamplerState* p = nullptr;
+    {
+      mutex_lock l(mu_);
+      std::vector<SpeexResamplerState*>& states = states_[key];
+      if (!states.empty()) {
+        p = states.back();
+        states.pop_back();
+      }
+    }
+    if (p == nullptr) {
+      int err = 0;
+      p = speex_resampler_init(channels, rate_in, rate_out, quality, &err);
+      if (p == nullptr) {
+        return errors::InvalidArgument("unable to initialize resampler: ",
+                                       err);
+      }
+    }
+    *state = SpeexResamplerPtr(
+        p, [this, key](SpeexResamplerState* p) { Release(key, p); });
+    return OkStatus();
+  }
+
+ private:
+  typedef std::tuple<int64, int64, int64, int64> Key;
+  static constexpr size_t kMaxStatesPerKey = 64;
+
+  void Release(const Key& key, SpeexResamplerState* p) {
+    speex_resampler_reset_mem(p);
+    {
+      mutex_lock l(mu_);
+      std::vector<SpeexResamplerState*>& states = states_[key];
+      if (states.size() < kMaxStatesPerKey) {
+        states.push_back(p);
+        return;
+      }
+    }
+    speex_resampler_destroy(p);
+  }
+
+  mutex mu_;
+  std::map<Key, std::vector<SpeexResamplerState*>> states_ TF_GUARDED_BY(mu_);
+};
+
+int SpeexResamplerProcess(SpeexResamplerState* state, const int16* input,
+                          uint32_t* in_len, int16* output, uint32_t* out_len) {
+  return speex_resampler_process_interleaved_int(state, input, in_len, output,
+                                                 out_len);
+}
+
+int SpeexResamplerProcess(SpeexResamplerState* state, const float* input,
+                          uint32_t* in_len, float* output, uint32_t* out_len) {
+  return speex_resampler_process_interleaved_float(state, input, in_len,
+                                                   output, out_len);
+}
+
+// Resamples a whole [samples_in, channels] clip into [samples_out, channels],
+// the tail that is still inside the filter is dropped.
+template <typename T>
+Status SpeexResampleClip(SpeexResamplerState* state, const T* input,
+                         int64 samples_in, T* output, int64 samples_out) {
+  uint32_t processed_in = samples_in;
+  uint32_t processed_out = samples_out;
+  int returned = SpeexResamplerProcess(state, input, &processed_in, output,
+                                       &processed_out);
+  if (returned != 0) {
+    return errors::InvalidArgument("process error: ", returned);
+  }
+  if (processed_out != samples_out) {
+    return errors::InvalidArgument("output buffer mismatch: ", processed_out,
+                                   " vs. ", samples_out);
+  }
+  return OkStatus();
+}
+
 class AudioResampleOp : public OpKernel {
  public:
-  explicit AudioResampleOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit AudioResampleOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("quality", &quality_));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor* input_tensor;
@@ -236,19 +460,10 @@ class AudioResampleOp : public OpKernel {
     int64 samples_in = input_tensor->shape().dim_size(0);
     int64 channels = input_tensor->shape().dim_size(1);
 
-    std::unique_ptr<SpeexResamplerState, void (*)(SpeexResamplerState*)> state(
-        nullptr, [](SpeexResamplerState* p) {
-          if (p != nullptr) {
-            speex_resampler_destroy(p);
-          }
-        });
-
-    int err = 0;
-    state.reset(
-        speex_resampler_init(channels, rate_in, rate_out, quality_, &err));
-    OP_REQUIRES(
-        context, (state.get() != nullptr),
-        errors::InvalidArgument("unable to initialize resampler: ", err));
+    SpeexResamplerPtr state;
+    OP_REQUIRES_OK(context,
+                   SpeexResamplerCache::Global()->Acquire(
+                       channels, rate_in, rate_out, quality_, &state));
 
     int64 samples_out = samples_in * rate_out / rate_in;
     Tensor* output_tensor;
@@ -257,34 +472,21 @@ class AudioResampleOp : public OpKernel {
         OP_REQUIRES_OK(context, context->allocate_output(
                                     0, TensorShape({samples_out, channels}),
                                     &output_tensor));
-
-        uint32_t processed_in = samples_in;
-        uint32_t processed_out = samples_out;
-        int returned = speex_resampler_process_interleaved_int(
-            state.get(), input_tensor->flat<int16>().data(), &processed_in,
-            output_tensor->flat<int16>().data(), &processed_out);
-        OP_REQUIRES(context, (returned == 0),
-                    errors::InvalidArgument("process error: ", returned));
-        OP_REQUIRES(
-            context, (processed_out == samples_out),
-            errors::InvalidArgument("output buffer mismatch: ", processed_out,
-                                    " vs. ", samples_out));
+        OP_REQUIRES_OK(context,
+                       SpeexResampleClip<int16>(
+                           state.get(), input_tensor->flat<int16>().data(),
+                           samples_in, output_tensor->flat<int16>().data(),
+                           samples_out));
       } break;
       case DT_FLOAT: {
         OP_REQUIRES_OK(context, context->allocate_output(
                                     0, TensorShape({samples_out, channels}),
                                     &output_tensor));
-        uint32_t processed_in = samples_in;
-        uint32_t processed_out = samples_out;
-        int returned = speex_resampler_process_interleaved_float(
-            state.get(), input_tensor->flat<float>().data(), &processed_in,
-            output_tensor->flat<float>().data(), &processed_out);
-        OP_REQUIRES(context, (returned == 0),
-                    errors::InvalidArgument("process error: ", returned));
-        OP_REQUIRES(
-            context, (processed_out == samples_out),
-            errors::InvalidArgument("output buffer mismatch: ", processed_out,
-                                    " vs. ", samples_out));
+        OP_REQUIRES_OK(context,
+                       SpeexResampleClip<float>(
+                           state.get(), input_tensor->flat<float>().data(),
+                           samples_in, output_tensor->flat<float>().data(),
+                           samples_out));
       } break;
       default:
         OP_REQUIRES_OK(context,
@@ -295,7 +497,283 @@ class AudioResampleOp : public OpKernel {
   }
 
  private:
-  static const int64 quality_ = SPEEX_RESAMPLER_QUALITY_DEFAULT;
+  int64 quality_;
+};
+
+// Resamples a [batch, samples, channels] batch of clips in parallel on the CPU
+// worker threads, every clip with its own (cached) resampler state.
+class AudioResampleBatchOp : public OpKernel {
+ public:
+  explicit AudioResampleBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("quality", &quality_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    OP_REQUIRES(context, input_tensor->dims() == 3,
+                errors::InvalidArgument(
+                    "input must be [batch, samples, channels], got shape ",
+                    input_tensor->shape().DebugString()));
+
+    const Tensor* rate_in_tensor;
+    OP_REQUIRES_OK(context, context->input("rate_in", &rate_in_tensor));
+    const int64 rate_in = rate_in_tensor->scalar<int64>()();
+
+    const Tensor* rate_out_tensor;
+    OP_REQUIRES_OK(context, context->input("rate_out", &rate_out_tensor));
+    const int64 rate_out = rate_out_tensor->scalar<int64>()();
+    OP_REQUIRES(context, rate_in > 0,
+                errors::InvalidArgument("rate_in must be positive, got ",
+                                        rate_in));
+
+    const int64 batch = input_tensor->shape().dim_size(0);
+    const int64 samples_in = input_tensor->shape().dim_size(1);
+    const int64 channels = input_tensor->shape().dim_size(2);
+    const int64 samples_out = samples_in * rate_out / rate_in;
+
+    Tensor* output_tensor;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(
+                       0, TensorShape({batch, samples_out, channels}),
+                       &output_tensor));
+
+    std::vector<Status> status(batch);
+    auto resample = [&](int64 start, int64 limit) {
+      for (int64 i = start; i < limit; i++) {
+        SpeexResamplerPtr state;
+        status[i] = SpeexResamplerCache::Global()->Acquire(
+            channels, rate_in, rate_out, quality_, &state);
+        if (!status[i].ok()) {
+          continue;
+        }
+        switch (input_tensor->dtype()) {
+          case DT_INT16:
+            status[i] = SpeexResampleClip<int16>(
+                state.get(),
+                input_tensor->flat<int16>().data() + i * samples_in * channels,
+                samples_in,
+                output_tensor->flat<int16>().data() +
+                    i * samples_out * channels,
+                samples_out);
+            break;
+          case DT_FLOAT:
+            status[i] = SpeexResampleClip<float>(
+                state.get(),
+                input_tensor->flat<float>().data() + i * samples_in * channels,
+                samples_in,
+                output_tensor->flat<float>().data() +
+                    i * samples_out * channels,
+                samples_out);
+            break;
+          default:
+            status[i] = errors::InvalidArgument(
+                "Data type ", DataTypeString(input_tensor->dtype()),
+                " not supported");
+        }
+      }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, batch,
+          (samples_in + samples_out) * channels * (quality_ + 1) * 10,
+          resample);
+    for (const Status& s : status) {
+      OP_REQUIRES_OK(context, s);
+    }
+  }
+
+ private:
+  int64 quality_;
+};
+
+// Keeps the resampler state across calls so a stream can be resampled chunk by
+// chunk without discontinuities at the chunk boundaries.
+class AudioResamplerResource : public ResourceBase {
+ public:
+  AudioResamplerResource(Env* env) : env_(env) {}
+  ~AudioResamplerResource() {}
+
+  Status Init(const int64 rate_in, const int64 rate_out, const int64 channels,
+              const int64 quality) {
+    mutex_lock l(mu_);
+    rate_in_ = rate_in;
+    rate_out_ = rate_out;
+    channels_ = channels;
+    samples_in_ = 0;
+    samples_out_ = 0;
+    return SpeexResamplerCache::Global()->Acquire(channels, rate_in, rate_out,
+                                                  quality, &state_);
+  }
+
+  // Resamples the next [samples, channels] chunk of the stream. With `flush`
+  // the samples still inside the filter are drained and the state is reset,
+  // so that the resource can be used for a new stream.
+  template <typename T>
+  Status Process(const Tensor& input, bool flush,
+                 std::function<Status(const TensorShape& shape, Tensor** value)>
+                     allocate_func) {
+    mutex_lock l(mu_);
+    if (input.dims() != 2 || input.dim_size(1) != channels_) {
+      return errors::InvalidArgument("input must be [samples, ", channels_,
+                                     "], got shape ",
+                                     input.shape().DebugString());
+    }
+    const int64 samples = input.dim_size(0);
+    std::vector<T> output;
+    TF_RETURN_IF_ERROR(Resample<T>(input.flat<T>().data(), samples, &output));
+    samples_in_ += samples;
+
+    if (flush) {
+      // Feed enough silence to push the remaining samples out of the filter,
+      // then keep only as many samples as the whole stream should produce.
+      const int64 latency = speex_resampler_get_input_latency(state_.get());
+      std::vector<T> silence(latency * channels_, T(0));
+      TF_RETURN_IF_ERROR(Resample<T>(silence.data(), latency, &output));
+      const int64 expected = std::max<int64>(
+          0, samples_in_ * rate_out_ / rate_in_ - samples_out_);
+      if (output.size() > expected * channels_) {
+        output.resize(expected * channels_);
+      }
+    }
+
+    const int64 produced = output.size() / channels_;
+    Tensor* value;
+    TF_RETURN_IF_ERROR(
+        allocate_func(TensorShape({produced, channels_}), &value));
+    if (produced > 0) {
+      memcpy(value->flat<T>().data(), output.data(),
+             output.size() * sizeof(T));
+    }
+    samples_out_ += produced;
+
+    if (flush) {
+      speex_resampler_reset_mem(state_.get());
+      samples_in_ = 0;
+      samples_out_ = 0;
+    }
+    return OkStatus();
+  }
+
+  string DebugString() const override {
+    mutex_lock l(mu_);
+    return strings::StrCat("AudioResamplerResource[", rate_in_, " => ",
+                           rate_out_, "]");
+  }
+
+ private:
+  // Appends the resampled `samples` to `output`, growing the output buffer
+  // until the resampler has consumed all of the input.
+  template <typename T>
+  Status Resample(const T* input, int64 samples, std::vector<T>* output)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    int64 consumed = 0;
+    int64 produced = output->size() / channels_;
+    int64 capacity = produced + samples * rate_out_ / rate_in_ + 16;
+    while (consumed < samples) {
+      output->resize(capacity * channels_);
+      uint32_t in_len = samples - consumed;
+      uint32_t out_len = capacity - produced;
+      int returned = SpeexResamplerProcess(
+          state_.get(), input + consumed * channels_, &in_len,
+          output->data() + produced * channels_, &out_len);
+      if (returned != 0) {
+        return errors::InvalidArgument("process error: ", returned);
+      }
+      consumed += in_len;
+      produced += out_len;
+      if (consumed < samples) {
+        capacity *= 2;
+      }
+    }
+    output->resize(produced * channels_);
+    return OkStatus();
+  }
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  SpeexResamplerPtr state_ TF_GUARDED_BY(mu_);
+  int64 rate_in_ TF_GUARDED_BY(mu_) = 0;
+  int64 rate_out_ TF_GUARDED_BY(mu_) = 0;
+  int64 channels_ TF_GUARDED_BY(mu_) = 0;
+  int64 samples_in_ TF_GUARDED_BY(mu_) = 0;
+  int64 samples_out_ TF_GUARDED_BY(mu_) = 0;
+};
+
+class AudioResamplerInitOp : public ResourceOpKernel<AudioResamplerResource> {
+ public:
+  explicit AudioResamplerInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<AudioResamplerResource>(context) {
+    env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("quality", &quality_));
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<AudioResamplerResource>::Compute(context);
+
+    const Tensor* rate_in_tensor;
+    OP_REQUIRES_OK(context, context->input("rate_in", &rate_in_tensor));
+    const Tensor* rate_out_tensor;
+    OP_REQUIRES_OK(context, context->input("rate_out", &rate_out_tensor));
+    const Tensor* channels_tensor;
+    OP_REQUIRES_OK(context, context->input("channels", &channels_tensor));
+
+    OP_REQUIRES_OK(context,
+                   resource_->Init(rate_in_tensor->scalar<int64>()(),
+                                   rate_out_tensor->scalar<int64>()(),
+                                   channels_tensor->scalar<int64>()(),
+                                   quality_));
+  }
+  Status CreateResource(AudioResamplerResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new AudioResamplerResource(env_);
+    return OkStatus();
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  int64 quality_;
+};
+
+class AudioResamplerProcessOp : public OpKernel {
+ public:
+  explicit AudioResamplerProcessOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    AudioResamplerResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "resource", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    const Tensor* flush_tensor;
+    OP_REQUIRES_OK(context, context->input("flush", &flush_tensor));
+    const bool flush = flush_tensor->scalar<bool>()();
+
+    auto allocate_func = [&](const TensorShape& shape,
+                             Tensor** value) -> Status {
+      return context->allocate_output(0, shape, value);
+    };
+    switch (input_tensor->dtype()) {
+      case DT_INT16:
+        OP_REQUIRES_OK(context, resource->Process<int16>(*input_tensor, flush,
+                                                         allocate_func));
+        break;
+      case DT_FLOAT:
+        OP_REQUIRES_OK(context, resource->Process<float>(*input_tensor, flush,
+                                                         allocate_func));
+        break;
+      default:
+        OP_REQUIRES_OK(context,
+                       errors::InvalidArgument(
+                           "Data type ", DataTypeString(input_tensor->dtype()),
+                           " not supported"));
+    }
+  }
 };
 
 REGISTER_KERNEL_BUILDER(Name("IO>AudioReadableInit").Device(DEVICE_CPU),
@@ -307,6 +785,12 @@ REGISTER_KERNEL_BUILDER(Name("IO>AudioReadableRead").Device(DEVICE_CPU),
 
 REGISTER_KERNEL_BUILDER(Name("IO>AudioResample").Device(DEVICE_CPU),
                         AudioResampleOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioResampleBatch").Device(DEVICE_CPU),
+                        AudioResampleBatchOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioResamplerInit").Device(DEVICE_CPU),
+                        AudioResamplerInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioResamplerProcess").Device(DEVICE_CPU),
+                        AudioResamplerProcessOp);
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
@@ -13,6 +13,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "tensorflow/core/util/work_sharder.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 
@@ -23,6 +24,36 @@ Status PartitionsLookup(const std::vector<int64>& partitions, const int64 start,
                         const int64 stop, int64* upper, int64* lower,
                         int64* extra);
 
+// Maps the first sample of every frame in a compressed audio file to the
+// byte offset of the frame, so a range read seeks straight to the frame that
+// holds its first sample instead of searching the file.
+class AudioSeekIndex {
+ public:
+  struct Point {
+    int64 sample;
+    int64 offset;
+  };
+
+  // Returns the last point at or before `sample`, or nullptr if there is none.
+  const Point* Lookup(int64 sample) const;
+
+  string Serialize() const;
+  Status Parse(StringPiece data);
+
+  // Points sorted by sample.
+  std::vector<Point> points;
+};
+
+// Returns the `codec` index of `filename` (of `size` bytes). Indices are kept
+// in a process wide LRU cache, and are also persisted to the directory named
+// by the TFIO_AUDIO_SEEK_INDEX_DIR environment variable when it is set. Both
+// are keyed by the file's size and modification time. Only on a miss in both
+// is `build` called.
+Status AudioSeekIndexLookup(Env* env, const string& codec,
+                            const string& filename, uint64 size,
+                            std::function<Status(AudioSeekIndex*)> build,
+                            std::shared_ptr<const AudioSeekIndex>* index);
+
 class AudioReadableResourceBase : public ResourceBase {
  public:
   virtual Status Init(const string& filename,
@@ -35,6 +66,102 @@ class AudioReadableResourceBase : public ResourceBase {
   virtual Status Spec(TensorShape* shape, DataType* dtype, int32* rate) = 0;
 };
 
+// Decodes a 1-D batch of encoded clips into a [batch, samples, channels]
+// tensor zero padded to the longest clip, along with the length of each clip.
+// Clips are decoded in parallel on the CPU worker threads, each by its own
+// ResourceType constructed from the Env. Reads are handed an unaligned slice
+// of the output, so ResourceType must write through value->data().
+template <typename ResourceType>
+class AudioDecodeBatchOp : public OpKernel {
+ public:
+  explicit AudioDecodeBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(input_tensor->shape()),
+                errors::InvalidArgument("input must be 1-D, got shape ",
+                                        input_tensor->shape().DebugString()));
+    const auto input = input_tensor->flat<tstring>();
+    const int64 batch = input.size();
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+
+    std::vector<std::unique_ptr<ResourceType>> resources(batch);
+    std::vector<TensorShape> shapes(batch);
+    std::vector<DataType> dtypes(batch);
+    std::vector<Status> status(batch);
+    Shard(worker_threads->num_threads, worker_threads->workers, batch,
+          kDecodeCostPerClip, [&](int64 start, int64 limit) {
+            for (int64 i = start; i < limit; i++) {
+              resources[i].reset(new ResourceType(env_));
+              status[i] = resources[i]->Init("memory", input(i).data(),
+                                             input(i).size());
+              if (status[i].ok()) {
+                int32 rate;
+                status[i] = resources[i]->Spec(&shapes[i], &dtypes[i], &rate);
+              }
+            }
+          });
+    int64 samples = 0;
+    for (int64 i = 0; i < batch; i++) {
+      OP_REQUIRES_OK(context, status[i]);
+      OP_REQUIRES(context, dtypes[i] == context->expected_output_dtype(0),
+                  errors::InvalidArgument(
+                      "clip ", i, " has dtype ", DataTypeString(dtypes[i]),
+                      ", expected ",
+                      DataTypeString(context->expected_output_dtype(0))));
+      OP_REQUIRES(context, shapes[i].dim_size(1) == shapes[0].dim_size(1),
+                  errors::InvalidArgument(
+                      "clip ", i, " has ", shapes[i].dim_size(1),
+                      " channels, expected ", shapes[0].dim_size(1)));
+      samples = std::max(samples, shapes[i].dim_size(0));
+    }
+    const int64 channels = (batch > 0) ? shapes[0].dim_size(1) : 0;
+
+    Tensor* value_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({batch, samples, channels}),
+                                &value_tensor));
+    Tensor* length_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(1, TensorShape({batch}),
+                                                     &length_tensor));
+    memset(value_tensor->data(), 0, value_tensor->TotalBytes());
+    for (int64 i = 0; i < batch; i++) {
+      length_tensor->flat<int64>()(i) = shapes[i].dim_size(0);
+    }
+
+    Shard(worker_threads->num_threads, worker_threads->workers, batch,
+          kDecodeCostPerClip, [&](int64 start, int64 limit) {
+            for (int64 i = start; i < limit; i++) {
+              // Decode straight into the leading rows of the clip's slot.
+              Tensor slot = value_tensor->SubSlice(i).Slice(
+                  0, shapes[i].dim_size(0));
+              status[i] = resources[i]->Read(
+                  0, shapes[i].dim_size(0),
+                  [&slot](const TensorShape& shape, Tensor** value) -> Status {
+                    *value = &slot;
+                    return OkStatus();
+                  });
+              resources[i].reset(nullptr);
+            }
+          });
+    for (int64 i = 0; i < batch; i++) {
+      OP_REQUIRES_OK(context, status[i]);
+    }
+  }
+
+ private:
+  // Decoding a clip is orders of magnitude more expensive than the cost
+  // model's per element default, so give every clip its own shard.
+  static constexpr int64 kDecodeCostPerClip = 1 << 20;
+
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
 Status WAVReadableResourceInit(
     Env* env, const string& filename, const void* optional_memory,
     const size_t optional_length,
@@ -30,7 +30,10 @@ class FlacStreamDecoder {
         samples(0),
         channels(0),
         rate(0),
-        bits_per_sample(0) {}
+        bits_per_sample(0),
+        first_frame_offset(0),
+        index(nullptr),
+        frame_offset(0) {}
   ~FlacStreamDecoder() {}
 
   void SetTensor(int64 start, Tensor* value) {
@@ -102,15 +105,34 @@ class FlacStreamDecoder {
     if (frame->header.number_type != FLAC__FRAME_NUMBER_TYPE_SAMPLE_NUMBER) {
       return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
     }
+    const int64 frame_start = frame->header.number.sample_number;
+    const int64 frame_stop = frame_start + frame->header.blocksize;
+
+    if (p->index != nullptr) {
+      // Building the seek index, the frame just decoded ends at the current
+      // decode position, which is where the next frame starts.
+      FLAC__uint64 position = 0;
+      if (!FLAC__stream_decoder_get_decode_position(decoder, &position)) {
+        return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
+      }
+      p->index->points.push_back({frame_start, p->frame_offset});
+      p->frame_offset = position;
+      return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
 
-    if (p->sample_index != frame->header.number.sample_number) {
+    // A seek lands on the frame holding the first sample, so leading samples
+    // of that frame are skipped.
+    if (frame_stop <= p->sample_index) {
+      return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+    }
+    if (frame_start > p->sample_index) {
       return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT;
     }
+    const int64 skip = p->sample_index - frame_start;
 
     int64 samples_to_read =
-        (p->sample_index + frame->header.blocksize) <
-                (p->sample_start + p->sample_value->shape().dim_size(0))
-            ? (frame->header.blocksize)
+        frame_stop < (p->sample_start + p->sample_value->shape().dim_size(0))
+            ? (frame_stop - p->sample_index)
             : (p->sample_start + p->sample_value->shape().dim_size(0) -
                p->sample_index);
 
@@ -121,7 +143,7 @@ class FlacStreamDecoder {
           for (int64 index = 0; index < samples_to_read; index++) {
             int64 sample_index = p->sample_index + index - p->sample_start;
             p->sample_value->tensor<uint8, 2>()(sample_index, channel) =
-                (static_cast<uint8>(buffer[channel][index] + 0x80));
+                (static_cast<uint8>(buffer[channel][skip + index] + 0x80));
           }
         }
         break;
@@ -130,7 +152,7 @@ class FlacStreamDecoder {
           for (int64 index = 0; index < samples_to_read; index++) {
             int64 sample_index = p->sample_index + index - p->sample_start;
             p->sample_value->tensor<int16, 2>()(sample_index, channel) =
-                buffer[channel][index];
+                buffer[channel][skip + index];
           }
         }
         break;
@@ -140,7 +162,7 @@ class FlacStreamDecoder {
           for (int64 index = 0; index < samples_to_read; index++) {
             int64 sample_index = p->sample_index + index - p->sample_start;
             p->sample_value->tensor<int32, 2>()(sample_index, channel) =
-                (static_cast<int32>(buffer[channel][index]) << 8);
+                (static_cast<int32>(buffer[channel][skip + index]) << 8);
           }
         }
         break;
@@ -155,10 +177,31 @@ class FlacStreamDecoder {
                                const FLAC__StreamMetadata* metadata,
                                void* client_data) {
     FlacStreamDecoder* p = static_cast<FlacStreamDecoder*>(client_data);
-    p->samples = metadata->data.stream_info.total_samples;
-    p->channels = metadata->data.stream_info.channels;
-    p->rate = metadata->data.stream_info.sample_rate;
-    p->bits_per_sample = metadata->data.stream_info.bits_per_sample;
+    switch (metadata->type) {
+      case FLAC__METADATA_TYPE_STREAMINFO:
+        p->samples = metadata->data.stream_info.total_samples;
+        p->channels = metadata->data.stream_info.channels;
+        p->rate = metadata->data.stream_info.sample_rate;
+        p->bits_per_sample = metadata->data.stream_info.bits_per_sample;
+        break;
+      case FLAC__METADATA_TYPE_SEEKTABLE:
+        // Offsets are relative to the first frame, which is only known once
+        // all metadata has been read.
+        p->seek_table.clear();
+        for (uint32_t i = 0; i < metadata->data.seek_table.num_points; i++) {
+          const FLAC__StreamMetadata_SeekPoint& point =
+              metadata->data.seek_table.points[i];
+          if (point.sample_number ==
+              FLAC__STREAM_METADATA_SEEKPOINT_PLACEHOLDER) {
+            continue;
+          }
+          p->seek_table.push_back({static_cast<int64>(point.sample_number),
+                                   static_cast<int64>(point.stream_offset)});
+        }
+        break;
+      default:
+        break;
+    }
   }
 
   static void ErrorCallback(const FLAC__StreamDecoder* decoder,
@@ -176,6 +219,15 @@ class FlacStreamDecoder {
   int64 rate;
   int64 bits_per_sample;
 
+  // Byte offset of the first frame, and the seek points of the SEEKTABLE
+  // metadata block relative to it, if the stream has one.
+  int64 first_frame_offset;
+  std::vector<AudioSeekIndex::Point> seek_table;
+
+  // Set while scanning the frames to build a seek index.
+  AudioSeekIndex* index;
+  int64 frame_offset;
+
   int64 sample_index;
   int64 sample_start;
   Tensor* sample_value;
@@ -241,12 +293,16 @@ class FlacReadableResource : public AudioReadableResourceBase {
   Status Init(const string& filename, const void* optional_memory,
               const size_t optional_length) override {
     mutex_lock l(mu_);
+    filename_ = filename;
+    memory_ = (optional_memory != nullptr);
     file_.reset(new SizedRandomAccessFile(env_, filename, optional_memory,
                                           optional_length));
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
 
     decoder_.reset(FLAC__stream_decoder_new());
     stream_decoder_.reset(new FlacStreamDecoder(file_.get(), file_size_));
+    FLAC__stream_decoder_set_metadata_respond(decoder_.get(),
+                                              FLAC__METADATA_TYPE_SEEKTABLE);
 
     FLAC__StreamDecoderInitStatus s = FLAC__stream_decoder_init_stream(
         decoder_.get(), FlacStreamDecoder::ReadCallback,
@@ -260,6 +316,12 @@ class FlacReadableResource : public AudioReadableResourceBase {
     if (!FLAC__stream_decoder_process_until_end_of_metadata(decoder_.get())) {
       return errors::InvalidArgument("unable to read metadata");
     }
+    FLAC__uint64 first_frame_offset = 0;
+    if (!FLAC__stream_decoder_get_decode_position(decoder_.get(),
+                                                  &first_frame_offset)) {
+      return errors::InvalidArgument("unable to locate first frame");
+    }
+    stream_decoder_->first_frame_offset = first_frame_offset;
 
     int64 samples = stream_decoder_->samples;
     int64 channels = stream_decoder_->channels;
@@ -308,7 +370,24 @@ class FlacReadableResource : public AudioReadableResourceBase {
         TensorShape({sample_stop - sample_start, shape_.dim_size(1)}), &value));
 
     stream_decoder_->SetTensor(sample_start, value);
-    if (!FLAC__stream_decoder_seek_absolute(decoder_.get(), sample_start)) {
+    if (sample_start == sample_stop) {
+      return OkStatus();
+    }
+
+    // Reading from the start needs no index, which keeps decode_flac from
+    // scanning the stream twice.
+    int64 offset = stream_decoder_->first_frame_offset;
+    if (sample_start > 0) {
+      if (index_ == nullptr) {
+        TF_RETURN_IF_ERROR(LoadSeekIndex());
+      }
+      const AudioSeekIndex::Point* point = index_->Lookup(sample_start);
+      if (point != nullptr) {
+        offset = point->offset;
+      }
+    }
+    stream_decoder_->offset = offset;
+    if (!FLAC__stream_decoder_flush(decoder_.get())) {
       return errors::InvalidArgument("unable to seek to: ", sample_start);
     }
 
@@ -323,6 +402,41 @@ class FlacReadableResource : public AudioReadableResourceBase {
   string DebugString() const override { return "FlacReadableResource"; }
 
  private:
+  // Uses the SEEKTABLE of the stream when it has one, otherwise frames are
+  // scanned once and the index is shared by every resource of the same file.
+  Status LoadSeekIndex() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    auto build = [this](AudioSeekIndex* index) -> Status {
+      if (!stream_decoder_->seek_table.empty()) {
+        for (const auto& point : stream_decoder_->seek_table) {
+          index->points.push_back(
+              {point.sample,
+               stream_decoder_->first_frame_offset + point.offset});
+        }
+        return OkStatus();
+      }
+      stream_decoder_->index = index;
+      stream_decoder_->offset = stream_decoder_->first_frame_offset;
+      stream_decoder_->frame_offset = stream_decoder_->first_frame_offset;
+      const bool ok =
+          FLAC__stream_decoder_flush(decoder_.get()) &&
+          FLAC__stream_decoder_process_until_end_of_stream(decoder_.get());
+      stream_decoder_->index = nullptr;
+      if (!ok) {
+        return errors::InvalidArgument("unable to index frames of ",
+                                       filename_);
+      }
+      return OkStatus();
+    };
+    if (memory_) {
+      std::shared_ptr<AudioSeekIndex> index(new AudioSeekIndex());
+      TF_RETURN_IF_ERROR(build(index.get()));
+      index_ = std::move(index);
+      return OkStatus();
+    }
+    return AudioSeekIndexLookup(env_, "flac", filename_, file_size_, build,
+                                &index_);
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
@@ -333,6 +447,10 @@ class FlacReadableResource : public AudioReadableResourceBase {
 
   std::unique_ptr<FLAC__StreamDecoder, void (*)(FLAC__StreamDecoder*)> decoder_;
   std::unique_ptr<FlacStreamDecoder> stream_decoder_;
+
+  string filename_;
+  bool memory_;
+  std::shared_ptr<const AudioSeekIndex> index_;
 };
 
 class AudioDecodeFlacOp : public OpKernel {
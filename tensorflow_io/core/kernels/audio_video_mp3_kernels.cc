@@ -107,6 +107,8 @@ class MP3ReadableResource : public AudioReadableResourceBase {
   Status Init(const string& filename, const void* optional_memory,
               const size_t optional_length) override {
     mutex_lock l(mu_);
+    filename_ = filename;
+    memory_ = (optional_memory != nullptr);
     file_.reset(new SizedRandomAccessFile(env_, filename, optional_memory,
                                           optional_length));
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
@@ -159,6 +161,9 @@ class MP3ReadableResource : public AudioReadableResourceBase {
     TF_RETURN_IF_ERROR(allocate_func(
         TensorShape({sample_stop - sample_start, shape_.dim_size(1)}), &value));
 
+    if (sample_start > 0 && !memory_ && !mp3dec_ex_.indexes_built) {
+      TF_RETURN_IF_ERROR(LoadSeekIndex());
+    }
     if (mp3dec_ex_seek(&mp3dec_ex_, sample_start * shape_.dim_size(1))) {
       return errors::InvalidArgument("seek to ", sample_start,
                                      " failed: ", mp3dec_ex_.last_error);
@@ -175,6 +180,58 @@ class MP3ReadableResource : public AudioReadableResourceBase {
   string DebugString() const override { return "MP3ReadableResource"; }
 
  private:
+  // minimp3 scans every frame of the file on the first seek to build its
+  // frame index. The index is shared by all resources of the same file (and
+  // optionally persisted), and handed to minimp3 so the scan happens once.
+  Status LoadSeekIndex() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    static_assert(sizeof(mp3dec_frame_t) == sizeof(AudioSeekIndex::Point),
+                  "minimp3 frame index layout changed");
+    if (mp3dec_ex_.samples <= shape_.dim_size(1)) {
+      return OkStatus();
+    }
+    bool built = false;
+    std::shared_ptr<const AudioSeekIndex> index;
+    TF_RETURN_IF_ERROR(AudioSeekIndexLookup(
+        env_, "mp3", filename_, file_size_,
+        [this, &built](AudioSeekIndex* index) -> Status {
+          // Seeking anywhere but the start builds the index.
+          if (mp3dec_ex_seek(&mp3dec_ex_, mp3dec_ex_.samples - 1) ||
+              !mp3dec_ex_.indexes_built) {
+            return errors::InvalidArgument("unable to index frames of ",
+                                           filename_, ": ",
+                                           mp3dec_ex_.last_error);
+          }
+          index->points.reserve(mp3dec_ex_.index.num_frames);
+          for (size_t i = 0; i < mp3dec_ex_.index.num_frames; i++) {
+            index->points.push_back(
+                {static_cast<int64>(mp3dec_ex_.index.frames[i].sample),
+                 static_cast<int64>(mp3dec_ex_.index.frames[i].offset)});
+          }
+          built = true;
+          return OkStatus();
+        },
+        &index));
+    if (built || index->points.empty()) {
+      return OkStatus();
+    }
+    // Released by mp3dec_ex_close.
+    mp3dec_frame_t* frames = static_cast<mp3dec_frame_t*>(
+        malloc(index->points.size() * sizeof(mp3dec_frame_t)));
+    if (frames == nullptr) {
+      return errors::ResourceExhausted("unable to allocate mp3 frame index");
+    }
+    for (size_t i = 0; i < index->points.size(); i++) {
+      frames[i].sample = index->points[i].sample;
+      frames[i].offset = index->points[i].offset;
+    }
+    free(mp3dec_ex_.index.frames);
+    mp3dec_ex_.index.frames = frames;
+    mp3dec_ex_.index.num_frames = index->points.size();
+    mp3dec_ex_.index.capacity = index->points.size();
+    mp3dec_ex_.indexes_built = 1;
+    return OkStatus();
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
@@ -187,6 +244,9 @@ class MP3ReadableResource : public AudioReadableResourceBase {
   mp3dec_io_t mp3dec_io_;
   mp3dec_ex_t mp3dec_ex_;
   std::unique_ptr<mp3dec_ex_t, void (*)(mp3dec_ex_t*)> mp3dec_ex_scope_;
+
+  string filename_;
+  bool memory_;
 };
 
 class AudioDecodeMP3Op : public OpKernel {
@@ -146,20 +146,29 @@ void DecodeAACFunctionFini(void* state) {
 }
 void* DecodeAACFunctionInit(const int64_t codec, const int64_t rate,
                             const int64_t channels) {
-  *(void**)(&DecodeAACFunctionFiniPointer) =
-      dlsym(RTLD_DEFAULT, "DecodeAACFunctionFiniFFmpeg");
-  *(void**)(&DecodeAACFunctionInitPointer) =
-      dlsym(RTLD_DEFAULT, "DecodeAACFunctionInitFFmpeg");
-  *(void**)(&DecodeAACFunctionCallPointer) =
-      dlsym(RTLD_DEFAULT, "DecodeAACFunctionCallFFmpeg");
-  if (DecodeAACFunctionFiniPointer == nullptr ||
-      DecodeAACFunctionInitPointer == nullptr ||
-      DecodeAACFunctionCallPointer == nullptr) {
-    DecodeAACFunctionFiniPointer = nullptr;
-    DecodeAACFunctionInitPointer = nullptr;
-    DecodeAACFunctionCallPointer = nullptr;
-
-    return nullptr;
+  // dlsym walks every loaded library, so the symbols are only looked up until
+  // found (the FFmpeg library may be loaded later). Resources are initialized
+  // concurrently by the batched decode, hence the lock.
+  static tensorflow::mutex mu(tensorflow::LINKER_INITIALIZED);
+  {
+    tensorflow::mutex_lock l(mu);
+    if (DecodeAACFunctionInitPointer == nullptr) {
+      *(void**)(&DecodeAACFunctionFiniPointer) =
+          dlsym(RTLD_DEFAULT, "DecodeAACFunctionFiniFFmpeg");
+      *(void**)(&DecodeAACFunctionInitPointer) =
+          dlsym(RTLD_DEFAULT, "DecodeAACFunctionInitFFmpeg");
+      *(void**)(&DecodeAACFunctionCallPointer) =
+          dlsym(RTLD_DEFAULT, "DecodeAACFunctionCallFFmpeg");
+      if (DecodeAACFunctionFiniPointer == nullptr ||
+          DecodeAACFunctionInitPointer == nullptr ||
+          DecodeAACFunctionCallPointer == nullptr) {
+        DecodeAACFunctionFiniPointer = nullptr;
+        DecodeAACFunctionInitPointer = nullptr;
+        DecodeAACFunctionCallPointer = nullptr;
+
+        return nullptr;
+      }
+    }
   }
   return DecodeAACFunctionInitPointer(codec, rate, channels);
 }
@@ -425,7 +434,8 @@ class MP4AACReadableResource : public AudioReadableResourceBase {
     if (status != 0) {
       return errors::InvalidArgument("unable to convert AAC data: ", status);
     }
-    char* base = (char*)(value->flat<float>().data());
+    // value may be an unaligned slice of a batch, so skip the aligned flat().
+    char* base = static_cast<char*>(value->data());
     char* data = (char*)&data_out[0] + extra * channels * sizeof(float);
     memcpy(base, data, value->NumElements() * sizeof(float));
     return OkStatus();
@@ -689,6 +699,8 @@ REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeAAC").Device(DEVICE_CPU),
                         AudioDecodeAACOp);
 REGISTER_KERNEL_BUILDER(Name("IO>AudioEncodeAAC").Device(DEVICE_CPU),
                         AudioEncodeAACOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeAACBatch").Device(DEVICE_CPU),
+                        AudioDecodeBatchOp<MP4AACReadableResource>);
 
 }  // namespace
 
@@ -18,10 +18,95 @@ limitations under the License.
 #include "vorbis/vorbisenc.h"
 #include "vorbis/vorbisfile.h"
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace tensorflow {
 namespace data {
 namespace {
 
+// Interleaves `count` samples of the `channels` planes returned by
+// ov_read_float into `output`.
+void InterleaveChannels(float* const* planes, int64 channels, int64 count,
+                        float* output) {
+  if (channels == 1) {
+    memcpy(output, planes[0], count * sizeof(float));
+    return;
+  }
+  int64 i = 0;
+  if (channels == 2) {
+    const float* left = planes[0];
+    const float* right = planes[1];
+#if defined(__SSE__)
+    for (; i + 4 <= count; i += 4) {
+      const __m128 l = _mm_loadu_ps(left + i);
+      const __m128 r = _mm_loadu_ps(right + i);
+      _mm_storeu_ps(output + 2 * i, _mm_unpacklo_ps(l, r));
+      _mm_storeu_ps(output + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= count; i += 4) {
+      float32x4x2_t interleaved = {{vld1q_f32(left + i), vld1q_f32(right + i)}};
+      vst2q_f32(output + 2 * i, interleaved);
+    }
+#endif
+    for (; i < count; i++) {
+      output[2 * i] = left[i];
+      output[2 * i + 1] = right[i];
+    }
+    return;
+  }
+  for (; i < count; i++) {
+    for (int64 c = 0; c < channels; c++) {
+      output[i * channels + c] = planes[c][i];
+    }
+  }
+}
+
+// Ogg page header, see https://xiph.org/ogg/doc/framing.html
+constexpr int64 kOggPageHeaderSize = 27;
+
+// Indexes the pages of a single link Ogg stream by the first sample decoded
+// after them, i.e., the granule position of the page before. Only the page
+// headers are read, page bodies are skipped.
+Status BuildOggSeekIndex(SizedRandomAccessFile* file, int64 size,
+                         AudioSeekIndex* index) {
+  int64 offset = 0;
+  int64 granule = 0;
+  char header[kOggPageHeaderSize + 255];
+  while (offset + kOggPageHeaderSize <= size) {
+    StringPiece result;
+    Status status = file->Read(offset, sizeof(header), &result, header);
+    if (!(status.ok() || errors::IsOutOfRange(status)) ||
+        result.size() < kOggPageHeaderSize || memcmp(header, "OggS", 4) != 0) {
+      return errors::DataLoss("invalid ogg page at ", offset);
+    }
+    const uint8* data = reinterpret_cast<const uint8*>(header);
+    const int64 segments = data[26];
+    if (result.size() < kOggPageHeaderSize + segments) {
+      return errors::DataLoss("truncated ogg page at ", offset);
+    }
+    int64 body = 0;
+    for (int64 i = 0; i < segments; i++) {
+      body += data[kOggPageHeaderSize + i];
+    }
+    int64 page_granule = 0;
+    memcpy(&page_granule, header + 6, sizeof(page_granule));
+    // -1 marks a page on which no packet ends.
+    if (page_granule != -1) {
+      if (page_granule > granule || index->points.empty()) {
+        index->points.push_back({granule, offset});
+      }
+      granule = page_granule;
+    }
+    offset += kOggPageHeaderSize + segments + body;
+  }
+  return OkStatus();
+}
+
 class OggVorbisStream {
  public:
   OggVorbisStream(SizedRandomAccessFile* file, int64 size)
@@ -91,6 +176,8 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
   Status Init(const string& filename, const void* optional_memory,
               const size_t optional_length) override {
     mutex_lock l(mu_);
+    filename_ = filename;
+    memory_ = (optional_memory != nullptr);
     file_.reset(new SizedRandomAccessFile(env_, filename, optional_memory,
                                           optional_length));
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
@@ -136,12 +223,11 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
     TF_RETURN_IF_ERROR(allocate_func(
         TensorShape({sample_stop - sample_start, shape_.dim_size(1)}), &value));
 
-    int returned = ov_pcm_seek(&ogg_vorbis_file_, sample_start);
-    if (returned < 0) {
-      return errors::InvalidArgument("seek failed: ", returned);
-    }
+    TF_RETURN_IF_ERROR(Seek(sample_start));
 
     int64 channels = value->shape().dim_size(1);
+    // value may be an unaligned slice of a batch, so skip the aligned flat().
+    float* output = static_cast<float*>(value->data());
 
     long samples_read = 0;
     long samples_to_read = value->shape().dim_size(0);
@@ -156,11 +242,8 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
       if (chunk == 0) {
         return errors::InvalidArgument("not enough data: ");
       }
-      for (int64 c = 0; c < channels; c++) {
-        for (int64 i = 0; i < chunk; i++) {
-          value->matrix<float>()(samples_read + i, c) = buffer[c][i];
-        }
-      }
+      InterleaveChannels(buffer, channels, chunk,
+                         output + samples_read * channels);
       samples_read += chunk;
     }
 
@@ -169,6 +252,55 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
   string DebugString() const override { return "OggVorbisReadableResource"; }
 
  private:
+  // ov_pcm_seek bisects the file, reading pages until it closes in on the
+  // sample. With a page index (built once per file and shared through
+  // AudioSeekIndexLookup) the page holding the sample is jumped to directly
+  // and the samples before it are decoded and dropped.
+  Status Seek(int64 sample) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (sample > 0 && index_ == nullptr && ov_streams(&ogg_vorbis_file_) == 1) {
+      auto build = [this](AudioSeekIndex* index) -> Status {
+        return BuildOggSeekIndex(file_.get(), file_size_, index);
+      };
+      if (memory_) {
+        std::shared_ptr<AudioSeekIndex> index(new AudioSeekIndex());
+        TF_RETURN_IF_ERROR(build(index.get()));
+        index_ = std::move(index);
+      } else {
+        TF_RETURN_IF_ERROR(AudioSeekIndexLookup(
+            env_, "vorbis", filename_, file_size_, build, &index_));
+      }
+    }
+    const AudioSeekIndex::Point* point =
+        (index_ != nullptr) ? index_->Lookup(sample) : nullptr;
+    if (point != nullptr) {
+      // The first packets after a raw seek only prime the decoder, so start
+      // two pages early to be sure the sample is still ahead.
+      point = &index_->points[std::max<int64>(
+          0, (point - index_->points.data()) - 2)];
+    }
+    if (point != nullptr &&
+        ov_raw_seek(&ogg_vorbis_file_, point->offset) == 0 &&
+        ov_pcm_tell(&ogg_vorbis_file_) <= sample) {
+      float** buffer;
+      for (int64 position = ov_pcm_tell(&ogg_vorbis_file_);
+           position < sample;) {
+        int bitstream = 0;
+        long chunk = ov_read_float(&ogg_vorbis_file_, &buffer,
+                                   sample - position, &bitstream);
+        if (chunk <= 0) {
+          return errors::InvalidArgument("seek failed: ", chunk);
+        }
+        position += chunk;
+      }
+      return OkStatus();
+    }
+    int returned = ov_pcm_seek(&ogg_vorbis_file_, sample);
+    if (returned < 0) {
+      return errors::InvalidArgument("seek failed: ", returned);
+    }
+    return OkStatus();
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
@@ -179,6 +311,10 @@ class OggVorbisReadableResource : public AudioReadableResourceBase {
 
   OggVorbis_File ogg_vorbis_file_;
   std::unique_ptr<OggVorbisStream> stream_;
+
+  string filename_;
+  bool memory_;
+  std::shared_ptr<const AudioSeekIndex> index_;
 };
 
 class AudioDecodeVorbisOp : public OpKernel {
@@ -392,6 +528,8 @@ class AudioEncodeVorbisOp : public OpKernel {
 
 REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeVorbis").Device(DEVICE_CPU),
                         AudioDecodeVorbisOp);
+REGISTER_KERNEL_BUILDER(Name("IO>AudioDecodeVorbisBatch").Device(DEVICE_CPU),
+                        AudioDecodeBatchOp<OggVorbisReadableResource>);
 REGISTER_KERNEL_BUILDER(Name("IO>AudioEncodeVorbis").Device(DEVICE_CPU),
                         AudioEncodeVorbisOp);
 
@@ -13,12 +13,53 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow_io/core/kernels/audio_kernels.h"
 
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace tensorflow {
 namespace data {
 namespace {
 
+// Expands `count` packed little endian int24 samples into int32, with the
+// sample in the upper three bytes (i.e., shifted left by 8).
+void ConvertInt24ToInt32(const char* input, int64 count, int32* output) {
+  int64 i = 0;
+#if defined(__SSSE3__)
+  const __m128i shuffle =
+      _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+  // Every iteration loads 16 bytes but only consumes 12 (4 samples), so stop
+  // while the load still stays inside of the input.
+  for (; i + 6 <= count; i += 4) {
+    __m128i packed =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i),
+                     _mm_shuffle_epi8(packed, shuffle));
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x3_t packed =
+        vld3q_u8(reinterpret_cast<const uint8_t*>(input + i * 3));
+    uint8x16x4_t expanded = {
+        {vdupq_n_u8(0), packed.val[0], packed.val[1], packed.val[2]}};
+    vst4q_u8(reinterpret_cast<uint8_t*>(output + i), expanded);
+  }
+#endif
+  for (; i < count; i++) {
+    const char* in_p = input + i * 3;
+    char* out_p = reinterpret_cast<char*>(output + i);
+    out_p[3] = in_p[2];
+    out_p[2] = in_p[1];
+    out_p[1] = in_p[0];
+    out_p[0] = 0x00;
+  }
+}
+
 // See http://www-mmsp.ece.mcgill.ca/Documents/AudioFormats/WAVE/WAVE.html
 struct WAVHeader {
   char riff[4];           // RIFF Chunk ID: "RIFF"
@@ -81,9 +122,26 @@ class WAVReadableResource : public AudioReadableResourceBase {
   ~WAVReadableResource() {}
 
   Status Init(const string& input, const void* optional_memory,
-              const size_t optional_length) override {
+              size_t optional_length) override {
     mutex_lock l(mu_);
     const string& filename = input;
+    // Local files are memory mapped so that reading a range of samples is a
+    // copy out of the page cache instead of a read syscall per range. Other
+    // file systems do not support it and fall back to random access reads.
+    region_.reset();
+    StringPiece scheme, host, path;
+    io::ParseURI(filename, &scheme, &host, &path);
+    if (optional_memory == nullptr && optional_length == 0 &&
+        (scheme.empty() || scheme == "file")) {
+      std::unique_ptr<ReadOnlyMemoryRegion> region;
+      if (env_->NewReadOnlyMemoryRegionFromFile(filename, &region).ok() &&
+          region->length() > 0) {
+        region_ = std::move(region);
+        optional_memory = region_->data();
+        optional_length = region_->length();
+      }
+    }
+    memory_ = static_cast<const char*>(optional_memory);
     file_.reset(new SizedRandomAccessFile(env_, filename, optional_memory,
                                           optional_length));
     TF_RETURN_IF_ERROR(file_->GetFileSize(&file_size_));
@@ -242,29 +300,39 @@ class WAVReadableResource : public AudioReadableResourceBase {
 
       int64 offset = partitions_offset_[i] + chunk_offset * header_.nBlockAlign;
       int64 length = chunk_length * header_.nBlockAlign;
+      char* output = base + base_offset * channels * DataTypeSize(dtype_);
 
+      // Samples are taken straight from memory (mapped or provided) or read
+      // straight into the output, only int24 needs a staging buffer.
+      const char* data = nullptr;
       string buffer;
-      buffer.resize(length);
-
-      StringPiece result;
-      TF_RETURN_IF_ERROR(file_->Read(offset, length, &result, &buffer[0]));
+      if (memory_ != nullptr) {
+        if (offset + length > file_size_) {
+          return errors::OutOfRange("EOF reached");
+        }
+        data = memory_ + offset;
+      } else {
+        char* scratch = output;
+        if (header_.wBitsPerSample == 24) {
+          buffer.resize(length);
+          scratch = &buffer[0];
+        }
+        StringPiece result;
+        TF_RETURN_IF_ERROR(file_->Read(offset, length, &result, scratch));
+        data = result.data();
+      }
 
       switch (header_.wBitsPerSample) {
         case 8:
         case 16:
         case 32:
-          memcpy(base + base_offset * header_.nBlockAlign, (char*)(&buffer[0]),
-                 chunk_length * header_.nBlockAlign);
+          if (data != output) {
+            memcpy(output, data, length);
+          }
           break;
         case 24:  // 24 stands for int24 (converts to INT32)
-          for (int64 i = 0; i < chunk_length * channels; i++) {
-            char* in_p = (char*)(&buffer[0]) + i * 3;
-            char* out_p = base + base_offset * header_.nBlockAlign + i * 4;
-            out_p[3] = in_p[2];
-            out_p[2] = in_p[1];
-            out_p[1] = in_p[0];
-            out_p[0] = 0x00;
-          }
+          ConvertInt24ToInt32(data, chunk_length * channels,
+                              reinterpret_cast<int32*>(output));
           break;
         default:
           return errors::InvalidArgument(
@@ -282,6 +350,8 @@ class WAVReadableResource : public AudioReadableResourceBase {
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<SizedRandomAccessFile> file_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<ReadOnlyMemoryRegion> region_ TF_GUARDED_BY(mu_);
+  const char* memory_ TF_GUARDED_BY(mu_) = nullptr;
   uint64 file_size_ TF_GUARDED_BY(mu_);
   DataType dtype_;
   TensorShape shape_;
@@ -13,12 +13,17 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <curl/curl.h>
+
+#include <deque>
+
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/tsl/platform/cloud/curl_http_request.h"
 
 using namespace tsl;
@@ -361,10 +366,468 @@ class ElasticsearchReadableNextOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+// Appends the response body of a libcurl transfer to a std::string.
+size_t ElasticsearchWriteCallback(const void* ptr, size_t size, size_t nmemb,
+                                  void* userdata) {
+  std::string* response = static_cast<std::string*>(userdata);
+  response->append(static_cast<const char*>(ptr), size * nmemb);
+  return size * nmemb;
+}
+
+// Looks up a dotted `field` path (e.g. "address.city") in `source`.
+const rapidjson::Value* ElasticsearchFindField(const rapidjson::Value& source,
+                                               const string& field) {
+  const rapidjson::Value* value = &source;
+  for (const auto& part : str_util::Split(field, '.')) {
+    if (!value->IsObject()) {
+      return nullptr;
+    }
+    rapidjson::Value::ConstMemberIterator itr = value->FindMember(part.c_str());
+    if (itr == value->MemberEnd()) {
+      return nullptr;
+    }
+    value = &itr->value;
+  }
+  return value;
+}
+
+Status ElasticsearchDecodeValue(const rapidjson::Value& value,
+                                const string& field, int64 index,
+                                Tensor* tensor) {
+  switch (tensor->dtype()) {
+    case DT_BOOL:
+      if (value.IsBool()) {
+        tensor->flat<bool>()(index) = value.GetBool();
+        return OkStatus();
+      }
+      break;
+    case DT_INT32:
+      if (value.IsInt()) {
+        tensor->flat<int32>()(index) = value.GetInt();
+        return OkStatus();
+      }
+      break;
+    case DT_INT64:
+      if (value.IsInt64()) {
+        tensor->flat<int64>()(index) = value.GetInt64();
+        return OkStatus();
+      }
+      break;
+    case DT_FLOAT:
+      if (value.IsNumber()) {
+        tensor->flat<float>()(index) = static_cast<float>(value.GetDouble());
+        return OkStatus();
+      }
+      break;
+    case DT_DOUBLE:
+      if (value.IsNumber()) {
+        tensor->flat<double>()(index) = value.GetDouble();
+        return OkStatus();
+      }
+      break;
+    case DT_STRING:
+      if (value.IsString()) {
+        tensor->flat<tstring>()(index).assign(value.GetString(),
+                                              value.GetStringLength());
+      } else {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        value.Accept(writer);
+        tensor->flat<tstring>()(index).assign(buffer.GetString(),
+                                              buffer.GetSize());
+      }
+      return OkStatus();
+    default:
+      return errors::InvalidArgument("Unsupported data type for field ",
+                                     field, ": ",
+                                     DataTypeString(tensor->dtype()));
+  }
+  return errors::InvalidArgument("Unable to convert field ", field,
+                                 " with JSON type ", value.GetType(), " to ",
+                                 DataTypeString(tensor->dtype()));
+}
+
+// Reads an index with a sliced scroll. Every slice is an independent scroll
+// context served by its own worker thread and its own libcurl handle, so
+// that the HTTP connection to the node is kept alive between pages. Hits
+// are decoded from `_source` straight into one column tensor per field and
+// the decoded pages are buffered until Next() hands them out.
+class ElasticsearchSlicedResource : public ResourceBase {
+ public:
+  ElasticsearchSlicedResource(Env* env) : env_(env) {}
+  ~ElasticsearchSlicedResource() {
+    {
+      mutex_lock l(mu_);
+      cancelled_ = true;
+      cond_.notify_all();
+    }
+    workers_.clear();
+    for (auto& slice : slices_) {
+      if (!slice->scroll_id.empty()) {
+        // Release the scroll context instead of waiting for it to expire.
+        std::string body = strings::StrCat("{\"scroll_id\":[\"",
+                                           slice->scroll_id, "\"]}");
+        rapidjson::Document response_json;
+        Request(slice->curl, "DELETE", url_ + "/_search/scroll", body,
+                &response_json)
+            .IgnoreError();
+      }
+      curl_easy_cleanup(slice->curl);
+    }
+    curl_slist_free_all(headers_);
+  }
+
+  Status Init(const string& url, const string& path, const string& query,
+              const std::vector<string>& headers,
+              const std::vector<string>& fields, const DataTypeVector& dtypes,
+              const int64 slices, const int64 size, const string& keep_alive,
+              const int64 capacity) {
+    url_ = url;
+    path_ = path;
+    fields_ = fields;
+    dtypes_ = dtypes;
+    keep_alive_ = keep_alive;
+    capacity_ = capacity;
+    if (fields_.size() != dtypes_.size()) {
+      return errors::InvalidArgument("Expected ", fields_.size(),
+                                     " dtypes to match the fields, got ",
+                                     dtypes_.size());
+    }
+
+    for (const auto& header : headers) {
+      // Only split on the first '=' as values (e.g. base64) may contain it.
+      size_t pos = header.find('=');
+      if (pos == std::string::npos) {
+        return errors::InvalidArgument("invalid header configuration: ",
+                                       header);
+      }
+      std::string entry = strings::StrCat(header.substr(0, pos), ": ",
+                                          header.substr(pos + 1));
+      headers_ = curl_slist_append(headers_, entry.c_str());
+    }
+
+    // The search body is the user query with the slice, the page size and
+    // the `_source` filter added, sorted by `_doc` which is the cheapest
+    // order to scroll in.
+    rapidjson::Document body;
+    if (query.empty()) {
+      body.SetObject();
+    } else if (body.Parse(query.c_str()).HasParseError() ||
+               !body.IsObject()) {
+      return errors::InvalidArgument("Invalid JSON query: ", query);
+    }
+    rapidjson::Document::AllocatorType& allocator = body.GetAllocator();
+    body.RemoveMember("size");
+    body.AddMember("size", rapidjson::Value(size), allocator);
+    body.RemoveMember("_source");
+    rapidjson::Value source(rapidjson::kArrayType);
+    for (const auto& field : fields_) {
+      source.PushBack(rapidjson::Value(field.c_str(), allocator), allocator);
+    }
+    body.AddMember("_source", source, allocator);
+    if (!body.HasMember("sort")) {
+      rapidjson::Value sort(rapidjson::kArrayType);
+      sort.PushBack("_doc", allocator);
+      body.AddMember("sort", sort, allocator);
+    }
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    for (int64 i = 0; i < slices; i++) {
+      std::unique_ptr<Slice> slice(new Slice());
+      slice->curl = curl_easy_init();
+      if (slice->curl == nullptr) {
+        return errors::Internal("Failed to initialize the curl handle");
+      }
+      // A single slice is a plain scroll, Elasticsearch rejects max < 2.
+      body.RemoveMember("slice");
+      if (slices > 1) {
+        rapidjson::Value entry(rapidjson::kObjectType);
+        entry.AddMember("id", rapidjson::Value(i), allocator);
+        entry.AddMember("max", rapidjson::Value(slices), allocator);
+        body.AddMember("slice", entry, allocator);
+      }
+      rapidjson::StringBuffer buffer;
+      rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+      body.Accept(writer);
+      slice->body = buffer.GetString();
+      slices_.emplace_back(std::move(slice));
+    }
+    for (size_t i = 0; i < slices_.size(); i++) {
+      Slice* slice = slices_[i].get();
+      workers_.emplace_back(env_->StartThread(
+          ThreadOptions(), strings::StrCat("elasticsearch_slice_", i),
+          [this, slice]() { FetchLoop(slice); }));
+    }
+    return OkStatus();
+  }
+
+  // Returns the next decoded page of any slice, or empty columns once every
+  // slice has been exhausted.
+  Status Next(std::vector<Tensor>* values) {
+    mutex_lock l(mu_);
+    while (true) {
+      TF_RETURN_IF_ERROR(status_);
+      bool done = true;
+      for (size_t i = 0; i < slices_.size(); i++) {
+        Slice* slice = slices_[(next_ + i) % slices_.size()].get();
+        if (!slice->pages.empty()) {
+          *values = std::move(slice->pages.front());
+          slice->pages.pop_front();
+          next_ = (next_ + i + 1) % slices_.size();
+          cond_.notify_all();
+          return OkStatus();
+        }
+        done = done && slice->done;
+      }
+      if (done) {
+        break;
+      }
+      cond_.wait(l);
+    }
+    values->clear();
+    for (size_t i = 0; i < dtypes_.size(); i++) {
+      values->emplace_back(dtypes_[i], TensorShape({0}));
+    }
+    return OkStatus();
+  }
+
+  string DebugString() const override { return "ElasticsearchSlicedResource"; }
+
+ private:
+  struct Slice {
+    CURL* curl = nullptr;
+    std::string body;
+    std::string scroll_id;
+    bool done = false;
+    std::deque<std::vector<Tensor>> pages;
+  };
+
+  void FetchLoop(Slice* slice) {
+    while (true) {
+      {
+        mutex_lock l(mu_);
+        while (!cancelled_ && slice->pages.size() >= capacity_) {
+          cond_.wait(l);
+        }
+        if (cancelled_) {
+          return;
+        }
+      }
+      std::vector<Tensor> page;
+      Status status = Fetch(slice, &page);
+      mutex_lock l(mu_);
+      if (!status.ok()) {
+        status_ = status;
+        slice->done = true;
+      } else if (page[0].NumElements() == 0) {
+        slice->done = true;
+      } else {
+        slice->pages.emplace_back(std::move(page));
+      }
+      cond_.notify_all();
+      if (slice->done) {
+        return;
+      }
+    }
+  }
+
+  Status Fetch(Slice* slice, std::vector<Tensor>* page) {
+    rapidjson::Document response_json;
+    if (slice->scroll_id.empty()) {
+      TF_RETURN_IF_ERROR(Request(
+          slice->curl, "POST",
+          strings::StrCat(url_, "/", path_, "/_search?scroll=", keep_alive_),
+          slice->body, &response_json));
+    } else {
+      std::string body = strings::StrCat("{\"scroll\":\"", keep_alive_,
+                                         "\",\"scroll_id\":\"",
+                                         slice->scroll_id, "\"}");
+      TF_RETURN_IF_ERROR(Request(slice->curl, "POST", url_ + "/_search/scroll",
+                                 body, &response_json));
+    }
+    if (!response_json.HasMember("_scroll_id") ||
+        !response_json.HasMember("hits") ||
+        !response_json["hits"].HasMember("hits")) {
+      return errors::FailedPrecondition("Corrupted response from the server");
+    }
+    slice->scroll_id = response_json["_scroll_id"].GetString();
+
+    const rapidjson::Value& hits = response_json["hits"]["hits"];
+    const int64 rows = static_cast<int64>(hits.Size());
+    page->clear();
+    for (size_t i = 0; i < dtypes_.size(); i++) {
+      page->emplace_back(dtypes_[i], TensorShape({rows}));
+    }
+    for (int64 row = 0; row < rows; row++) {
+      const rapidjson::Value& hit = hits[static_cast<rapidjson::SizeType>(row)];
+      if (!hit.HasMember("_source")) {
+        return errors::InvalidArgument("Hit ", row, " has no _source");
+      }
+      for (size_t i = 0; i < fields_.size(); i++) {
+        const rapidjson::Value* value =
+            ElasticsearchFindField(hit["_source"], fields_[i]);
+        if (value == nullptr || value->IsNull()) {
+          return errors::InvalidArgument("Field ", fields_[i],
+                                         " is missing in hit ", row);
+        }
+        TF_RETURN_IF_ERROR(
+            ElasticsearchDecodeValue(*value, fields_[i], row, &(*page)[i]));
+      }
+    }
+    return OkStatus();
+  }
+
+  Status Request(CURL* curl, const string& method, const string& url,
+                 const string& body, rapidjson::Document* response_json) {
+    std::string response;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers_);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE,
+                     static_cast<long>(body.size()));
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, ElasticsearchWriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    // Let the server compress the pages if curl was built with zlib.
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    const char* ca_bundle = std::getenv("CURL_CA_BUNDLE");
+    if (ca_bundle != nullptr) {
+      curl_easy_setopt(curl, CURLOPT_CAINFO, ca_bundle);
+    }
+
+    CURLcode code = curl_easy_perform(curl);
+    if (code != CURLE_OK) {
+      return errors::Unavailable("Request to ", url,
+                                 " failed: ", curl_easy_strerror(code));
+    }
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    if (response_code >= 400) {
+      return errors::FailedPrecondition("Request to ", url, " returned ",
+                                        response_code, ": ", response);
+    }
+    if (response_json->Parse(response.c_str()).HasParseError() ||
+        !response_json->IsObject()) {
+      return errors::InvalidArgument(
+          "Unable to convert the response body to JSON");
+    }
+    return OkStatus();
+  }
+
+  mutable mutex mu_;
+  condition_variable cond_;
+  Env* env_;
+  string url_;
+  string path_;
+  string keep_alive_;
+  size_t capacity_ = 2;
+  std::vector<string> fields_;
+  DataTypeVector dtypes_;
+  struct curl_slist* headers_ = nullptr;
+  std::vector<std::unique_ptr<Slice>> slices_;
+  std::vector<std::unique_ptr<Thread>> workers_;
+  size_t next_ TF_GUARDED_BY(mu_) = 0;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+};
+
+class ElasticsearchSlicedInitOp
+    : public ResourceOpKernel<ElasticsearchSlicedResource> {
+ public:
+  explicit ElasticsearchSlicedInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<ElasticsearchSlicedResource>(context) {
+    env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("fields", &fields_));
+    OP_REQUIRES_OK(context, context->GetAttr("dtypes", &dtypes_));
+    OP_REQUIRES_OK(context, context->GetAttr("slices", &slices_));
+    OP_REQUIRES_OK(context, context->GetAttr("size", &size_));
+    OP_REQUIRES_OK(context, context->GetAttr("keep_alive", &keep_alive_));
+    OP_REQUIRES_OK(context, context->GetAttr("capacity", &capacity_));
+    OP_REQUIRES(context, slices_ > 0,
+                errors::InvalidArgument("slices must be positive, got ",
+                                        slices_));
+    OP_REQUIRES(context, capacity_ > 0,
+                errors::InvalidArgument("capacity must be positive, got ",
+                                        capacity_));
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<ElasticsearchSlicedResource>::Compute(context);
+
+    const Tensor* url_tensor;
+    OP_REQUIRES_OK(context, context->input("url", &url_tensor));
+    const string& url = url_tensor->scalar<tstring>()();
+
+    const Tensor* path_tensor;
+    OP_REQUIRES_OK(context, context->input("path", &path_tensor));
+    const string& path = path_tensor->scalar<tstring>()();
+
+    const Tensor* query_tensor;
+    OP_REQUIRES_OK(context, context->input("query", &query_tensor));
+    const string& query = query_tensor->scalar<tstring>()();
+
+    const Tensor* headers_tensor;
+    OP_REQUIRES_OK(context, context->input("headers", &headers_tensor));
+    std::vector<string> headers;
+    for (int64 i = 0; i < headers_tensor->NumElements(); i++) {
+      headers.push_back(headers_tensor->flat<tstring>()(i));
+    }
+
+    OP_REQUIRES_OK(context,
+                   resource_->Init(url, path, query, headers, fields_, dtypes_,
+                                   slices_, size_, keep_alive_, capacity_));
+  }
+
+  Status CreateResource(ElasticsearchSlicedResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new ElasticsearchSlicedResource(env_);
+    return OkStatus();
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  std::vector<string> fields_;
+  DataTypeVector dtypes_;
+  int64 slices_;
+  int64 size_;
+  string keep_alive_;
+  int64 capacity_;
+};
+
+class ElasticsearchSlicedNextOp : public OpKernel {
+ public:
+  explicit ElasticsearchSlicedNextOp(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    ElasticsearchSlicedResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "resource", &resource));
+    core::ScopedUnref unref(resource);
+
+    std::vector<Tensor> values;
+    OP_REQUIRES_OK(context, resource->Next(&values));
+    OP_REQUIRES(context, values.size() == context->num_outputs(),
+                errors::InvalidArgument("Expected ", context->num_outputs(),
+                                        " columns, got ", values.size()));
+    for (size_t i = 0; i < values.size(); i++) {
+      context->set_output(i, values[i]);
+    }
+  }
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>ElasticsearchReadableInit").Device(DEVICE_CPU),
                         ElasticsearchReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>ElasticsearchReadableNext").Device(DEVICE_CPU),
                         ElasticsearchReadableNextOp);
+REGISTER_KERNEL_BUILDER(Name("IO>ElasticsearchSlicedInit").Device(DEVICE_CPU),
+                        ElasticsearchSlicedInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>ElasticsearchSlicedNext").Device(DEVICE_CPU),
+                        ElasticsearchSlicedNextOp);
 
 }  // namespace
 }  // namespace io
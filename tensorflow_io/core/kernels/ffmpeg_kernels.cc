@@ -16,6 +16,7 @@ limitations under the License.
 #include <deque>
 
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "tensorflow_io/core/kernels/io_interface.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 
@@ -180,7 +181,8 @@ class FFmpegStream {
     }
     return OkStatus();
   }
-  Status OpenCodec(int64 thread_count, int64 thread_type) {
+  Status OpenCodec(int64 thread_count, int64 thread_type,
+                   bool refcounted_frames = false) {
     int64 stream_index = stream_index_;
 
 #if LIBAVCODEC_VERSION_MAJOR > 56
@@ -213,6 +215,7 @@ class FFmpegStream {
 #endif
     codec_context_->thread_count = (int)thread_count;
     codec_context_->thread_type = (int)thread_type;
+    codec_context_->refcounted_frames = refcounted_frames ? 1 : 0;
     {
       // avcodec_open2 is not thread-safe
       mutex_lock lock(mu);
@@ -649,6 +652,180 @@ class FFmpegVideoStream : public FFmpegStream {
 
     return OkStatus();
   }
+  // Opens the stream for ReadRange. Decoded frames are reference counted so
+  // they can be kept past the next decode call, and frame and slice threading
+  // are both enabled with `thread_count` threads (0 picks one per core).
+  Status OpenVideoRange(int64 index, int64 thread_count) {
+    TF_RETURN_IF_ERROR(Open(AVMEDIA_TYPE_VIDEO, index));
+    TF_RETURN_IF_ERROR(OpenCodec(
+        thread_count, FF_THREAD_FRAME | FF_THREAD_SLICE, true));
+
+    dtype_ = DT_UINT8;
+    height_ = codec_context_->height;
+    width_ = codec_context_->width;
+    channels_ = 3;
+    return OkStatus();
+  }
+  // Decodes the frames presented within [start, stop), in seconds or in
+  // frames with `frame_unit`, keeping every `stride`-th one. A negative
+  // `stop` reads to the end. Decoding starts from the keyframe before
+  // `start` so only the GOPs overlapping the range are read, and the kept
+  // frames are converted to RGB in parallel, scaled to `height` x `width`
+  // when those are positive.
+  Status ReadRange(double start, double stop, bool frame_unit, int64 stride,
+                   int64 height, int64 width,
+                   const DeviceBase::CpuWorkerThreads* worker_threads,
+                   std::function<Status(const TensorShape& shape,
+                                        Tensor** value)>
+                       allocate_func) {
+    AVStream* stream = format_context_->streams[stream_index_];
+    const int64 start_time =
+        (stream->start_time == AV_NOPTS_VALUE) ? 0 : stream->start_time;
+    const AVRational frame_rate =
+        av_guess_frame_rate(format_context_.get(), stream, NULL);
+    if (frame_unit) {
+      if (frame_rate.num <= 0 || frame_rate.den <= 0) {
+        return errors::InvalidArgument(
+            "unable to read a frame range of ", filename_,
+            " with unknown frame rate, read a time range instead");
+      }
+      start = start / av_q2d(frame_rate);
+      stop = (stop < 0) ? stop : stop / av_q2d(frame_rate);
+    }
+    // Containers round timestamps, allow half a frame so that a boundary
+    // selects the frame presented at it.
+    const double slack = (frame_rate.num > 0 && frame_rate.den > 0)
+                             ? 0.5 / av_q2d(frame_rate)
+                             : 0.0;
+
+    const int64 target =
+        start_time +
+        av_rescale_q(static_cast<int64>(std::max(0.0, start - slack) *
+                                        AV_TIME_BASE),
+                     AV_TIME_BASE_Q, stream->time_base);
+    if (av_seek_frame(format_context_.get(), stream_index_, target,
+                      AVSEEK_FLAG_BACKWARD) < 0) {
+      return errors::InvalidArgument("unable to seek to ", start, "s in ",
+                                     filename_);
+    }
+    avcodec_flush_buffers(codec_context_);
+
+    typedef std::unique_ptr<AVFrame, void (*)(AVFrame*)> FramePtr;
+    std::vector<FramePtr> frames;
+    int64 selected = 0;
+    bool done = false;
+    auto select = [&](FramePtr frame) -> Status {
+      int64 pts = av_frame_get_best_effort_timestamp(frame.get());
+      if (pts == AV_NOPTS_VALUE) {
+        pts = frame->pkt_dts;
+      }
+      if (pts == AV_NOPTS_VALUE) {
+        return errors::InvalidArgument("video frame without timestamp in ",
+                                       filename_);
+      }
+      const double time = (pts - start_time) * av_q2d(stream->time_base);
+      if (time < start - slack) {
+        return OkStatus();
+      }
+      if (stop >= 0 && time >= stop - slack) {
+        done = true;
+        return OkStatus();
+      }
+      if (selected % stride == 0) {
+        frames.push_back(std::move(frame));
+      }
+      selected++;
+      return OkStatus();
+    };
+    auto decode = [&](AVPacket* packet, int* got_frame) -> Status {
+      FramePtr frame(av_frame_alloc(), [](AVFrame* p) {
+        if (p != nullptr) {
+          av_frame_free(&p);
+        }
+      });
+      int decoded =
+          avcodec_decode_video2(codec_context_, frame.get(), got_frame, packet);
+      if (decoded < 0) {
+        return errors::InvalidArgument("error decoding video frame (",
+                                       decoded, ")");
+      }
+      decoded = FFMIN(decoded, packet->size);
+      packet->data += decoded;
+      packet->size -= decoded;
+      if (*got_frame) {
+        TF_RETURN_IF_ERROR(select(std::move(frame)));
+      }
+      return OkStatus();
+    };
+
+    AVPacket packet;
+    av_init_packet(&packet);
+    packet.data = NULL;
+    packet.size = 0;
+    while (!done) {
+      if (av_read_frame(format_context_.get(), &packet) < 0) {
+        // Drain the frames still buffered by the decoder threads.
+        AVPacket flush;
+        av_init_packet(&flush);
+        flush.data = NULL;
+        flush.size = 0;
+        int got_frame = 1;
+        while (got_frame && !done) {
+          TF_RETURN_IF_ERROR(decode(&flush, &got_frame));
+        }
+        break;
+      }
+      Status status;
+      if (packet.stream_index == stream_index_) {
+        AVPacket remaining = packet;
+        while (remaining.size > 0 && !done && status.ok()) {
+          int got_frame;
+          status = decode(&remaining, &got_frame);
+        }
+      }
+      av_packet_unref(&packet);
+      TF_RETURN_IF_ERROR(status);
+    }
+
+    const int64 frame_height = (height > 0) ? height : height_;
+    const int64 frame_width = (width > 0) ? width : width_;
+    const int64 frame_bytes = frame_height * frame_width * channels_;
+    Tensor* value;
+    TF_RETURN_IF_ERROR(allocate_func(
+        TensorShape({static_cast<int64>(frames.size()), frame_height,
+                     frame_width, channels_}),
+        &value));
+    uint8* base = value->flat<uint8>().data();
+
+    // SwsContext is not thread-safe, every shard converts with its own.
+    std::vector<Status> status(frames.size());
+    Shard(worker_threads->num_threads, worker_threads->workers, frames.size(),
+          frame_bytes * 16, [&](int64 first, int64 limit) {
+            SwsContext* sws_context = nullptr;
+            for (int64 i = first; i < limit; i++) {
+              const AVFrame* frame = frames[i].get();
+              sws_context = sws_getCachedContext(
+                  sws_context, frame->width, frame->height,
+                  static_cast<AVPixelFormat>(frame->format), frame_width,
+                  frame_height, AV_PIX_FMT_RGB24, SWS_BILINEAR, NULL, NULL,
+                  NULL);
+              if (!sws_context) {
+                status[i] = errors::Internal("could not allocate sws context");
+                continue;
+              }
+              uint8_t* data[4] = {base + i * frame_bytes, NULL, NULL, NULL};
+              int linesize[4] = {static_cast<int>(frame_width * channels_), 0,
+                                 0, 0};
+              sws_scale(sws_context, frame->data, frame->linesize, 0,
+                        frame->height, data, linesize);
+            }
+            sws_freeContext(sws_context);
+          });
+    for (const auto& s : status) {
+      TF_RETURN_IF_ERROR(s);
+    }
+    return OkStatus();
+  }
   Status Peek(int64* frames) {
     *frames = 0;
     while (*frames == 0) {
@@ -804,6 +981,24 @@ class FFmpegVideoReadableResource : public ResourceBase {
     return OkStatus();
   }
   Status Read(Tensor* value) { return ffmpeg_video_stream_->Read(value); }
+  // Range reads seek, so they use a stream of their own and leave the
+  // sequential position of Peek/Read untouched.
+  Status ReadRange(double start, double stop, bool frame_unit, int64 stride,
+                   int64 height, int64 width, int64 threads,
+                   const DeviceBase::CpuWorkerThreads* worker_threads,
+                   std::function<Status(const TensorShape& shape,
+                                        Tensor** value)>
+                       allocate_func) {
+    mutex_lock l(mu_);
+    if (range_stream_ == nullptr) {
+      std::unique_ptr<FFmpegVideoStream> stream(
+          new FFmpegVideoStream(filename_, file_.get(), file_size_));
+      TF_RETURN_IF_ERROR(stream->OpenVideoRange(video_index_, threads));
+      range_stream_ = std::move(stream);
+    }
+    return range_stream_->ReadRange(start, stop, frame_unit, stride, height,
+                                    width, worker_threads, allocate_func);
+  }
   string DebugString() const override { return "FFmpegVideoReadableResource"; }
 
  private:
@@ -815,6 +1010,7 @@ class FFmpegVideoReadableResource : public ResourceBase {
   uint64 file_size_ TF_GUARDED_BY(mu_);
   std::unique_ptr<FFmpegVideoStream> ffmpeg_video_stream_ TF_GUARDED_BY(mu_);
   int64 frame_index_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<FFmpegVideoStream> range_stream_ TF_GUARDED_BY(mu_);
 };
 
 class FFmpegVideoReadableInitOp
@@ -884,6 +1080,72 @@ class FFmpegVideoReadableNextOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+class FFmpegVideoReadableReadOp : public OpKernel {
+ public:
+  explicit FFmpegVideoReadableReadOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+    string unit;
+    OP_REQUIRES_OK(context, context->GetAttr("unit", &unit));
+    frame_unit_ = (unit == "frame");
+    OP_REQUIRES_OK(context, context->GetAttr("threads", &threads_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    FFmpegVideoReadableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* start_tensor;
+    OP_REQUIRES_OK(context, context->input("start", &start_tensor));
+    const double start = start_tensor->scalar<double>()();
+
+    const Tensor* stop_tensor;
+    OP_REQUIRES_OK(context, context->input("stop", &stop_tensor));
+    const double stop = stop_tensor->scalar<double>()();
+
+    const Tensor* stride_tensor;
+    OP_REQUIRES_OK(context, context->input("stride", &stride_tensor));
+    const int64 stride = stride_tensor->scalar<int64>()();
+    OP_REQUIRES(context, stride > 0,
+                errors::InvalidArgument("stride must be positive, got ",
+                                        stride));
+
+    const Tensor* size_tensor;
+    OP_REQUIRES_OK(context, context->input("size", &size_tensor));
+    OP_REQUIRES(context,
+                size_tensor->NumElements() == 0 ||
+                    size_tensor->NumElements() == 2,
+                errors::InvalidArgument(
+                    "size must be empty or [height, width], got ",
+                    size_tensor->shape().DebugString()));
+    int64 height = 0, width = 0;
+    if (size_tensor->NumElements() == 2) {
+      height = size_tensor->flat<int64>()(0);
+      width = size_tensor->flat<int64>()(1);
+      OP_REQUIRES(context, height > 0 && width > 0,
+                  errors::InvalidArgument("size must be positive, got [",
+                                          height, ", ", width, "]"));
+    }
+
+    OP_REQUIRES_OK(
+        context,
+        resource->ReadRange(
+            start, stop, frame_unit_, stride, height, width, threads_,
+            context->device()->tensorflow_cpu_worker_threads(),
+            [&](const TensorShape& shape, Tensor** value) -> Status {
+              return context->allocate_output(0, shape, value);
+            }));
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+  bool frame_unit_;
+  int64 threads_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>FfmpegAudioReadableInit").Device(DEVICE_CPU),
                         FFmpegAudioReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>FfmpegAudioReadableNext").Device(DEVICE_CPU),
@@ -893,6 +1155,8 @@ REGISTER_KERNEL_BUILDER(Name("IO>FfmpegVideoReadableInit").Device(DEVICE_CPU),
                         FFmpegVideoReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>FfmpegVideoReadableNext").Device(DEVICE_CPU),
                         FFmpegVideoReadableNextOp);
+REGISTER_KERNEL_BUILDER(Name("IO>FfmpegVideoReadableRead").Device(DEVICE_CPU),
+                        FFmpegVideoReadableReadOp);
 
 class FFmpegDecodeVideoOp : public OpKernel {
  public:
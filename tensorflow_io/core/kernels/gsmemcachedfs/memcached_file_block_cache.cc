@@ -18,6 +18,7 @@ limitations under the License.
 #include <random>
 
 #include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/platform/fingerprint.h"
 
 namespace tensorflow {
@@ -264,15 +265,15 @@ Status block_set(MemcachedDaoInterface* memcached_dao, const string& key,
                           memcached_dao->MemcachedStrError(rc));
 }
 
-Status read_with_multi_get(
-    const BufferCollator& collator, MemcachedDaoInterface* memcached_dao,
-    const std::vector<string>& keys,
-    std::map<string, MemcachedFileBlockCache::Key>* claim_checks,
-    size_t* total_bytes_transferred,
-    tsl::FileBlockCacheStatsInterface* cache_stats) {
-  VLOG(2) << "Key multi-get of " << claim_checks->size() << " claims";
+// Issues a single multi-get for `keys` and moves every block returned by
+// memcached into `blocks`, keyed by memcached key. Keys that are missing from
+// `blocks` afterwards were cache misses.
+Status read_with_multi_get(MemcachedDaoInterface* memcached_dao,
+                           const std::vector<string>& keys,
+                           std::map<string, std::vector<char>>* blocks,
+                           tsl::FileBlockCacheStatsInterface* cache_stats) {
+  VLOG(2) << "Key multi-get of " << keys.size() << " claims";
   const auto before = absl::Now();
-  auto to_claim = claim_checks->size();
 
   Status mget_status = block_multi_get(memcached_dao, keys);
   TF_RETURN_IF_ERROR(mget_status);
@@ -311,24 +312,14 @@ Status read_with_multi_get(
     }
 
     const string claim_key = key_value;
-    auto claim = claim_checks->find(claim_key);
-    if (claim == claim_checks->end()) {
-      return errors::Internal("Could not find claim for ", claim_key);
-    }
-
-    const size_t pos = claim->second.second;
-    VLOG(2) << "memc fetch of " << claim->first << " -> " << '('
-            << claim->second.first << ", " << claim->second.second << ')';
+    VLOG(2) << "memc fetch of " << claim_key;
     StreamzRecordCacheHitBlockSize(data_size, cache_stats);
-
-    claim_checks->erase(claim);
-    collator.splice_buffer(data_begin, data_begin + data_size, pos,
-                           total_bytes_transferred);
+    (*blocks)[claim_key].assign(data_begin, data_begin + data_size);
   }
 
   const auto after = absl::Now();
-  VLOG(2) << (to_claim - claim_checks->size())
-          << " multi-get fetches claimed in " << (after - before);
+  VLOG(2) << blocks->size() << " multi-get fetches claimed in "
+          << (after - before);
   return OkStatus();
 }
 
@@ -350,10 +341,12 @@ MemcachedFileBlockCache::MemcachedFileBlockCache(
     const std::vector<MemcachedDaoInterface*>& memcached_daos,
     size_t block_size, size_t max_bytes, uint64 max_staleness,
     size_t local_cache_size, const std::vector<string>& servers,
-    const std::vector<string>& options, BlockFetcher block_fetcher, Env* env)
+    const std::vector<string>& options, BlockFetcher block_fetcher,
+    size_t read_ahead_blocks, size_t fetch_threads, Env* env)
     : block_size_(block_size),
       max_bytes_(max_bytes),
-      use_multi_get_(false),
+      use_multi_get_(true),
+      read_ahead_blocks_(read_ahead_blocks),
       block_fetcher_(std::move(block_fetcher)),
       env_(env),
       servers_(servers),
@@ -402,10 +395,19 @@ MemcachedFileBlockCache::MemcachedFileBlockCache(
   VLOG(1) << "MemcachedFileBlockCache has a local small reads cache of "
           << local_cache_size << " bytes.";
 
+  if (fetch_threads > 0) {
+    fetch_pool_ = absl::make_unique<thread::ThreadPool>(
+        env, "memcached_fetch", fetch_threads);
+  }
+  VLOG(1) << "MemcachedFileBlockCache reads ahead " << read_ahead_blocks_
+          << " blocks with " << fetch_threads << " fetch threads.";
+
   VLOG(1) << "Departing MemcachedFileBlockCache::MemcachedFileBlockCache";
 }
 
 MemcachedFileBlockCache::~MemcachedFileBlockCache() {
+  // Wait for pending prefetches before tearing down the setter thread.
+  fetch_pool_.reset();
   {
     mutex_lock lock(throttler_mu_);
     stop_setter_thread_ = true;
@@ -459,6 +461,13 @@ Status MemcachedFileBlockCache::ConfigureMemcachedServers(
     VLOG(1) << "Turned on use of multi-get (mget)";
   }
 
+  opt = unused_opts.find("NO_MGET");
+  if (opt != unused_opts.end()) {
+    unused_opts.erase(opt);
+    use_multi_get_ = false;
+    VLOG(1) << "Turned off use of multi-get (mget)";
+  }
+
   opt = unused_opts.find("NO_BLOCK");
   if (opt != unused_opts.end()) {
     unused_opts.erase(opt);
@@ -546,18 +555,11 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
   auto start_time = absl::Now();
   BufferCollator collator(offset, n, buffer, block_size_);
   collator.prepare_collation();
-  std::vector<string> keys;
-  std::map<string, Key> claim_checks;
-  for (const auto pos : collator.positions()) {
-    const Key key = std::make_pair(filename, pos);
-    const string memc_key = MakeMemcachedKey(key);
-    keys.push_back(memc_key);
-    claim_checks.insert(std::make_pair(memc_key, key));
-  }
+  const std::vector<size_t>& positions = collator.positions();
 
-  string mini_read_key = keys[0];
   bool mini_read = n < block_size_;
-
+  string mini_read_key;
+  bool mini_read_fetching = false;
   if (mini_read) {
     // Small reads get cached locally since we need to fetch an entire block
     // remotely from either GCS or the distributed cache.
@@ -567,17 +569,45 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
     int64 offset_in_block = offset - block_offset;
     if (!local_cache_->Peek(mini_read_key)) {
       local_cache_->Fetching(mini_read_key);
+      mini_read_fetching = true;
     }
     if (local_cache_->Get(mini_read_key, offset_in_block, n, buffer,
                           bytes_transferred)) {
+      if (mini_read_fetching) {
+        local_cache_->Fetched(mini_read_key);
+      }
       return OkStatus();
     }
   }
+  auto fetched = gtl::MakeCleanup([&] {
+    if (mini_read_fetching) {
+      local_cache_->Fetched(mini_read_key);
+    }
+  });
+
+  // The blocks of the read come first, followed by the read-ahead window.
+  // Blocks already in the local cache are served from there, all the others
+  // are requested from memcached with a single multi-get round trip.
+  const size_t read_blocks = positions.size();
+  std::vector<size_t> block_positions(positions);
+  for (size_t i = 1; i <= read_ahead_blocks_; ++i) {
+    block_positions.push_back(positions.back() + i * block_size_);
+  }
+  std::vector<string> keys(block_positions.size());
+  std::vector<std::vector<char>> blocks(block_positions.size());
+  std::vector<bool> found(block_positions.size(), false);
+  std::vector<string> mget_keys;
+  for (size_t i = 0; i < block_positions.size(); ++i) {
+    keys[i] = MakeMemcachedKey(std::make_pair(filename, block_positions[i]));
+    found[i] = (i < read_blocks) ? local_cache_->Lookup(keys[i], &blocks[i])
+                                 : local_cache_->Peek(keys[i]);
+    if (!found[i]) {
+      mget_keys.push_back(keys[i]);
+    }
+  }
 
-  size_t total_bytes_transferred = 0;
-  bool multi_get = use_multi_get_ && !mini_read;
-
-  if (multi_get) {
+  bool multi_get = false;
+  if (use_multi_get_ && !mget_keys.empty()) {
     int64 client_index = 0;
     {
       mutex_lock lock(get_mu_);
@@ -592,55 +622,75 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
     }
 
     if (client_index > 0) {
+      std::map<string, std::vector<char>> mget_blocks;
       auto before = absl::Now();
-      Status mget_status = read_with_multi_get(
-          collator, memcached_clients_[client_index], keys, &claim_checks,
-          &total_bytes_transferred, cache_stats_);
+      Status mget_status =
+          read_with_multi_get(memcached_clients_[client_index], mget_keys,
+                              &mget_blocks, cache_stats_);
       auto after = absl::Now();
       VLOG(2) << "memc mget: " << (after - before) << ", status "
               << mget_status;
-      mutex_lock lock(get_mu_);
-      client_queue_.push_back(client_index);
+      {
+        mutex_lock lock(get_mu_);
+        client_queue_.push_back(client_index);
+      }
+      multi_get = mget_status.ok();
+
+      for (size_t i = 0; i < block_positions.size(); ++i) {
+        auto lookup = mget_blocks.find(keys[i]);
+        if (found[i] || lookup == mget_blocks.end()) {
+          continue;
+        }
+        found[i] = true;
+        if (mini_read || i >= read_blocks) {
+          local_cache_->Add(keys[i], lookup->second.size(),
+                            lookup->second.data());
+        }
+        if (i < read_blocks) {
+          blocks[i] = std::move(lookup->second);
+        }
+      }
     }
   }
 
-  // At this point, any claims remaining in claim_checks were not retrievable
-  // via multi-get, meaning that they were cache misses.  Each of these should
-  // be retried serially, dispatching GCS fetches and setting blocks in the
-  // cache.
-  VLOG(2) << "Serial fetch of " << claim_checks.size() << " claims";
-  // When the cache is completely cold for this region of the GCS file, every
-  // one of the requests will be a miss. Filling these requests in random
-  // offset order is likely less efficient for GCS than filling them in
-  // sequence.  Order the claims by offset.
-  std::map<size_t, Key> sorted_claims;
-  for (auto ci = claim_checks.begin(); ci != claim_checks.end(); ++ci) {
-    sorted_claims.insert(std::make_pair(ci->second.second, ci->second));
+  // At this point, any block of the read that was not found is a miss for
+  // the multi-get (or multi-get was not possible). Misses are filled from the
+  // backing filesystem concurrently, going through memcached get first only
+  // if multi-get was not performed.
+  std::vector<size_t> missing;
+  for (size_t i = 0; i < read_blocks; ++i) {
+    if (!found[i]) {
+      missing.push_back(i);
+    }
   }
-  for (auto sc = sorted_claims.begin(); sc != sorted_claims.end(); ++sc) {
-    size_t pos = sc->first;
-    std::vector<char> data;
-
-    int64 client_index = 0;
-    if (!multi_get) {
-      mutex_lock lock(get_mu_);
-      // Get a client ticket from the pool if available.
-      if (!client_queue_.empty()) {
-        client_index = client_queue_.front();
-        client_queue_.pop_front();
-      } else {
-        LOG(WARNING) << "Memcached client pool is oversaturated. Read will "
-                        "skip the block cache.";
+  VLOG(2) << "Concurrent fetch of " << missing.size() << " claims";
+  std::vector<Status> block_status(read_blocks);
+  if (!missing.empty()) {
+    std::vector<size_t> missing_positions;
+    for (size_t i : missing) {
+      missing_positions.push_back(block_positions[i]);
+    }
+    std::vector<std::vector<char>> missing_blocks;
+    std::vector<Status> missing_status;
+    FetchBlocks(filename, missing_positions, !multi_get, &missing_blocks,
+                &missing_status);
+    for (size_t j = 0; j < missing.size(); ++j) {
+      const size_t i = missing[j];
+      blocks[i] = std::move(missing_blocks[j]);
+      block_status[i] = missing_status[j];
+      if (mini_read && block_status[i].ok()) {
+        // Add the fetched block to the local cache when serving small read.
+        local_cache_->Add(keys[i], blocks[i].size(), blocks[i].data());
       }
     }
+  }
 
-    TF_RETURN_IF_ERROR(MaybeFetch(client_index, sc->second, &data));
-
-    if (client_index > 0) {
-      mutex_lock lock(get_mu_);
-      // Put client ticket back in the pool.
-      client_queue_.push_back(client_index);
-    }
+  size_t total_bytes_transferred = 0;
+  bool eof = false;
+  for (size_t i = 0; i < read_blocks; ++i) {
+    size_t pos = block_positions[i];
+    TF_RETURN_IF_ERROR(block_status[i]);
+    const std::vector<char>& data = blocks[i];
 
     // Copy the relevant portion of the block into the result buffer.
     if (offset >= pos + data.size()) {
@@ -654,17 +704,25 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
                                 data.size());
     }
 
-    if (mini_read) {
-      // Add the fetched block to the local cache when serving small read.
-      local_cache_->Add(mini_read_key, data.size(), data.data());
-      local_cache_->Fetched(mini_read_key);
-    }
-
     if (!collator.splice_buffer(data.begin(), data.end(), pos,
                                 &total_bytes_transferred)) {
+      eof = true;
       break;
     }
   }
+
+  // Read-ahead blocks that missed memcached are fetched in the background,
+  // unless the read already reached the end of the file.
+  if (multi_get && !eof) {
+    std::vector<size_t> prefetch_positions;
+    for (size_t i = read_blocks; i < block_positions.size(); ++i) {
+      if (!found[i]) {
+        prefetch_positions.push_back(block_positions[i]);
+      }
+    }
+    PrefetchBlocks(filename, prefetch_positions);
+  }
+
   auto finish_time = absl::Now();
   auto elapsed = finish_time - start_time;
   VLOG(2) << "total_bytes_transferred out " << total_bytes_transferred
@@ -675,6 +733,82 @@ Status MemcachedFileBlockCache::Read(const string& filename, size_t offset,
   return OkStatus();
 }
 
+void MemcachedFileBlockCache::FetchBlocks(
+    const string& filename, const std::vector<size_t>& positions,
+    bool use_memcached, std::vector<std::vector<char>>* blocks,
+    std::vector<Status>* status) {
+  blocks->resize(positions.size());
+  status->resize(positions.size());
+  auto fetch = [&](size_t i) {
+    int64 client_index = 0;
+    if (use_memcached) {
+      mutex_lock lock(get_mu_);
+      // Get a client ticket from the pool if available.
+      if (!client_queue_.empty()) {
+        client_index = client_queue_.front();
+        client_queue_.pop_front();
+      } else {
+        LOG(WARNING) << "Memcached client pool is oversaturated. Read will "
+                        "skip the block cache.";
+      }
+    }
+
+    (*status)[i] = MaybeFetch(client_index,
+                              std::make_pair(filename, positions[i]),
+                              &(*blocks)[i]);
+
+    if (client_index > 0) {
+      mutex_lock lock(get_mu_);
+      // Put client ticket back in the pool.
+      client_queue_.push_back(client_index);
+    }
+  };
+
+  if (fetch_pool_ == nullptr || positions.size() < 2) {
+    for (size_t i = 0; i < positions.size(); ++i) {
+      fetch(i);
+    }
+    return;
+  }
+  BlockingCounter counter(positions.size() - 1);
+  for (size_t i = 1; i < positions.size(); ++i) {
+    fetch_pool_->Schedule([&fetch, &counter, i] {
+      fetch(i);
+      counter.DecrementCount();
+    });
+  }
+  fetch(0);
+  counter.Wait();
+}
+
+void MemcachedFileBlockCache::PrefetchBlocks(
+    const string& filename, const std::vector<size_t>& positions) {
+  if (fetch_pool_ == nullptr) {
+    return;
+  }
+  for (size_t pos : positions) {
+    const Key key = std::make_pair(filename, pos);
+    const string memc_key = MakeMemcachedKey(key);
+    {
+      mutex_lock lock(prefetch_mu_);
+      if (!prefetching_.insert(memc_key).second) {
+        continue;
+      }
+    }
+    fetch_pool_->Schedule([this, key, memc_key] {
+      std::vector<char> data;
+      Status status = MaybeFetch(0, key, &data);
+      VLOG(2) << "prefetch: " << memc_key << ", status " << status
+              << ", size = " << data.size();
+      if (status.ok() && !data.empty()) {
+        local_cache_->Add(memc_key, data.size(), data.data());
+      }
+      mutex_lock lock(prefetch_mu_);
+      prefetching_.erase(memc_key);
+    });
+  }
+}
+
 string MemcachedFileBlockCache::MakeMemcachedKey(const Key& key) {
   // Determine hash key usable by memcached.  This will need to be a
   // string <= 250 characters.  Using a key which is the offset, a slash,
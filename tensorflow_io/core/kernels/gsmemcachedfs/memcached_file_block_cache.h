@@ -16,92 +16,133 @@ limitations under the License.
 #ifndef TENSORFLOW_IO_GSMEMCACHEDFS_MEMCACHED_FILE_BLOCK_CACHE_H_
 #define TENSORFLOW_IO_GSMEMCACHEDFS_MEMCACHED_FILE_BLOCK_CACHE_H_
 
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
 #include <memory>
-#include <queue>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/tsl/platform/cloud/ram_file_block_cache.h"
 #include "tensorflow_io/core/kernels/gsmemcachedfs/memcached_dao_interface.h"
 
 namespace tensorflow {
 
+// Local LRU cache of blocks keyed by memcached key. The cache is split into
+// shards, each with its own lock and an equal share of the capacity, so that
+// concurrent readers of different blocks do not contend on a single mutex.
 class MiniBlockCache {
  public:
-  explicit MiniBlockCache(size_t max_size) : max_size_(max_size) {
-    VLOG(1) << "MiniBlockCache max_size = " << max_size_;
+  explicit MiniBlockCache(size_t max_size, size_t shard_count = 16)
+      : max_size_(max_size) {
+    VLOG(1) << "MiniBlockCache max_size = " << max_size_
+            << ", shard_count = " << shard_count;
+    for (size_t i = 0; i < std::max<size_t>(shard_count, 1); ++i) {
+      shards_.emplace_back(absl::make_unique<Shard>());
+    }
+    shard_max_size_ = max_size_ / shards_.size();
   }
 
   // Add block to the cache.
-  void Add(std::string key, size_t block_size, char* data)
-      ABSL_LOCKS_EXCLUDED(mu_) {
+  void Add(const std::string& key, size_t block_size, const char* data) {
     if (max_size_ == 0) {
       return;
     }
-    mutex_lock lock(mu_);
+    Shard* shard = GetShard(key);
+    mutex_lock lock(shard->mu);
     VLOG(3) << "MiniBlockCache Add: key = " << key
             << ", block_size = " << block_size
-            << ", to current_size = " << keys_fifo_.size();
-    if (!map_.contains(key)) {
-      if (max_size_ < (size_ + block_size) && !keys_fifo_.empty()) {
-        string pop_key = keys_fifo_.front();
-        VLOG(3) << "MiniBlockCache pop key = " << pop_key;
-        size_ -= map_[pop_key]->size();
-        map_.erase(pop_key);
-        keys_fifo_.pop();
-      }
-      keys_fifo_.push(key);
-      map_[key] = absl::make_unique<std::vector<char>>();
+            << ", to current_size = " << shard->lru.size();
+    auto entry = shard->map.find(key);
+    if (entry != shard->map.end()) {
+      shard->size -= entry->second.data->size();
+      shard->lru.erase(entry->second.lru_iterator);
+      shard->map.erase(entry);
+    }
+    while (shard_max_size_ < (shard->size + block_size) &&
+           !shard->lru.empty()) {
+      const string& pop_key = shard->lru.back();
+      VLOG(3) << "MiniBlockCache pop key = " << pop_key;
+      auto pop = shard->map.find(pop_key);
+      shard->size -= pop->second.data->size();
+      shard->map.erase(pop);
+      shard->lru.pop_back();
     }
-    map_[key]->assign(data, data + block_size);
-    size_ += map_[key]->size();
+    shard->lru.push_front(key);
+    Entry& inserted = shard->map[key];
+    inserted.data =
+        absl::make_unique<std::vector<char>>(data, data + block_size);
+    inserted.lru_iterator = shard->lru.begin();
+    shard->size += block_size;
   }
 
   // Peek map to check if the key is contained in it.
-  bool Peek(std::string key) ABSL_LOCKS_EXCLUDED(mu_) {
+  bool Peek(const std::string& key) {
     if (max_size_ == 0) {
       return false;
     }
-    mutex_lock lock(mu_);
-    return map_.contains(key);
+    Shard* shard = GetShard(key);
+    mutex_lock lock(shard->mu);
+    return shard->map.contains(key);
   }
 
   // Get block from cache if it exists.
-  bool Get(std::string key, int64 offset, size_t n, char* buffer,
-           size_t* bytes_copied) ABSL_LOCKS_EXCLUDED(mu_) {
+  bool Get(const std::string& key, int64 offset, size_t n, char* buffer,
+           size_t* bytes_copied) {
+    *bytes_copied = 0;
     if (max_size_ == 0) {
-      *bytes_copied = 0;
       return false;
     }
-    mutex_lock lock(mu_);
-    if (!map_.contains(key) || offset > map_[key]->size()) {
+    Shard* shard = GetShard(key);
+    mutex_lock lock(shard->mu);
+    auto entry = shard->map.find(key);
+    if (entry == shard->map.end() || offset > entry->second.data->size()) {
       VLOG(3) << "MiniBlockCache MISS Get: key = " << key
               << ", offset = " << offset << ", n = " << n;
-      *bytes_copied = 0;
       return false;
     }
     VLOG(3) << "MiniBlockCache HIT Get: key = " << key
             << ", offset = " << offset << ", n = " << n;
+    shard->lru.splice(shard->lru.begin(), shard->lru,
+                      entry->second.lru_iterator);
 
+    const std::vector<char>& data = *entry->second.data;
     int64 bytes_to_copy = n;
-    if (offset + n > map_[key]->size()) {
-      bytes_to_copy = map_[key]->size() - offset;
+    if (offset + n > data.size()) {
+      bytes_to_copy = data.size() - offset;
     }
 
-    memcpy(buffer, map_[key]->data() + offset, bytes_to_copy);
+    memcpy(buffer, data.data() + offset, bytes_to_copy);
     *bytes_copied = bytes_to_copy;
     return true;
   }
 
+  // Get a copy of the whole block from cache if it exists.
+  bool Lookup(const std::string& key, std::vector<char>* data) {
+    if (max_size_ == 0) {
+      return false;
+    }
+    Shard* shard = GetShard(key);
+    mutex_lock lock(shard->mu);
+    auto entry = shard->map.find(key);
+    if (entry == shard->map.end()) {
+      return false;
+    }
+    shard->lru.splice(shard->lru.begin(), shard->lru,
+                      entry->second.lru_iterator);
+    data->assign(entry->second.data->begin(), entry->second.data->end());
+    return true;
+  }
+
   // Mark block as FETCHING state if it is not fetching yet. If it was already
   // fetching then add thread to the list waiting on the block to be fetched.
-  void Fetching(std::string key) ABSL_LOCKS_EXCLUDED(fetcher_mu_) {
+  void Fetching(const std::string& key) ABSL_LOCKS_EXCLUDED(fetcher_mu_) {
     mutex_lock lock(fetcher_mu_);
     if (!fetching_map_.contains(key)) {
       fetching_map_[key] = std::make_shared<condition_variable>();
@@ -111,7 +152,7 @@ class MiniBlockCache {
   }
 
   // Mark block as FETCHED and notify all threads waiting for it.
-  void Fetched(std::string key) ABSL_LOCKS_EXCLUDED(fetcher_mu_) {
+  void Fetched(const std::string& key) ABSL_LOCKS_EXCLUDED(fetcher_mu_) {
     mutex_lock lock(fetcher_mu_);
     if (fetching_map_.contains(key)) {
       fetching_map_[key]->notify_all();
@@ -120,12 +161,26 @@ class MiniBlockCache {
   }
 
  private:
+  struct Entry {
+    std::unique_ptr<std::vector<char>> data;
+    std::list<string>::iterator lru_iterator;
+  };
+
+  struct Shard {
+    mutex mu;
+    size_t size ABSL_GUARDED_BY(mu) = 0;
+    // Most recently used keys are at the front.
+    std::list<string> lru ABSL_GUARDED_BY(mu);
+    absl::flat_hash_map<std::string, Entry> map ABSL_GUARDED_BY(mu);
+  };
+
+  Shard* GetShard(const std::string& key) {
+    return shards_[std::hash<std::string>()(key) % shards_.size()].get();
+  }
+
   const size_t max_size_;
-  mutable mutex mu_;
-  size_t size_ ABSL_GUARDED_BY(mu_) = 0;
-  std::queue<string> keys_fifo_ ABSL_GUARDED_BY(mu_);
-  absl::flat_hash_map<std::string, std::unique_ptr<std::vector<char>>> map_
-      ABSL_GUARDED_BY(mu_);
+  size_t shard_max_size_;
+  std::vector<std::unique_ptr<Shard>> shards_;
   mutable mutex fetcher_mu_;
   absl::flat_hash_map<std::string, std::shared_ptr<condition_variable>>
       fetching_map_ ABSL_GUARDED_BY(fetcher_mu_);
@@ -241,6 +296,7 @@ class MemcachedFileBlockCache : public tsl::FileBlockCache {
       size_t block_size, size_t max_bytes, uint64 max_staleness,
       const size_t local_cache_size, const std::vector<string>& servers,
       const std::vector<string>& options, BlockFetcher block_fetcher,
+      size_t read_ahead_blocks = 0, size_t fetch_threads = 16,
       Env* env = Env::Default());
 
   ~MemcachedFileBlockCache() override;
@@ -314,6 +370,21 @@ class MemcachedFileBlockCache : public tsl::FileBlockCache {
                                    const std::vector<string>& server_names,
                                    const std::vector<string>& options);
 
+  // Fetches in parallel the blocks at `positions` that could not be served
+  // from memcached. Each fetch takes a memcached client from the pool when
+  // `use_memcached` is set, otherwise it goes straight to the block fetcher.
+  // Per block status is returned in `status`, as errors past the end of file
+  // only matter if all blocks before were full.
+  void FetchBlocks(const string& filename, const std::vector<size_t>& positions,
+                   bool use_memcached, std::vector<std::vector<char>>* blocks,
+                   std::vector<Status>* status);
+
+  // Schedules background fetches of read-ahead blocks that missed memcached,
+  // the results are kept in the local cache.
+  void PrefetchBlocks(const string& filename,
+                      const std::vector<size_t>& positions)
+      ABSL_LOCKS_EXCLUDED(prefetch_mu_);
+
   // Constructs a memcached key, a single string from the information in Key.
   string MakeMemcachedKey(const Key& key) ABSL_LOCKS_EXCLUDED(mu_);
 
@@ -327,6 +398,9 @@ class MemcachedFileBlockCache : public tsl::FileBlockCache {
   size_t max_bytes_;
   // Whether to fetch keys with multi-get or not.
   bool use_multi_get_;
+  // Number of blocks past the end of each read to request in the same
+  // multi-get, and to prefetch into the local cache on a miss.
+  const size_t read_ahead_blocks_;
   // The callback to read a block from the underlying filesystem.
   const BlockFetcher block_fetcher_;
   // The Env from which we read timestamps.
@@ -383,6 +457,15 @@ class MemcachedFileBlockCache : public tsl::FileBlockCache {
   // received in sequential order and in short order of each other. So a small
   // local cache can prevent too many remote requests.
   std::unique_ptr<MiniBlockCache> local_cache_;
+
+  // Keys of read-ahead blocks currently being fetched in the background.
+  mutable mutex prefetch_mu_;
+  std::set<string> prefetching_ ABSL_GUARDED_BY(prefetch_mu_);
+
+  // Thread pool used to fill block misses from the backing filesystem
+  // concurrently. Declared last so that it is destroyed (and pending
+  // prefetches drained) before the members they use.
+  std::unique_ptr<thread::ThreadPool> fetch_pool_;
 };
 
 }  // namespace tensorflow
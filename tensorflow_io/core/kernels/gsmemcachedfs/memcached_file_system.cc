@@ -62,6 +62,12 @@ constexpr char kMaxGrpcAttempts[] = "GCS_BLOCK_FETCHER_GRPC_MAX_ATTEMPTS";
 // to serve subsequent small reads from that block locally.
 // 4GB local cache has shown very good hit-ratio and performance.
 constexpr char kMemcachedLocalCachesize[] = "MEMCACHED_LOCAL_CACHE_SIZE_GB";
+// Number of blocks past the end of each read to request from memcached in the
+// same multi-get round trip, and to prefetch into the local cache on misses.
+constexpr char kMemcachedReadAheadBlocks[] = "MEMCACHED_READ_AHEAD_BLOCKS";
+// Number of threads used to fill block cache misses from GCS concurrently.
+constexpr char kMemcachedFetchThreads[] = "MEMCACHED_FETCH_THREADS";
+constexpr size_t kDefaultMemcachedFetchThreads = 16;
 
 // How much time to initially wait before retrying a failed grpc.
 constexpr absl::Duration kInitialGrpcRetry = absl::Seconds(1);
@@ -172,10 +178,23 @@ std::unique_ptr<FileBlockCache> MemcachedGcsFileSystem::MakeFileBlockCache(
               << local_cache_size;
     }
 
+    size_t read_ahead_blocks = 0;
+    if (GetEnvVar(kMemcachedReadAheadBlocks, strings::safe_strtou64, &value)) {
+      read_ahead_blocks = value;
+      VLOG(1) << "Distributed cache client reads ahead " << read_ahead_blocks
+              << " blocks";
+    }
+
+    size_t fetch_threads = kDefaultMemcachedFetchThreads;
+    if (GetEnvVar(kMemcachedFetchThreads, strings::safe_strtou64, &value)) {
+      fetch_threads = value;
+    }
+
     std::unique_ptr<FileBlockCache> file_block_cache(
         new MemcachedFileBlockCache(*memcached_clients_, block_size, max_bytes,
                                     max_staleness, local_cache_size, servers,
-                                    options, block_fetcher));
+                                    options, block_fetcher, read_ahead_blocks,
+                                    fetch_threads));
     return file_block_cache;
   }
 
@@ -16,14 +16,234 @@ limitations under the License.
 #include <H5Cpp.h>
 #include <hdf5.h>
 #include <hdf5_hl.h>
+#include <zlib.h>
+
+#include <list>
 
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow_io/core/kernels/io_kernel.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
+// HDF5RandomAccessFileCache is a LRU block cache on top of
+// tensorflow::RandomAccessFile. It is used by the HDF5 virtual file
+// driver below so that only the blocks touched by HDF5 (superblock,
+// b-tree nodes and the chunks intersecting a hyperslab) are fetched
+// from remote filesystems, instead of loading the whole file.
+class HDF5RandomAccessFileCache {
+ public:
+  HDF5RandomAccessFileCache(
+      std::unique_ptr<tensorflow::RandomAccessFile>&& file, uint64 size,
+      uint64 block_size, uint64 block_count)
+      : file_(std::move(file)),
+        size_(size),
+        block_size_(block_size),
+        block_count_(block_count) {}
+
+  virtual ~HDF5RandomAccessFileCache() {}
+
+  uint64 Size() const { return size_; }
+
+  // Read bytes [offset, offset + n) into buffer, n has to be within the
+  // file size already.
+  Status Read(uint64 offset, size_t n, char* buffer) {
+    mutex_lock l(mu_);
+    if (n == 0) {
+      return OkStatus();
+    }
+    if (offset + n > size_) {
+      return errors::OutOfRange("read out of boundary: offset=", offset,
+                                ", n=", n, ", size=", size_);
+    }
+    const uint64 first = offset / block_size_;
+    const uint64 last = (offset + n - 1) / block_size_;
+
+    // Large reads would only thrash the cache, bypass in that case.
+    if (last - first + 1 > block_count_) {
+      StringPiece result;
+      TF_RETURN_IF_ERROR(file_->Read(offset, n, &result, buffer));
+      if (result.data() != buffer) {
+        memcpy(buffer, result.data(), result.size());
+      }
+      return OkStatus();
+    }
+
+    // Fetch runs of contiguous missing blocks with one request each.
+    uint64 index = first;
+    while (index <= last) {
+      if (blocks_.find(index) != blocks_.end()) {
+        index++;
+        continue;
+      }
+      uint64 run = index;
+      while (run + 1 <= last && blocks_.find(run + 1) == blocks_.end()) {
+        run++;
+      }
+      TF_RETURN_IF_ERROR(Fetch(index, run));
+      index = run + 1;
+    }
+
+    for (index = first; index <= last; index++) {
+      auto lookup = blocks_.find(index);
+      lru_.splice(lru_.begin(), lru_, lookup->second.second);
+      const string& block = lookup->second.first;
+      const uint64 block_offset = index * block_size_;
+      const uint64 begin = std::max(offset, block_offset);
+      const uint64 end = std::min(static_cast<uint64>(offset + n),
+                                  block_offset + block.size());
+      memcpy(buffer + (begin - offset), block.data() + (begin - block_offset),
+             end - begin);
+    }
+    return OkStatus();
+  }
+
+ private:
+  Status Fetch(uint64 first, uint64 last) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    const uint64 offset = first * block_size_;
+    const uint64 n = std::min((last + 1) * block_size_, size_) - offset;
+    string buffer;
+    buffer.resize(n);
+    StringPiece result;
+    TF_RETURN_IF_ERROR(file_->Read(offset, n, &result, &buffer[0]));
+    if (result.size() != n) {
+      return errors::DataLoss("unable to read ", n, " bytes at ", offset,
+                              ", received ", result.size());
+    }
+    for (uint64 index = first; index <= last; index++) {
+      const uint64 begin = index * block_size_ - offset;
+      const uint64 size = std::min(block_size_, n - begin);
+      while (blocks_.size() >= block_count_) {
+        blocks_.erase(lru_.back());
+        lru_.pop_back();
+      }
+      lru_.push_front(index);
+      blocks_[index] = std::make_pair(
+          string(result.data() + begin, size), lru_.begin());
+    }
+    return OkStatus();
+  }
+
+  mutex mu_;
+  std::unique_ptr<tensorflow::RandomAccessFile> file_;
+  const uint64 size_;
+  const uint64 block_size_;
+  const uint64 block_count_;
+  std::list<uint64> lru_ TF_GUARDED_BY(mu_);
+  std::unordered_map<uint64, std::pair<string, std::list<uint64>::iterator>>
+      blocks_ TF_GUARDED_BY(mu_);
+};
+
+// HDF5 virtual file driver (VFD) backed by HDF5RandomAccessFileCache.
+// The driver is read-only, the cache is passed through the file access
+// property list as driver info.
+class HDF5RandomAccessFileDriver {
+ public:
+  struct Info {
+    HDF5RandomAccessFileCache* cache;
+  };
+
+  // Register the driver once, return the driver id.
+  static hid_t Id() {
+    static hid_t id = []() {
+      static H5FD_class_t cls;
+      memset(&cls, 0, sizeof(cls));
+      cls.name = "tensorflow_io";
+      cls.maxaddr = static_cast<haddr_t>(std::numeric_limits<int64>::max());
+      cls.fc_degree = H5F_CLOSE_WEAK;
+      cls.fapl_size = sizeof(Info);
+      cls.open = HDF5RandomAccessFileDriver::Open;
+      cls.close = HDF5RandomAccessFileDriver::Close;
+      cls.query = HDF5RandomAccessFileDriver::Query;
+      cls.get_eoa = HDF5RandomAccessFileDriver::GetEoa;
+      cls.set_eoa = HDF5RandomAccessFileDriver::SetEoa;
+      cls.get_eof = HDF5RandomAccessFileDriver::GetEof;
+      cls.read = HDF5RandomAccessFileDriver::Read;
+      cls.write = HDF5RandomAccessFileDriver::Write;
+      for (int i = 0; i < H5FD_MEM_NTYPES; i++) {
+        cls.fl_map[i] = H5FD_MEM_DEFAULT;
+      }
+      return H5FDregister(&cls);
+    }();
+    return id;
+  }
+
+ private:
+  // H5FD_t has to be the first member as HDF5 casts between them.
+  struct File {
+    H5FD_t pub;
+    HDF5RandomAccessFileCache* cache;
+    haddr_t eoa;
+  };
+
+  static H5FD_t* Open(const char* name, unsigned flags, hid_t fapl_id,
+                      haddr_t maxaddr) {
+    if ((flags & H5F_ACC_RDWR) || (flags & H5F_ACC_CREAT) ||
+        (flags & H5F_ACC_TRUNC)) {
+      return nullptr;
+    }
+    const Info* info = static_cast<const Info*>(H5Pget_driver_info(fapl_id));
+    if (info == nullptr || info->cache == nullptr) {
+      return nullptr;
+    }
+    File* file = new File();
+    file->cache = info->cache;
+    file->eoa = 0;
+    return &file->pub;
+  }
+
+  static herr_t Close(H5FD_t* f) {
+    delete reinterpret_cast<File*>(f);
+    return 0;
+  }
+
+  static herr_t Query(const H5FD_t* f, unsigned long* flags) {
+    if (flags != nullptr) {
+      *flags = H5FD_FEAT_ACCUMULATE_METADATA | H5FD_FEAT_DATA_SIEVE;
+    }
+    return 0;
+  }
+
+  static haddr_t GetEoa(const H5FD_t* f, H5FD_mem_t type) {
+    return reinterpret_cast<const File*>(f)->eoa;
+  }
+
+  static herr_t SetEoa(H5FD_t* f, H5FD_mem_t type, haddr_t addr) {
+    reinterpret_cast<File*>(f)->eoa = addr;
+    return 0;
+  }
+
+  static haddr_t GetEof(const H5FD_t* f, H5FD_mem_t type) {
+    return reinterpret_cast<const File*>(f)->cache->Size();
+  }
+
+  static herr_t Read(H5FD_t* f, H5FD_mem_t type, hid_t dxpl_id, haddr_t addr,
+                     size_t size, void* buf) {
+    HDF5RandomAccessFileCache* cache = reinterpret_cast<File*>(f)->cache;
+    // Bytes beyond the end of file are read as zeros, same as sec2 driver.
+    size_t n = 0;
+    if (addr < cache->Size()) {
+      n = std::min(static_cast<uint64>(size), cache->Size() - addr);
+    }
+    Status status = cache->Read(addr, n, static_cast<char*>(buf));
+    if (!status.ok()) {
+      LOG(ERROR) << "unable to read hdf5 file at " << addr << ": " << status;
+      return -1;
+    }
+    if (n < size) {
+      memset(static_cast<char*>(buf) + n, 0, size - n);
+    }
+    return 0;
+  }
+
+  static herr_t Write(H5FD_t* f, H5FD_mem_t type, hid_t dxpl_id, haddr_t addr,
+                      size_t size, const void* buf) {
+    return -1;
+  }
+};
+
 class HDF5FileImage {
  public:
   HDF5FileImage(Env* env, const string& filename, const string& optional_memory)
@@ -43,16 +263,31 @@ class HDF5FileImage {
         std::unique_ptr<tensorflow::RandomAccessFile> file;
         status = env->NewRandomAccessFile(filename, &file);
         if (status.ok()) {
-          StringPiece result;
-          buffer_memory_.resize(size);
-          status = file->Read(0, size, &result, &buffer_memory_[0]);
-          if (status.ok()) {
-            file_image_ = H5LTopen_file_image(
-                (void*)buffer_memory_.data(), buffer_memory_.size(),
-                H5LT_FILE_IMAGE_DONT_COPY | H5LT_FILE_IMAGE_DONT_RELEASE);
-            file_.reset(new H5::H5File());
-            file_.get()->setId(file_image_);
+          int64 block_size = 1024 * 1024;
+          int64 block_count = 64;
+          const char* block_size_env = std::getenv("TFIO_HDF5_BLOCK_SIZE");
+          if (block_size_env != nullptr) {
+            block_size = std::max(std::atoll(block_size_env), 4096LL);
+          }
+          const char* block_count_env = std::getenv("TFIO_HDF5_BLOCK_COUNT");
+          if (block_count_env != nullptr) {
+            block_count = std::max(std::atoll(block_count_env), 1LL);
           }
+          cache_.reset(new HDF5RandomAccessFileCache(
+              std::move(file), size, block_size, block_count));
+
+          HDF5RandomAccessFileDriver::Info info = {cache_.get()};
+          hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+          if (H5Pset_driver(fapl, HDF5RandomAccessFileDriver::Id(), &info) >=
+              0) {
+            hid_t file_id = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, fapl);
+            if (file_id >= 0) {
+              file_image_ = file_id;
+              file_.reset(new H5::H5File());
+              file_.get()->setId(file_image_);
+            }
+          }
+          H5Pclose(fapl);
         }
       }
     }
@@ -70,7 +305,7 @@ class HDF5FileImage {
  private:
   string filename_;
   const string& optional_memory_;
-  string buffer_memory_;
+  std::unique_ptr<HDF5RandomAccessFileCache> cache_;
   std::unique_ptr<H5::H5File> file_;
   hid_t file_image_ = 0;
 };
@@ -116,6 +351,193 @@ class HDF5Iterate {
   haddr_t parent_;
 };
 
+// HDF5ReadChunked reads a hyperslab of a chunked, gzip (and optionally
+// shuffle) compressed dataset. Raw chunks intersecting the hyperslab are
+// fetched with H5Dread_chunk on the calling thread (HDF5 itself is not
+// thread-safe), then decompressed and scattered into the output on the
+// thread pool. handled is set to false if the dataset does not qualify,
+// in which case the caller is expected to fall back to H5Dread.
+Status HDF5ReadChunked(hid_t data_set, hid_t memory_type,
+                       const absl::InlinedVector<int64, 4>& start,
+                       const TensorShape& shape, char* output,
+                       thread::ThreadPool* thread_pool, bool* handled) {
+  *handled = false;
+  const int rank = shape.dims();
+  if (thread_pool == nullptr || memory_type < 0 || rank == 0) {
+    return OkStatus();
+  }
+
+  hid_t data_type = H5Dget_type(data_set);
+  if (data_type < 0) {
+    return OkStatus();
+  }
+  htri_t equal = H5Tequal(data_type, memory_type);
+  H5Tclose(data_type);
+  if (equal <= 0) {
+    return OkStatus();
+  }
+  const size_t element_size = H5Tget_size(memory_type);
+
+  hid_t create_plist = H5Dget_create_plist(data_set);
+  if (create_plist < 0) {
+    return OkStatus();
+  }
+  absl::InlinedVector<hsize_t, 4> chunk(rank);
+  std::vector<H5Z_filter_t> filters;
+  bool qualified = (H5Pget_layout(create_plist) == H5D_CHUNKED &&
+                    H5Pget_chunk(create_plist, rank, chunk.data()) == rank);
+  const int filter_count = qualified ? H5Pget_nfilters(create_plist) : 0;
+  for (int i = 0; i < filter_count; i++) {
+    unsigned int flags = 0;
+    size_t cd_nelmts = 0;
+    unsigned int filter_config = 0;
+    H5Z_filter_t filter =
+        H5Pget_filter2(create_plist, i, &flags, &cd_nelmts, nullptr, 0,
+                       nullptr, &filter_config);
+    if (filter != H5Z_FILTER_DEFLATE && filter != H5Z_FILTER_SHUFFLE) {
+      qualified = false;
+    }
+    filters.emplace_back(filter);
+  }
+  H5Pclose(create_plist);
+  if (!qualified || filters.empty()) {
+    return OkStatus();
+  }
+
+  absl::InlinedVector<hsize_t, 4> first(rank), count(rank);
+  int64 total = 1;
+  int64 chunk_elements = 1;
+  for (int r = 0; r < rank; r++) {
+    if (shape.dim_size(r) == 0) {
+      *handled = true;
+      return OkStatus();
+    }
+    first[r] = start[r] / chunk[r];
+    count[r] = (start[r] + shape.dim_size(r) - 1) / chunk[r] - first[r] + 1;
+    total *= count[r];
+    chunk_elements *= chunk[r];
+  }
+  // Nothing to gain from a single chunk.
+  if (total < 2) {
+    return OkStatus();
+  }
+  const size_t chunk_bytes = chunk_elements * element_size;
+
+  std::vector<absl::InlinedVector<hsize_t, 4>> offsets(total);
+  std::vector<string> chunks(total);
+  std::vector<uint32_t> masks(total);
+  for (int64 i = 0; i < total; i++) {
+    offsets[i].resize(rank);
+    int64 index = i;
+    for (int r = rank - 1; r >= 0; r--) {
+      offsets[i][r] = (first[r] + index % count[r]) * chunk[r];
+      index /= count[r];
+    }
+    hsize_t size = 0;
+    if (H5Dget_chunk_storage_size(data_set, offsets[i].data(), &size) < 0 ||
+        size == 0) {
+      // Unallocated chunk is filled with fill value, leave it to HDF5.
+      return OkStatus();
+    }
+    chunks[i].resize(size);
+    if (H5Dread_chunk(data_set, H5P_DEFAULT, offsets[i].data(), &masks[i],
+                      &chunks[i][0]) < 0) {
+      return errors::InvalidArgument("unable to read chunk ", i);
+    }
+  }
+
+  std::vector<Status> status(total);
+  thread_pool->ParallelFor(
+      total, chunk_bytes * 10, [&](int64 chunk_start, int64 chunk_limit) {
+        string buffer, scratch;
+        for (int64 i = chunk_start; i < chunk_limit; i++) {
+          // Filters are applied in reverse order, skipping the ones
+          // masked out for this chunk.
+          string* data = &chunks[i];
+          for (int64 f = filters.size() - 1; f >= 0; f--) {
+            if (masks[i] & (1u << f)) {
+              continue;
+            }
+            scratch.resize(chunk_bytes);
+            if (filters[f] == H5Z_FILTER_DEFLATE) {
+              uLongf length = chunk_bytes;
+              int err = uncompress(reinterpret_cast<Bytef*>(&scratch[0]),
+                                   &length,
+                                   reinterpret_cast<const Bytef*>(data->data()),
+                                   data->size());
+              if (err != Z_OK || length != chunk_bytes) {
+                status[i] = errors::DataLoss("unable to inflate chunk ", i,
+                                             ": ", err);
+                break;
+              }
+            } else {
+              if (data->size() != chunk_bytes) {
+                status[i] = errors::DataLoss("unable to unshuffle chunk ", i,
+                                             ": ", data->size());
+                break;
+              }
+              const size_t elements = chunk_bytes / element_size;
+              for (size_t b = 0; b < element_size; b++) {
+                const char* p = data->data() + b * elements;
+                for (size_t e = 0; e < elements; e++) {
+                  scratch[e * element_size + b] = p[e];
+                }
+              }
+              memcpy(&scratch[elements * element_size],
+                     data->data() + elements * element_size,
+                     chunk_bytes - elements * element_size);
+            }
+            buffer.swap(scratch);
+            data = &buffer;
+          }
+          if (!status[i].ok()) {
+            continue;
+          }
+          if (data->size() != chunk_bytes) {
+            status[i] = errors::DataLoss("invalid chunk size ", i, ": ",
+                                         data->size(), " vs. ", chunk_bytes);
+            continue;
+          }
+
+          // Copy the intersection with the hyperslab row by row.
+          absl::InlinedVector<int64, 4> lo(rank), hi(rank), index(rank);
+          for (int r = 0; r < rank; r++) {
+            lo[r] = std::max(start[r], static_cast<int64>(offsets[i][r]));
+            hi[r] = std::min(start[r] + shape.dim_size(r),
+                             static_cast<int64>(offsets[i][r] + chunk[r]));
+            index[r] = lo[r];
+          }
+          const size_t row_bytes = (hi[rank - 1] - lo[rank - 1]) * element_size;
+          while (true) {
+            int64 source = 0, target = 0;
+            for (int r = 0; r < rank; r++) {
+              source = source * chunk[r] + (index[r] - offsets[i][r]);
+              target = target * shape.dim_size(r) + (index[r] - start[r]);
+            }
+            memcpy(output + target * element_size,
+                   data->data() + source * element_size, row_bytes);
+            int r = rank - 2;
+            while (r >= 0) {
+              index[r]++;
+              if (index[r] < hi[r]) {
+                break;
+              }
+              index[r] = lo[r];
+              r--;
+            }
+            if (r < 0) {
+              break;
+            }
+          }
+        }
+      });
+  for (int64 i = 0; i < total; i++) {
+    TF_RETURN_IF_ERROR(status[i]);
+  }
+  *handled = true;
+  return OkStatus();
+}
+
 class HDF5ReadableResource : public ResourceBase {
  public:
   HDF5ReadableResource(Env* env)
@@ -338,7 +760,7 @@ class HDF5ReadableResource : public ResourceBase {
 
   Status Read(const string& component,
               const absl::InlinedVector<int64, 4>& start,
-              const TensorShape& shape,
+              const TensorShape& shape, thread::ThreadPool* thread_pool,
               std::function<Status(const TensorShape& shape, Tensor** value)>
                   allocate_func) {
     mutex_lock l(mu_);
@@ -385,6 +807,50 @@ class HDF5ReadableResource : public ResourceBase {
 
         data_space.selectHyperslab(H5S_SELECT_SET, dims.data(),
                                    dims_start.data());
+
+        hid_t memory_type = -1;
+        switch (dtypes_[column_index]) {
+          case DT_UINT8:
+            memory_type = H5T_NATIVE_UINT8;
+            break;
+          case DT_UINT16:
+            memory_type = H5T_NATIVE_UINT16;
+            break;
+          case DT_UINT32:
+            memory_type = H5T_NATIVE_UINT32;
+            break;
+          case DT_UINT64:
+            memory_type = H5T_NATIVE_UINT64;
+            break;
+          case DT_INT8:
+            memory_type = H5T_NATIVE_INT8;
+            break;
+          case DT_INT16:
+            memory_type = H5T_NATIVE_INT16;
+            break;
+          case DT_INT32:
+            memory_type = H5T_NATIVE_INT32;
+            break;
+          case DT_INT64:
+            memory_type = H5T_NATIVE_INT64;
+            break;
+          case DT_FLOAT:
+            memory_type = H5T_NATIVE_FLOAT;
+            break;
+          case DT_DOUBLE:
+            memory_type = H5T_NATIVE_DOUBLE;
+            break;
+          default:
+            break;
+        }
+        bool handled = false;
+        TF_RETURN_IF_ERROR(HDF5ReadChunked(
+            data_set.getId(), memory_type, start, shape,
+            const_cast<char*>(value->tensor_data().data()), thread_pool,
+            &handled));
+        if (handled) {
+          return OkStatus();
+        }
       }
 
       switch (dtypes_[column_index]) {
@@ -702,6 +1168,7 @@ class HDF5ReadableReadOp : public IOResourceOpKernel<HDF5ReadableResource> {
 
     TF_RETURN_IF_ERROR(resource->Read(
         component, start, shape,
+        context->device()->tensorflow_cpu_worker_threads()->workers,
         [&](const TensorShape& shape, Tensor** value) -> Status {
           TF_RETURN_IF_ERROR(context->allocate_output(0, shape, value));
           return OkStatus();
@@ -15,9 +15,66 @@ limitations under the License.
 
 #include "avif/avif.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow_io/core/kernels/image_kernels.h"
 
 namespace tensorflow {
 namespace io {
+
+Status DecodeAVIFImage(StringPiece contents, DataType dtype,
+                       const ImageAllocateFunc& allocate_func) {
+  if (dtype != DT_UINT8) {
+    return errors::InvalidArgument("AVIF only decodes to uint8, got ",
+                                   DataTypeString(dtype));
+  }
+
+  avifROData raw;
+  raw.data = reinterpret_cast<const uint8_t*>(contents.data());
+  raw.size = contents.size();
+
+  std::unique_ptr<avifImage, void (*)(avifImage*)> image(
+      avifImageCreateEmpty(), [](avifImage* p) {
+        if (p != nullptr) {
+          avifImageDestroy(p);
+        }
+      });
+  std::unique_ptr<avifDecoder, void (*)(avifDecoder*)> decoder(
+      avifDecoderCreate(), [](avifDecoder* p) {
+        if (p != nullptr) {
+          avifDecoderDestroy(p);
+        }
+      });
+
+  avifResult decodeResult = avifDecoderRead(decoder.get(), image.get(), &raw);
+  if (decodeResult != AVIF_RESULT_OK) {
+    return errors::InvalidArgument("unable to decode avif: ",
+                                   avifResultToString(decodeResult));
+  }
+
+  if (image->depth != 8) {
+    return errors::InvalidArgument("only 8-bit avif images are supported");
+  }
+
+  int64 channels = 3;
+
+  void* buffer = nullptr;
+  TF_RETURN_IF_ERROR(allocate_func(
+      TensorShape({image->height, image->width, channels}), &buffer));
+  avifRGBImage rgb;
+  avifRGBImageSetDefaults(&rgb, image.get());
+
+  rgb.format = AVIF_RGB_FORMAT_RGB;
+  rgb.depth = image->depth;
+
+  rgb.pixels = static_cast<uint8_t*>(buffer);
+  rgb.rowBytes = (image->width * channels);
+  avifResult rgbResult = avifImageYUVToRGB(image.get(), &rgb);
+  if (rgbResult != AVIF_RESULT_OK) {
+    return errors::InvalidArgument("unable to convert avif to rgb: ",
+                                   avifResultToString(rgbResult));
+  }
+  return OkStatus();
+}
+
 namespace {
 
 class DecodeAVIFOp : public OpKernel {
@@ -29,53 +86,10 @@ class DecodeAVIFOp : public OpKernel {
     OP_REQUIRES(context, TensorShapeUtils::IsScalar(contents_tensor.shape()),
                 errors::InvalidArgument("contents must be scalar, got shape ",
                                         contents_tensor.shape().DebugString()));
-    auto contents = contents_tensor.scalar<tstring>()();
-
-    avifROData raw;
-    raw.data = (const uint8_t*)&contents[0];
-    raw.size = contents.size();
-
-    std::unique_ptr<avifImage, void (*)(avifImage*)> image(
-        avifImageCreateEmpty(), [](avifImage* p) {
-          if (p != nullptr) {
-            avifImageDestroy(p);
-          }
-        });
-    std::unique_ptr<avifDecoder, void (*)(avifDecoder*)> decoder(
-        avifDecoderCreate(), [](avifDecoder* p) {
-          if (p != nullptr) {
-            avifDecoderDestroy(p);
-          }
-        });
-
-    avifResult decodeResult = avifDecoderRead(decoder.get(), image.get(), &raw);
-    OP_REQUIRES(context, (decodeResult == AVIF_RESULT_OK),
-                errors::InvalidArgument("unable to decode avif: ",
-                                        avifResultToString(decodeResult)));
-
-    OP_REQUIRES(
-        context, (image->depth == 8),
-        errors::InvalidArgument("only 8-bit avif images are supported"));
-
-    int64 channels = 3;
-
-    Tensor* output_tensor = nullptr;
-    OP_REQUIRES_OK(context,
-                   context->allocate_output(
-                       0, TensorShape({image->height, image->width, channels}),
-                       &output_tensor));
-    avifRGBImage rgb;
-    avifRGBImageSetDefaults(&rgb, image.get());
-
-    rgb.format = AVIF_RGB_FORMAT_RGB;
-    rgb.depth = image->depth;
-
-    rgb.pixels = output_tensor->flat<uint8>().data();
-    rgb.rowBytes = (image->width * channels);
-    avifResult rgbResult = avifImageYUVToRGB(image.get(), &rgb);
-    OP_REQUIRES(context, (rgbResult == AVIF_RESULT_OK),
-                errors::InvalidArgument("unable to convert avif to rgb: ",
-                                        avifResultToString(rgbResult)));
+    const StringPiece contents = contents_tensor.scalar<tstring>()();
+
+    OP_REQUIRES_OK(context, DecodeAVIFImage(contents, DT_UINT8,
+                                            ImageOutputAllocator(context, 0)));
   }
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeAVIF").Device(DEVICE_CPU), DecodeAVIFOp);
@@ -0,0 +1,291 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/work_sharder.h"
+#include "tensorflow_io/core/kernels/image_kernels.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+typedef Status (*ImageDecodeFunc)(StringPiece contents, DataType dtype,
+                                  const ImageAllocateFunc& allocate_func);
+
+// Decoding an image is orders of magnitude more expensive than the cost
+// model's per element default, so give every image its own shard.
+constexpr int64 kDecodeCostPerImage = 1 << 24;
+
+// Bilinear resize with half pixel centers, writing a out_h x out_w image into
+// `output` whose rows are `output_stride` elements apart.
+template <typename T>
+void ResizeImageBilinear(const T* input, int64 in_h, int64 in_w,
+                         int64 channels, T* output, int64 out_h, int64 out_w,
+                         int64 output_stride) {
+  const float scale_y = static_cast<float>(in_h) / out_h;
+  const float scale_x = static_cast<float>(in_w) / out_w;
+  for (int64 y = 0; y < out_h; y++) {
+    const float in_y = std::max(0.0f, (y + 0.5f) * scale_y - 0.5f);
+    const int64 y0 = std::min(static_cast<int64>(in_y), in_h - 1);
+    const int64 y1 = std::min(y0 + 1, in_h - 1);
+    const float dy = in_y - y0;
+    T* row = output + y * output_stride;
+    for (int64 x = 0; x < out_w; x++) {
+      const float in_x = std::max(0.0f, (x + 0.5f) * scale_x - 0.5f);
+      const int64 x0 = std::min(static_cast<int64>(in_x), in_w - 1);
+      const int64 x1 = std::min(x0 + 1, in_w - 1);
+      const float dx = in_x - x0;
+      const T* p00 = input + (y0 * in_w + x0) * channels;
+      const T* p01 = input + (y0 * in_w + x1) * channels;
+      const T* p10 = input + (y1 * in_w + x0) * channels;
+      const T* p11 = input + (y1 * in_w + x1) * channels;
+      for (int64 k = 0; k < channels; k++) {
+        const float top = p00[k] + (p01[k] - static_cast<float>(p00[k])) * dx;
+        const float bottom =
+            p10[k] + (p11[k] - static_cast<float>(p10[k])) * dx;
+        float value = top + (bottom - top) * dy;
+        if (std::is_integral<T>::value) {
+          value = std::round(value);
+        }
+        row[x * channels + k] = static_cast<T>(value);
+      }
+    }
+  }
+}
+
+// Resizes `image` into a height x width slot of the output batch. With
+// `preserve_aspect_ratio` the image is scaled to fit, centered and the
+// remaining border is zero padded.
+template <typename T>
+void ResizeImage(const Tensor& image, int64 height, int64 width,
+                 bool preserve_aspect_ratio, void* buffer) {
+  const int64 in_h = image.dim_size(0);
+  const int64 in_w = image.dim_size(1);
+  const int64 channels = image.dim_size(2);
+  T* output = static_cast<T*>(buffer);
+
+  int64 out_h = height, out_w = width, offset_y = 0, offset_x = 0;
+  if (preserve_aspect_ratio) {
+    memset(output, 0, height * width * channels * sizeof(T));
+    const double scale = std::min(static_cast<double>(height) / in_h,
+                                  static_cast<double>(width) / in_w);
+    out_h = std::min(height, std::max<int64>(1, std::round(in_h * scale)));
+    out_w = std::min(width, std::max<int64>(1, std::round(in_w * scale)));
+    offset_y = (height - out_h) / 2;
+    offset_x = (width - out_w) / 2;
+  }
+  ResizeImageBilinear<T>(image.flat<T>().data(), in_h, in_w, channels,
+                         output + (offset_y * width + offset_x) * channels,
+                         out_h, out_w, width * channels);
+}
+
+// Decodes a 1-D batch of encoded images into a [batch, height, width,
+// channels] tensor. Images are decoded in parallel on the CPU worker threads.
+// Without `size` all images must share one shape and are decoded straight
+// into the output; with `size` images that already have the requested shape
+// are decoded straight into the output, the others are resized into it.
+template <ImageDecodeFunc Decode>
+class DecodeImageBatchOp : public OpKernel {
+ public:
+  explicit DecodeImageBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("size", &size_));
+    OP_REQUIRES(context, size_.empty() || size_.size() == 2,
+                errors::InvalidArgument(
+                    "size must be empty or [height, width], got ",
+                    size_.size(), " elements"));
+    OP_REQUIRES(context,
+                size_.empty() || (size_[0] > 0 && size_[1] > 0),
+                errors::InvalidArgument("size must be positive, got [",
+                                        size_[0], ", ", size_[1], "]"));
+    OP_REQUIRES_OK(context, context->GetAttr("preserve_aspect_ratio",
+                                             &preserve_aspect_ratio_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& contents_tensor = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(contents_tensor.shape()),
+                errors::InvalidArgument("contents must be 1-D, got shape ",
+                                        contents_tensor.shape().DebugString()));
+    if (size_.empty()) {
+      DecodeUniform(context);
+    } else {
+      DecodeResized(context);
+    }
+  }
+
+ private:
+  void DecodeUniform(OpKernelContext* context) {
+    const auto contents = context->input(0).flat<tstring>();
+    const int64 batch = contents.size();
+    const DataType dtype = output_type(0);
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+
+    // Decoders report the shape as soon as the header is parsed. The first
+    // one allocates the output batch and every image is decoded straight
+    // into its slot.
+    mutex mu;
+    Tensor* output_tensor = nullptr;
+    TensorShape image_shape;
+    auto slot = [&](int64 i, const TensorShape& shape,
+                    void** buffer) -> Status {
+      mutex_lock l(mu);
+      if (output_tensor == nullptr) {
+        TensorShape output_shape({batch});
+        output_shape.AppendShape(shape);
+        TF_RETURN_IF_ERROR(
+            context->allocate_output(0, output_shape, &output_tensor));
+        image_shape = shape;
+      }
+      if (shape != image_shape) {
+        return errors::InvalidArgument(
+            "image ", i, " has shape ", shape.DebugString(), ", expected ",
+            image_shape.DebugString(),
+            ", set size to decode images of different shapes");
+      }
+      *buffer = static_cast<char*>(output_tensor->data()) +
+                i * shape.num_elements() * DataTypeSize(dtype);
+      return OkStatus();
+    };
+
+    std::vector<Status> status(batch);
+    Shard(worker_threads->num_threads, worker_threads->workers, batch,
+          kDecodeCostPerImage, [&](int64 start, int64 limit) {
+            for (int64 i = start; i < limit; i++) {
+              status[i] = Decode(
+                  contents(i), dtype,
+                  [&slot, i](const TensorShape& shape,
+                             void** buffer) -> Status {
+                    return slot(i, shape, buffer);
+                  });
+            }
+          });
+    for (int64 i = 0; i < batch; i++) {
+      OP_REQUIRES_OK(context, status[i]);
+    }
+    if (output_tensor == nullptr) {
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(0, TensorShape({0, 0, 0, 0}),
+                                              &output_tensor));
+    }
+  }
+
+  void DecodeResized(OpKernelContext* context) {
+    const auto contents = context->input(0).flat<tstring>();
+    const int64 batch = contents.size();
+    const DataType dtype = output_type(0);
+    const int64 height = size_[0];
+    const int64 width = size_[1];
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+
+    // The number of channels is only known once the first header is parsed,
+    // so the output is allocated by whichever image gets there first.
+    mutex mu;
+    Tensor* output_tensor = nullptr;
+    int64 output_channels = 0;
+    auto slot = [&](int64 i, int64 channels, void** buffer) -> Status {
+      mutex_lock l(mu);
+      if (output_tensor == nullptr) {
+        TF_RETURN_IF_ERROR(context->allocate_output(
+            0, TensorShape({batch, height, width, channels}),
+            &output_tensor));
+        output_channels = channels;
+      }
+      if (channels != output_channels) {
+        return errors::InvalidArgument("image ", i, " has ", channels,
+                                       " channels, expected ",
+                                       output_channels);
+      }
+      *buffer = static_cast<char*>(output_tensor->data()) +
+                i * height * width * channels * DataTypeSize(dtype);
+      return OkStatus();
+    };
+
+    std::vector<Status> status(batch);
+    Shard(
+        worker_threads->num_threads, worker_threads->workers, batch,
+        kDecodeCostPerImage, [&](int64 start, int64 limit) {
+          for (int64 i = start; i < limit; i++) {
+            Tensor image;
+            bool resize = false;
+            status[i] = Decode(
+                contents(i), dtype,
+                [&](const TensorShape& shape, void** buffer) -> Status {
+                  if (shape.dim_size(0) == height &&
+                      shape.dim_size(1) == width) {
+                    return slot(i, shape.dim_size(2), buffer);
+                  }
+                  image = Tensor(dtype, shape);
+                  *buffer = image.data();
+                  resize = true;
+                  return OkStatus();
+                });
+            if (!status[i].ok() || !resize) {
+              continue;
+            }
+            void* buffer = nullptr;
+            status[i] = slot(i, image.dim_size(2), &buffer);
+            if (!status[i].ok()) {
+              continue;
+            }
+            switch (dtype) {
+              case DT_UINT8:
+                ResizeImage<uint8>(image, height, width,
+                                   preserve_aspect_ratio_, buffer);
+                break;
+              case DT_UINT16:
+                ResizeImage<uint16>(image, height, width,
+                                    preserve_aspect_ratio_, buffer);
+                break;
+              case DT_FLOAT:
+                ResizeImage<float>(image, height, width,
+                                   preserve_aspect_ratio_, buffer);
+                break;
+              default:
+                status[i] = errors::InvalidArgument(
+                    "resize is not supported for ", DataTypeString(dtype));
+                break;
+            }
+          }
+        });
+    for (int64 i = 0; i < batch; i++) {
+      OP_REQUIRES_OK(context, status[i]);
+    }
+    if (output_tensor == nullptr) {
+      OP_REQUIRES_OK(context, context->allocate_output(
+                                  0, TensorShape({0, height, width, 0}),
+                                  &output_tensor));
+    }
+  }
+
+  std::vector<int64> size_;
+  bool preserve_aspect_ratio_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeWebPBatch").Device(DEVICE_CPU),
+                        DecodeImageBatchOp<DecodeWebPImage>);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeAVIFBatch").Device(DEVICE_CPU),
+                        DecodeImageBatchOp<DecodeAVIFImage>);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeHdrBatch").Device(DEVICE_CPU),
+                        DecodeImageBatchOp<DecodeHDRImage>);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodePnmBatch").Device(DEVICE_CPU),
+                        DecodeImageBatchOp<DecodePNMImage>);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeJPEG2KBatch").Device(DEVICE_CPU),
+                        DecodeImageBatchOp<DecodeJPEG2KImage>);
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
@@ -47,6 +47,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/shape_inference.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/util/work_sharder.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/numbers.h"
 
@@ -99,6 +100,30 @@ class DecoderRegistration {
   bool initialized_ TF_GUARDED_BY(mu_);
 };
 
+void ReadDICOMFile(StringPiece contents, DcmFileFormat *dicom_file) {
+  DcmInputBufferStream data_buf;
+  data_buf.setBuffer(contents.data(), contents.size());
+  data_buf.setEos();
+
+  dicom_file->transferInit();
+  dicom_file->read(data_buf);
+  dicom_file->transferEnd();
+}
+
+// Loads only frames [frame_start, frame_start + frame_count) of the pixel
+// data. Compressed frames outside of the range are not decoded.
+std::unique_ptr<DicomImage> LoadDICOMFrames(DcmFileFormat *dicom_file,
+                                            unsigned long frame_start,
+                                            unsigned long frame_count) {
+  try {
+    return std::unique_ptr<DicomImage>(
+        new DicomImage(dicom_file, EXS_Unknown, CIF_UsePartialAccessToPixelData,
+                       frame_start, frame_count));
+  } catch (...) {
+    return nullptr;
+  }
+}
+
 template <typename dtype>
 class DecodeDICOMImageOp : public OpKernel {
  public:
@@ -127,34 +152,56 @@ class DecodeDICOMImageOp : public OpKernel {
                                 "to be scalar, but had shape: ",
                                 in_contents.shape().DebugString()));
 
-    const auto in_contents_scalar = in_contents.scalar<tstring>()();
+    const StringPiece in_contents_scalar = in_contents.scalar<tstring>()();
 
-    // Load Dicom Image
-    DcmInputBufferStream data_buf;
-    data_buf.setBuffer(in_contents_scalar.data(), in_contents_scalar.length());
-    data_buf.setEos();
+    const Tensor &frame_start_tensor = context->input(1);
+    const Tensor &frame_count_tensor = context->input(2);
+    OP_REQUIRES(
+        context,
+        TensorShapeUtils::IsScalar(frame_start_tensor.shape()) &&
+            TensorShapeUtils::IsScalar(frame_count_tensor.shape()),
+        errors::InvalidArgument("frame_start and frame_count must be scalar"));
+    const int64 frame_start = frame_start_tensor.scalar<int64>()();
+    OP_REQUIRES(context, frame_start >= 0,
+                errors::InvalidArgument("frame_start must be non-negative, "
+                                        "got ",
+                                        frame_start));
 
+    // Load Dicom Image
     DcmFileFormat dicom_file;
-    dicom_file.transferInit();
-    OFCondition cond = dicom_file.read(data_buf);
-    dicom_file.transferEnd();
-
-    DicomImage *image = NULL;
-    try {
-      image = new DicomImage(&dicom_file, EXS_Unknown,
-                             CIF_DecompressCompletePixelData);
-    } catch (...) {
-      image = NULL;
+    ReadDICOMFile(in_contents_scalar, &dicom_file);
+
+    Sint32 number_of_frames = 1;
+    if (dicom_file.getDataset()
+            ->findAndGetSint32(DCM_NumberOfFrames, number_of_frames)
+            .bad() ||
+        number_of_frames < 1) {
+      number_of_frames = 1;
     }
+    // A negative frame_count selects all frames after frame_start.
+    int64 frameCount = frame_count_tensor.scalar<int64>()();
+    if (frameCount < 0) {
+      frameCount = number_of_frames - frame_start;
+    }
+    OP_REQUIRES(context,
+                frame_start + frameCount <= number_of_frames &&
+                    (frame_start < number_of_frames || frameCount == 0),
+                errors::InvalidArgument("frames [", frame_start, ", ",
+                                        frame_start + frameCount,
+                                        ") are out of range, the image has ",
+                                        number_of_frames, " frames"));
+
+    // Only the first requested frame is decoded here to get the image
+    // geometry, the remaining frames are decoded in parallel below.
+    std::unique_ptr<DicomImage> image = LoadDICOMFrames(
+        &dicom_file, std::min<int64>(frame_start, number_of_frames - 1), 1);
 
     unsigned long frameWidth = 0;
     unsigned long frameHeight = 0;
     unsigned int pixelDepth = 0;
-    unsigned long dataSize = 0;
-    unsigned long frameCount = 0;
     unsigned int samples_per_pixel = 0;
 
-    if ((image == NULL) || (image->getStatus() != EIS_Normal)) {
+    if ((image == nullptr) || (image->getStatus() != EIS_Normal)) {
       if (on_error_ == "strict") {
         OP_REQUIRES(context, false,
                     errors::InvalidArgument("Error loading image"));
@@ -168,8 +215,6 @@ class DecodeDICOMImageOp : public OpKernel {
     }
 
     // Get image information
-    frameCount = image->getFrameCount();  // getNumberOfFrames(); starts at
-                                          // version DCMTK-3.6.1_20140617
     frameWidth = image->getWidth();
     frameHeight = image->getHeight();
     pixelDepth = image->getDepth();
@@ -203,21 +248,89 @@ class DecodeDICOMImageOp : public OpKernel {
     Tensor *output_tensor = NULL;
     OP_REQUIRES_OK(context,
                    context->allocate_output(0, out_shape, &output_tensor));
+    if (frameCount == 0) {
+      return;
+    }
 
-    auto output_flat = output_tensor->template flat<dtype>();
-
-    unsigned long frame_pixel_count =
+    dtype *output = output_tensor->template flat<dtype>().data();
+    const unsigned long frame_pixel_count =
         frameHeight * frameWidth * samples_per_pixel;
 
-    for (Uint64 f = 0; f < frameCount; f++) {
-      const void *image_frame = image->getOutputData(pixelDepth, f);
+    if (frameCount == 1) {
+      OP_REQUIRES_OK(context, CopyFrames(image.get(), 1, pixelDepth,
+                                         frame_pixel_count, output));
+      return;
+    }
+    image.reset();
+
+    // DCMTK objects are not thread safe, so every shard loads its own copy
+    // of the file (the first one reuses the already parsed one) and decodes
+    // its frames independently.
+    std::vector<Status> status(frameCount);
+    auto decode = [&](int64 start, int64 limit) {
+      DcmFileFormat shard_file;
+      DcmFileFormat *file = &dicom_file;
+      if (start != 0) {
+        ReadDICOMFile(in_contents_scalar, &shard_file);
+        file = &shard_file;
+      }
+      std::unique_ptr<DicomImage> shard_image =
+          LoadDICOMFrames(file, frame_start + start, limit - start);
+      Status s;
+      if ((shard_image == nullptr) ||
+          (shard_image->getStatus() != EIS_Normal)) {
+        s = errors::InvalidArgument("Error loading frames [",
+                                    frame_start + start, ", ",
+                                    frame_start + limit, ")");
+      } else if (shard_image->getWidth() != frameWidth ||
+                 shard_image->getHeight() != frameHeight ||
+                 shard_image->getDepth() != pixelDepth) {
+        s = errors::InvalidArgument("frames [", frame_start + start, ", ",
+                                    frame_start + limit,
+                                    ") do not match the first frame");
+      } else {
+        s = CopyFrames(shard_image.get(), limit - start, pixelDepth,
+                       frame_pixel_count, output + start * frame_pixel_count);
+      }
+      for (int64 i = start; i < limit; i++) {
+        status[i] = s;
+      }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, frameCount,
+          frame_pixel_count * 100, decode);
+    for (const Status &s : status) {
+      OP_REQUIRES_OK(context, s);
+    }
+  }
 
+  // Copies the loaded frames of `image` into `output`. When the values are
+  // preserved and the pixel depth fits the output dtype DCMTK renders
+  // straight into the output, otherwise every value is converted.
+  Status CopyFrames(DicomImage *image, int64 frames, unsigned int pixelDepth,
+                    unsigned long frame_pixel_count, dtype *output) {
+    const size_t depth_bytes = pixelDepth <= 8 ? 1 : pixelDepth <= 16 ? 2 : 4;
+    const bool native = std::is_integral<dtype>::value &&
+                        sizeof(dtype) == depth_bytes && scale_ == "preserve";
+    for (int64 f = 0; f < frames; f++) {
+      dtype *frame_output = output + f * frame_pixel_count;
+      if (native) {
+        if (!image->getOutputData(frame_output,
+                                  frame_pixel_count * sizeof(dtype),
+                                  pixelDepth, f)) {
+          return errors::InvalidArgument("unable to render frame ", f);
+        }
+        continue;
+      }
+      const void *image_frame = image->getOutputData(pixelDepth, f);
+      if (image_frame == nullptr) {
+        return errors::InvalidArgument("unable to render frame ", f);
+      }
       for (Uint64 p = 0; p < frame_pixel_count; p++) {
-        output_flat(f * frame_pixel_count + p) =
-            convert_uintn_to_t(image_frame, pixelDepth, p);
+        frame_output[p] = convert_uintn_to_t(image_frame, pixelDepth, p);
       }
     }
-    delete image;
+    return OkStatus();
   }
 
   dtype convert_uintn_to_t(const void *buff, unsigned int n_bits,
@@ -15,12 +15,58 @@ limitations under the License.
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
+#include "tensorflow_io/core/kernels/image_kernels.h"
 #include "tensorflow_io/core/kernels/io_stream.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 namespace tensorflow {
 namespace io {
+
+Status DecodeHDRImage(StringPiece contents, DataType dtype,
+                      const ImageAllocateFunc& allocate_func) {
+  if (dtype != DT_FLOAT) {
+    return errors::InvalidArgument("HDR only decodes to float, got ",
+                                   DataTypeString(dtype));
+  }
+  if (!stbi_is_hdr_from_memory((const unsigned char*)contents.data(),
+                               contents.size())) {
+    return errors::InvalidArgument("not a hdr file");
+  }
+
+  std::unique_ptr<float, void (*)(float*)> data(nullptr, [](float* p) {
+    if (p != nullptr) {
+      stbi_image_free(p);
+    }
+  });
+
+  int desired_channels = 3;
+  int x, y, channels_in_file;
+  data.reset(stbi_loadf_from_memory((const unsigned char*)contents.data(),
+                                    contents.size(), &x, &y, &channels_in_file,
+                                    desired_channels));
+
+  if (data.get() == nullptr) {
+    return errors::InvalidArgument("unable to open as a hdr file");
+  }
+  if (x == 0 || y == 0 || channels_in_file != 3) {
+    return errors::InvalidArgument("invalid shape: (", x, ", ", y, ", ",
+                                   channels_in_file, ")");
+  }
+
+  int64 channels = static_cast<int64>(channels_in_file);
+  int64 height = static_cast<int64>(y);
+  int64 width = static_cast<int64>(x);
+
+  void* buffer = nullptr;
+  TF_RETURN_IF_ERROR(
+      allocate_func(TensorShape({height, width, channels}), &buffer));
+
+  // Check padding?
+  memcpy(buffer, data.get(), height * width * channels * sizeof(float));
+  return OkStatus();
+}
+
 namespace {
 
 class DecodeHDROp : public OpKernel {
@@ -33,43 +79,9 @@ class DecodeHDROp : public OpKernel {
     const Tensor* input_tensor;
     OP_REQUIRES_OK(context, context->input("input", &input_tensor));
 
-    string input = input_tensor->scalar<tstring>()();
-    OP_REQUIRES(context,
-                stbi_is_hdr_from_memory((const unsigned char*)input.data(),
-                                        input.size()),
-                errors::InvalidArgument("not a hdr file"));
-
-    std::unique_ptr<float, void (*)(float*)> data(nullptr, [](float* p) {
-      if (p != nullptr) {
-        stbi_image_free(p);
-      }
-    });
-
-    int desired_channels = 3;
-    int x, y, channels_in_file;
-    data.reset(stbi_loadf_from_memory((const unsigned char*)input.data(),
-                                      input.size(), &x, &y, &channels_in_file,
-                                      desired_channels));
-
-    OP_REQUIRES(context, (data.get() != nullptr),
-                errors::InvalidArgument("unable to open as a hdr file"));
-    OP_REQUIRES(context, (x != 0 && y != 0 && channels_in_file == 3),
-                errors::InvalidArgument("invalid shape: (", x, ", ", y, ", ",
-                                        channels_in_file, ")"));
-
-    int64 channels = static_cast<int64>(channels_in_file);
-    int64 height = static_cast<int64>(y);
-    int64 width = static_cast<int64>(x);
-
-    Tensor* image_tensor = nullptr;
-    OP_REQUIRES_OK(
-        context, context->allocate_output(
-                     0, TensorShape({height, width, channels}), &image_tensor));
-    auto image = image_tensor->shaped<float, 3>({height, width, channels});
-
-    // Check padding?
-    memcpy(image_tensor->flat<float>().data(), data.get(),
-           height * width * channels * sizeof(float));
+    const StringPiece input = input_tensor->scalar<tstring>()();
+    OP_REQUIRES_OK(context, DecodeHDRImage(input, DT_FLOAT,
+                                           ImageOutputAllocator(context, 0)));
   }
 
  private:
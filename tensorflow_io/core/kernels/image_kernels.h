@@ -0,0 +1,58 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_IO_CORE_KERNELS_IMAGE_KERNELS_H_
+#define TENSORFLOW_IO_CORE_KERNELS_IMAGE_KERNELS_H_
+
+#include "tensorflow/core/framework/op_kernel.h"
+
+namespace tensorflow {
+namespace io {
+
+// Called by the decoders once the [height, width, channels] shape of the image
+// is known. Returns the buffer the pixels are decoded into, which holds
+// shape.num_elements() values of the requested dtype in row-major order.
+typedef std::function<Status(const TensorShape& shape, void** buffer)>
+    ImageAllocateFunc;
+
+// Decodes straight into output `index` of `context`, used by the single image
+// ops.
+inline ImageAllocateFunc ImageOutputAllocator(OpKernelContext* context,
+                                              int index) {
+  return [context, index](const TensorShape& shape, void** buffer) -> Status {
+    Tensor* output_tensor = nullptr;
+    TF_RETURN_IF_ERROR(context->allocate_output(index, shape, &output_tensor));
+    *buffer = output_tensor->data();
+    return OkStatus();
+  };
+}
+
+// Decoders shared by the single image and the batched ops. `contents` is read
+// in place and is not copied.
+Status DecodeWebPImage(StringPiece contents, DataType dtype,
+                       const ImageAllocateFunc& allocate_func);
+Status DecodeAVIFImage(StringPiece contents, DataType dtype,
+                       const ImageAllocateFunc& allocate_func);
+Status DecodeHDRImage(StringPiece contents, DataType dtype,
+                      const ImageAllocateFunc& allocate_func);
+Status DecodePNMImage(StringPiece contents, DataType dtype,
+                      const ImageAllocateFunc& allocate_func);
+Status DecodeJPEG2KImage(StringPiece contents, DataType dtype,
+                         const ImageAllocateFunc& allocate_func);
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_IO_CORE_KERNELS_IMAGE_KERNELS_H_
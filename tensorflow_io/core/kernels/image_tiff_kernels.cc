@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "geotiff.h"
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 // Repackge XTIFFStreamOpen from TIFFStreamOpen in libtiff/tif_stream.cxx
 extern "C" {
@@ -281,6 +282,146 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+// Read only TIFF client over an in memory buffer. The buffer is also handed
+// out through the map procs, so libtiff reads strips and tiles in place
+// instead of copying the whole file into a stream first.
+class TIFFMemoryStream {
+ public:
+  explicit TIFFMemoryStream(StringPiece contents)
+      : contents_(contents), offset_(0) {}
+
+  static tmsize_t ReadProc(thandle_t handle, void* buffer, tmsize_t size) {
+    TIFFMemoryStream* p = reinterpret_cast<TIFFMemoryStream*>(handle);
+    if (size < 0) {
+      return static_cast<tmsize_t>(-1);
+    }
+    uint64 remaining =
+        (p->offset_ < p->contents_.size()) ? p->contents_.size() - p->offset_
+                                           : 0;
+    uint64 bytes = std::min(static_cast<uint64>(size), remaining);
+    memcpy(buffer, p->contents_.data() + p->offset_, bytes);
+    p->offset_ += bytes;
+    return static_cast<tmsize_t>(bytes);
+  }
+  static tmsize_t WriteProc(thandle_t, void*, tmsize_t) { return 0; }
+  static toff_t SeekProc(thandle_t handle, toff_t offset, int whence) {
+    TIFFMemoryStream* p = reinterpret_cast<TIFFMemoryStream*>(handle);
+    switch (whence) {
+      case SEEK_SET:
+        p->offset_ = offset;
+        break;
+      case SEEK_CUR:
+        p->offset_ += static_cast<int64>(offset);
+        break;
+      case SEEK_END:
+        p->offset_ = p->contents_.size() + static_cast<int64>(offset);
+        break;
+      default:
+        return static_cast<toff_t>(-1);
+    }
+    return p->offset_;
+  }
+  static int CloseProc(thandle_t) { return 0; }
+  static toff_t SizeProc(thandle_t handle) {
+    return reinterpret_cast<TIFFMemoryStream*>(handle)->contents_.size();
+  }
+  static int MapProc(thandle_t handle, void** base, toff_t* size) {
+    TIFFMemoryStream* p = reinterpret_cast<TIFFMemoryStream*>(handle);
+    *base = const_cast<char*>(p->contents_.data());
+    *size = p->contents_.size();
+    return 1;
+  }
+  static void UnmapProc(thandle_t, void*, toff_t) {}
+
+ private:
+  StringPiece contents_;
+  uint64 offset_;
+};
+
+void CloseTIFF(TIFF* p) {
+  if (p != nullptr) {
+    XTIFFClose(p);
+  }
+}
+
+// Opens directory `index` of the TIFF held by `stream`. `stream` has to
+// outlive the returned handle.
+Status OpenTIFFMemory(TIFFMemoryStream* stream, int64 index,
+                      std::unique_ptr<TIFF, void (*)(TIFF*)>* tiff) {
+  tiff->reset(XTIFFClientOpen(
+      "memory", "r", reinterpret_cast<thandle_t>(stream),
+      TIFFMemoryStream::ReadProc, TIFFMemoryStream::WriteProc,
+      TIFFMemoryStream::SeekProc, TIFFMemoryStream::CloseProc,
+      TIFFMemoryStream::SizeProc, TIFFMemoryStream::MapProc,
+      TIFFMemoryStream::UnmapProc));
+  if (tiff->get() == nullptr) {
+    return errors::InvalidArgument("unable to open TIFF from memory");
+  }
+  if (!TIFFSetDirectory(tiff->get(), index)) {
+    return errors::InvalidArgument("unable to set TIFF directory to ", index);
+  }
+  // Let libjpeg convert subsampled YCbCr so samples come out as RGB.
+  unsigned short compression, photometric;
+  TIFFGetFieldDefaulted(tiff->get(), TIFFTAG_COMPRESSION, &compression);
+  TIFFGetFieldDefaulted(tiff->get(), TIFFTAG_PHOTOMETRIC, &photometric);
+  if (compression == COMPRESSION_JPEG && photometric == PHOTOMETRIC_YCBCR) {
+    TIFFSetField(tiff->get(), TIFFTAG_JPEGCOLORMODE, JPEGCOLORMODE_RGB);
+  }
+  return OkStatus();
+}
+
+// Maps the sample format and bit depth of the current directory to a dtype.
+Status TIFFSampleDataType(TIFF* tiff, DataType* dtype) {
+  unsigned short format, bits;
+  if (!TIFFGetField(tiff, TIFFTAG_SAMPLEFORMAT, &format)) {
+    // If format is not defined, then we assume format is SAMPLEFORMAT_UINT
+    format = SAMPLEFORMAT_UINT;
+  }
+  TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bits);
+  switch (format) {
+    case SAMPLEFORMAT_UINT:
+      switch (bits) {
+        case 8:
+          *dtype = DT_UINT8;
+          return OkStatus();
+        case 16:
+          *dtype = DT_UINT16;
+          return OkStatus();
+        case 32:
+          *dtype = DT_UINT32;
+          return OkStatus();
+      }
+      return errors::InvalidArgument("unsupported bits ", bits, " for uint");
+    case SAMPLEFORMAT_INT:
+      switch (bits) {
+        case 8:
+          *dtype = DT_INT8;
+          return OkStatus();
+        case 16:
+          *dtype = DT_INT16;
+          return OkStatus();
+        case 32:
+          *dtype = DT_INT32;
+          return OkStatus();
+      }
+      return errors::InvalidArgument("unsupported bits ", bits, " for int");
+    case SAMPLEFORMAT_IEEEFP:
+      switch (bits) {
+        case 16:
+          *dtype = DT_HALF;
+          return OkStatus();
+        case 32:
+          *dtype = DT_FLOAT;
+          return OkStatus();
+        case 64:
+          *dtype = DT_DOUBLE;
+          return OkStatus();
+      }
+      return errors::InvalidArgument("unsupported bits ", bits, " for fp");
+  }
+  return errors::InvalidArgument("unsupported format ", format);
+}
+
 class DecodeTIFFInfoOp : public OpKernel {
  public:
   explicit DecodeTIFFInfoOp(OpKernelConstruction* context)
@@ -316,51 +457,8 @@ class DecodeTIFFInfoOp : public OpKernel {
           TensorShape({static_cast<int64>(height), static_cast<int64>(width),
                        static_cast<int64>(channels)}));
 
-      unsigned short format, bits;
-      if (!TIFFGetField(tiff.get(), TIFFTAG_SAMPLEFORMAT, &format)) {
-        // If format is not defined, then we assume format is SAMPLEFORMAT_UINT
-        format = SAMPLEFORMAT_UINT;
-      }
-      TIFFGetField(tiff.get(), TIFFTAG_BITSPERSAMPLE, &bits);
       DataType pixel_dtype;
-      switch (format) {
-        case SAMPLEFORMAT_UINT:
-          switch (bits) {
-            case 8:
-              pixel_dtype = DT_UINT8;
-              break;
-            case 16:
-              pixel_dtype = DT_UINT16;
-              break;
-            default:
-              OP_REQUIRES(context, false,
-                          errors::InvalidArgument("unsupported bits ", bits,
-                                                  " for uint"));
-          }
-          break;
-        case SAMPLEFORMAT_INT:
-          switch (bits) {
-            default:
-              OP_REQUIRES(context, false,
-                          errors::InvalidArgument("unsupported bits ", bits,
-                                                  " for int"));
-          }
-          break;
-        case SAMPLEFORMAT_IEEEFP:
-          switch (bits) {
-            case 16:
-              pixel_dtype = DT_HALF;
-              break;
-            default:
-              OP_REQUIRES(context, false,
-                          errors::InvalidArgument("unsupported bits ", bits,
-                                                  " for fp"));
-          }
-          break;
-        default:
-          OP_REQUIRES(context, false,
-                      errors::InvalidArgument("unsupported format ", format));
-      }
+      OP_REQUIRES_OK(context, TIFFSampleDataType(tiff.get(), &pixel_dtype));
       dtype.push_back(pixel_dtype);
 
       // GeoTIFF specifi information
@@ -444,9 +542,203 @@ class DecodeTIFFOp : public OpKernel {
   // TODO (yongtang): Set channels_ = 4 for now.
   static const int channels_ = 4;
 };
+// Decodes a [height, width] window at `offset` of directory `index` in the
+// native sample dtype and channel count. Only the tiles (or strips) that
+// intersect the window are read, and they are decoded in parallel with one
+// TIFF handle per shard as libtiff handles are not thread safe. Samples are
+// returned in file order, the orientation tag is not applied.
+class DecodeTIFFRegionOp : public OpKernel {
+ public:
+  explicit DecodeTIFFRegionOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("dtype", &dtype_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    const Tensor* index_tensor;
+    OP_REQUIRES_OK(context, context->input("index", &index_tensor));
+    const Tensor* offset_tensor;
+    OP_REQUIRES_OK(context, context->input("offset", &offset_tensor));
+    const Tensor* size_tensor;
+    OP_REQUIRES_OK(context, context->input("size", &size_tensor));
+    OP_REQUIRES(context, offset_tensor->NumElements() == 2,
+                errors::InvalidArgument("offset must be [y, x], got shape ",
+                                        offset_tensor->shape().DebugString()));
+    OP_REQUIRES(context, size_tensor->NumElements() == 2,
+                errors::InvalidArgument(
+                    "size must be [height, width], got shape ",
+                    size_tensor->shape().DebugString()));
+
+    const StringPiece contents = input_tensor->scalar<tstring>()();
+    const int64 index = index_tensor->scalar<int64>()();
+
+    TIFFMemoryStream stream(contents);
+    std::unique_ptr<TIFF, void (*)(TIFF*)> tiff(nullptr, CloseTIFF);
+    OP_REQUIRES_OK(context, OpenTIFFMemory(&stream, index, &tiff));
+
+    unsigned int height = 0, width = 0;
+    TIFFGetField(tiff.get(), TIFFTAG_IMAGELENGTH, &height);
+    TIFFGetField(tiff.get(), TIFFTAG_IMAGEWIDTH, &width);
+    unsigned short channels, planar;
+    TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_SAMPLESPERPIXEL, &channels);
+    TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_PLANARCONFIG, &planar);
+
+    DataType dtype;
+    OP_REQUIRES_OK(context, TIFFSampleDataType(tiff.get(), &dtype));
+    OP_REQUIRES(context, dtype == dtype_,
+                errors::InvalidArgument(
+                    "TIFF directory ", index, " holds ", DataTypeString(dtype),
+                    " samples, but ", DataTypeString(dtype_), " requested"));
+
+    unsigned short compression, photometric;
+    TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_COMPRESSION, &compression);
+    TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_PHOTOMETRIC, &photometric);
+    if (photometric == PHOTOMETRIC_YCBCR && compression != COMPRESSION_JPEG) {
+      unsigned short subsampling_h, subsampling_v;
+      TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_YCBCRSUBSAMPLING,
+                            &subsampling_h, &subsampling_v);
+      OP_REQUIRES(context, subsampling_h == 1 && subsampling_v == 1,
+                  errors::Unimplemented("subsampled YCbCr is not supported"));
+    }
+
+    // A negative size extends the window to the edge of the image.
+    const int64 y = offset_tensor->flat<int64>()(0);
+    const int64 x = offset_tensor->flat<int64>()(1);
+    int64 h = size_tensor->flat<int64>()(0);
+    int64 w = size_tensor->flat<int64>()(1);
+    if (h < 0) {
+      h = height - y;
+    }
+    if (w < 0) {
+      w = width - x;
+    }
+    OP_REQUIRES(context,
+                y >= 0 && x >= 0 && h >= 0 && w >= 0 && y + h <= height &&
+                    x + w <= width,
+                errors::InvalidArgument("region [", y, ", ", x, "] + [", h,
+                                        ", ", w, "] is outside of the ",
+                                        height, "x", width, " image"));
+
+    Tensor* image_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({h, w, channels}),
+                                &image_tensor));
+    if (h == 0 || w == 0) {
+      return;
+    }
+
+    const bool tiled = TIFFIsTiled(tiff.get());
+    unsigned int chunk_h, chunk_w;
+    if (tiled) {
+      TIFFGetField(tiff.get(), TIFFTAG_TILELENGTH, &chunk_h);
+      TIFFGetField(tiff.get(), TIFFTAG_TILEWIDTH, &chunk_w);
+    } else {
+      TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_ROWSPERSTRIP, &chunk_h);
+      chunk_h = std::min(chunk_h, height);
+      chunk_w = width;
+    }
+    OP_REQUIRES(context, chunk_h > 0 && chunk_w > 0,
+                errors::InvalidArgument("invalid ", tiled ? "tile" : "strip",
+                                        " size ", chunk_h, "x", chunk_w));
+    const int64 chunk_bytes =
+        tiled ? TIFFTileSize(tiff.get()) : TIFFStripSize(tiff.get());
+
+    // With separate planes every chunk holds a single sample per pixel.
+    const int64 planes = (planar == PLANARCONFIG_SEPARATE) ? channels : 1;
+    const int64 samples = (planar == PLANARCONFIG_SEPARATE) ? 1 : channels;
+    const int64 element_size = DataTypeSize(dtype);
+    const int64 chunk_stride = chunk_w * samples * element_size;
+    OP_REQUIRES(context, chunk_bytes >= chunk_h * chunk_stride,
+                errors::InvalidArgument("unexpected ", chunk_bytes,
+                                        " bytes per ",
+                                        tiled ? "tile" : "strip"));
+
+    struct Chunk {
+      int64 y, x, plane;
+    };
+    std::vector<Chunk> chunks;
+    for (int64 cy = y / chunk_h * chunk_h; cy < y + h; cy += chunk_h) {
+      for (int64 cx = x / chunk_w * chunk_w; cx < x + w; cx += chunk_w) {
+        for (int64 plane = 0; plane < planes; plane++) {
+          chunks.push_back({cy, cx, plane});
+        }
+      }
+    }
+
+    char* output = static_cast<char*>(image_tensor->data());
+    std::vector<Status> status(chunks.size());
+    auto decode = [&](int64 start, int64 limit) {
+      TIFFMemoryStream local_stream(contents);
+      std::unique_ptr<TIFF, void (*)(TIFF*)> local(nullptr, CloseTIFF);
+      Status s = OpenTIFFMemory(&local_stream, index, &local);
+      if (!s.ok()) {
+        for (int64 i = start; i < limit; i++) {
+          status[i] = s;
+        }
+        return;
+      }
+      std::unique_ptr<char[]> buffer(new char[chunk_bytes]);
+      for (int64 i = start; i < limit; i++) {
+        const Chunk& chunk = chunks[i];
+        const int64 y0 = std::max(chunk.y, y);
+        const int64 y1 = std::min(chunk.y + chunk_h, y + h);
+        const int64 x0 = std::max(chunk.x, x);
+        const int64 x1 = std::min(chunk.x + chunk_w, x + w);
+
+        tmsize_t bytes;
+        if (tiled) {
+          bytes = TIFFReadEncodedTile(
+              local.get(),
+              TIFFComputeTile(local.get(), chunk.x, chunk.y, 0, chunk.plane),
+              buffer.get(), chunk_bytes);
+        } else {
+          bytes = TIFFReadEncodedStrip(
+              local.get(), TIFFComputeStrip(local.get(), chunk.y, chunk.plane),
+              buffer.get(), chunk_bytes);
+        }
+        // The last strip may be short, but has to cover the window.
+        if (bytes < (y1 - chunk.y) * chunk_stride) {
+          status[i] = errors::DataLoss("unable to read ",
+                                       tiled ? "tile" : "strip", " at [",
+                                       chunk.y, ", ", chunk.x, "]");
+          continue;
+        }
+
+        for (int64 row = y0; row < y1; row++) {
+          const char* src = buffer.get() + (row - chunk.y) * chunk_stride +
+                            (x0 - chunk.x) * samples * element_size;
+          char* dst = output + ((row - y) * w + (x0 - x)) * channels *
+                                   element_size;
+          if (samples == channels) {
+            memcpy(dst, src, (x1 - x0) * channels * element_size);
+            continue;
+          }
+          for (int64 col = 0; col < x1 - x0; col++) {
+            memcpy(dst + (col * channels + chunk.plane) * element_size,
+                   src + col * element_size, element_size);
+          }
+        }
+      }
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, chunks.size(),
+          chunk_bytes * 10, decode);
+    for (const Status& s : status) {
+      OP_REQUIRES_OK(context, s);
+    }
+  }
+
+ private:
+  DataType dtype_;
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeTiffInfo").Device(DEVICE_CPU),
                         DecodeTIFFInfoOp);
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeTiff").Device(DEVICE_CPU), DecodeTIFFOp);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeTiffRegion").Device(DEVICE_CPU),
+                        DecodeTIFFRegionOp);
 
 }  // namespace
 }  // namespace data
@@ -18,10 +18,53 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/platform/file_system.h"
+#include "tensorflow_io/core/kernels/image_kernels.h"
 #include "webp/encode.h"
 
 namespace tensorflow {
 namespace io {
+
+Status DecodeWebPImage(StringPiece contents, DataType dtype,
+                       const ImageAllocateFunc& allocate_func) {
+  // TODO (yongtang): Set channels = 4 for now.
+  static const int channels = 4;
+  if (dtype != DT_UINT8) {
+    return errors::InvalidArgument("WebP only decodes to uint8, got ",
+                                   DataTypeString(dtype));
+  }
+
+  WebPDecoderConfig config;
+  WebPInitDecoderConfig(&config);
+  int returned =
+      WebPGetFeatures(reinterpret_cast<const uint8_t*>(contents.data()),
+                      contents.size(), &config.input);
+  if (returned != VP8_STATUS_OK) {
+    return errors::InvalidArgument("contents could not be decoded as WebP: ",
+                                   returned);
+  }
+
+  int height = config.input.height;
+  int width = config.input.width;
+
+  void* buffer = nullptr;
+  TF_RETURN_IF_ERROR(
+      allocate_func(TensorShape({height, width, channels}), &buffer));
+
+  config.output.colorspace = MODE_RGBA;
+  config.output.u.RGBA.rgba = static_cast<uint8_t*>(buffer);
+  config.output.u.RGBA.stride = width * channels;
+  config.output.u.RGBA.size = height * width * channels;
+  config.output.is_external_memory = 1;
+
+  returned = DecodeWebP(reinterpret_cast<const uint8_t*>(contents.data()),
+                        contents.size(), &config);
+  if (returned != 0) {
+    return errors::InvalidArgument("contents could not be decoded as WebP: ",
+                                   returned);
+  }
+  return OkStatus();
+}
+
 namespace {
 
 class DecodeWebPOp : public OpKernel {
@@ -33,41 +76,11 @@ class DecodeWebPOp : public OpKernel {
     OP_REQUIRES(context, TensorShapeUtils::IsScalar(contents_tensor.shape()),
                 errors::InvalidArgument("contents must be scalar, got shape ",
                                         contents_tensor.shape().DebugString()));
-    auto contents = contents_tensor.scalar<tstring>()();
-
-    WebPDecoderConfig config;
-    WebPInitDecoderConfig(&config);
-    int returned =
-        WebPGetFeatures(reinterpret_cast<const uint8_t*>(contents.data()),
-                        contents.size(), &config.input);
-    OP_REQUIRES(context, returned == VP8_STATUS_OK,
-                errors::InvalidArgument(
-                    "contents could not be decoded as WebP: ", returned));
-
-    int height = config.input.height;
-    int width = config.input.width;
-
-    Tensor* output_tensor = nullptr;
-    OP_REQUIRES_OK(context, context->allocate_output(
-                                0, TensorShape({height, width, channels_}),
-                                &output_tensor));
-
-    config.output.colorspace = MODE_RGBA;
-    config.output.u.RGBA.rgba = output_tensor->flat<uint8_t>().data();
-    config.output.u.RGBA.stride = width * channels_;
-    config.output.u.RGBA.size = height * width * channels_;
-    config.output.is_external_memory = 1;
-
-    returned = DecodeWebP(reinterpret_cast<const uint8_t*>(contents.data()),
-                          contents.size(), &config);
-    OP_REQUIRES(context, returned == 0,
-                errors::InvalidArgument(
-                    "contents could not be decoded as WebP: ", returned));
-  }
+    const StringPiece contents = contents_tensor.scalar<tstring>()();
 
- private:
-  // TODO (yongtang): Set channels_ = 4 for now.
-  static const int channels_ = 4;
+    OP_REQUIRES_OK(context, DecodeWebPImage(contents, DT_UINT8,
+                                            ImageOutputAllocator(context, 0)));
+  }
 };
 REGISTER_KERNEL_BUILDER(Name("IO>DecodeWebP").Device(DEVICE_CPU), DecodeWebPOp);
 
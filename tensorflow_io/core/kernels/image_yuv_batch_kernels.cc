@@ -0,0 +1,417 @@
+/* Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "libyuv/convert_argb.h"
+#include "libyuv/convert_from_argb.h"
+#include "libyuv/planar_functions.h"
+#include "libyuv/scale.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace io {
+namespace {
+
+enum YUVFormat { kYUVFormatNV12, kYUVFormatYUY2, kYUVFormatI420 };
+
+// Rough per output pixel cost of crop, scale and color conversion, used to
+// size the shards.
+constexpr int64 kConvertCostPerPixel = 64;
+
+// Planar Y, U and V views of the cropped region of one frame. Chroma is
+// either 4:2:0 (NV12, I420) or 4:2:2 (YUY2) subsampled.
+struct YUVPlanes {
+  const uint8* y;
+  const uint8* u;
+  const uint8* v;
+  int y_stride;
+  int uv_stride;
+  int uv_width;
+  int uv_height;
+};
+
+// Converts a 1-D batch of raw NV12, YUY2 or I420 frames of the same `size`
+// into a [batch, height, width, 3] (NHWC) or [batch, 3, height, width]
+// (NCHW) RGB or BGR tensor. Crop, scale, color conversion and layout are
+// done frame by frame in one pass on the CPU worker threads: frames are
+// cropped in place, scaled in YUV space with libyuv (so the chroma planes
+// are only a quarter of the work), converted with libyuv's SIMD row
+// functions and written straight into the output. Without resize an NHWC
+// uint8 NV12 frame is converted directly into the output.
+template <YUVFormat Format>
+class DecodeYUVBatchOp : public OpKernel {
+ public:
+  explicit DecodeYUVBatchOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("crop", &crop_));
+    OP_REQUIRES(context, crop_.empty() || crop_.size() == 4,
+                errors::InvalidArgument(
+                    "crop must be empty or [offset_height, offset_width, "
+                    "target_height, target_width], got ",
+                    crop_.size(), " elements"));
+    OP_REQUIRES(context,
+                crop_.empty() || (crop_[0] >= 0 && crop_[1] >= 0 &&
+                                  crop_[2] > 0 && crop_[3] > 0),
+                errors::InvalidArgument("crop is invalid"));
+    // Chroma is shared by 2x2 (or 2x1 for YUY2) pixels so the crop has to
+    // start on a chroma sample.
+    OP_REQUIRES(context,
+                crop_.empty() || (crop_[0] % 2 == 0 && crop_[1] % 2 == 0),
+                errors::InvalidArgument("crop offsets must be even, got [",
+                                        crop_[0], ", ", crop_[1], "]"));
+    OP_REQUIRES_OK(context, context->GetAttr("resize", &resize_));
+    OP_REQUIRES(context, resize_.empty() || resize_.size() == 2,
+                errors::InvalidArgument(
+                    "resize must be empty or [height, width], got ",
+                    resize_.size(), " elements"));
+    OP_REQUIRES(context,
+                resize_.empty() || (resize_[0] > 0 && resize_[1] > 0),
+                errors::InvalidArgument("resize must be positive, got [",
+                                        resize_[0], ", ", resize_[1], "]"));
+    string channel_order;
+    OP_REQUIRES_OK(context, context->GetAttr("channel_order", &channel_order));
+    bgr_ = (channel_order == "BGR");
+    string data_format;
+    OP_REQUIRES_OK(context, context->GetAttr("data_format", &data_format));
+    nchw_ = (data_format == "NCHW");
+    OP_REQUIRES_OK(context, context->GetAttr("dtype", &dtype_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(input_tensor->shape()),
+                errors::InvalidArgument("input must be 1-D, got shape ",
+                                        input_tensor->shape().DebugString()));
+
+    const Tensor* size_tensor;
+    OP_REQUIRES_OK(context, context->input("size", &size_tensor));
+    OP_REQUIRES(context, size_tensor->NumElements() == 2,
+                errors::InvalidArgument("size must be [height, width], got ",
+                                        size_tensor->NumElements(),
+                                        " elements"));
+    const int64 frame_height = size_tensor->flat<int32>()(0);
+    const int64 frame_width = size_tensor->flat<int32>()(1);
+    OP_REQUIRES(context,
+                frame_height > 0 && frame_width > 0 &&
+                    frame_height % 2 == 0 && frame_width % 2 == 0,
+                errors::InvalidArgument(
+                    "size must be positive and even, got [", frame_height,
+                    ", ", frame_width, "]"));
+
+    int64 crop_y = 0, crop_x = 0;
+    int64 crop_height = frame_height, crop_width = frame_width;
+    if (!crop_.empty()) {
+      crop_y = crop_[0];
+      crop_x = crop_[1];
+      crop_height = crop_[2];
+      crop_width = crop_[3];
+      OP_REQUIRES(context,
+                  crop_y + crop_height <= frame_height &&
+                      crop_x + crop_width <= frame_width,
+                  errors::InvalidArgument(
+                      "crop [", crop_y, ", ", crop_x, ", ", crop_height, ", ",
+                      crop_width, "] is out of the frame [", frame_height,
+                      ", ", frame_width, "]"));
+    }
+    const int64 height = resize_.empty() ? crop_height : resize_[0];
+    const int64 width = resize_.empty() ? crop_width : resize_[1];
+
+    const auto input = input_tensor->flat<tstring>();
+    const int64 batch = input.size();
+    const int64 frame_bytes = (Format == kYUVFormatYUY2)
+                                  ? frame_height * frame_width * 2
+                                  : frame_height * frame_width * 3 / 2;
+    for (int64 i = 0; i < batch; i++) {
+      OP_REQUIRES(context, input(i).size() == frame_bytes,
+                  errors::InvalidArgument("frame ", i, " has ",
+                                          input(i).size(), " bytes, expected ",
+                                          frame_bytes));
+    }
+
+    Tensor* output_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(
+            0,
+            nchw_ ? TensorShape({batch, 3, height, width})
+                  : TensorShape({batch, height, width, 3}),
+            &output_tensor));
+    if (batch == 0) {
+      return;
+    }
+
+    Frame frame;
+    frame.height = frame_height;
+    frame.width = frame_width;
+    frame.crop_y = crop_y;
+    frame.crop_x = crop_x;
+    frame.crop_height = crop_height;
+    frame.crop_width = crop_width;
+    frame.out_height = height;
+    frame.out_width = width;
+
+    const int64 image_bytes = height * width * 3 * DataTypeSize(dtype_);
+    char* data = static_cast<char*>(output_tensor->data());
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    std::vector<Status> status(batch);
+    Shard(worker_threads->num_threads, worker_threads->workers, batch,
+          (crop_height * crop_width + height * width) * kConvertCostPerPixel,
+          [&](int64 start, int64 limit) {
+            // Scratch buffers are reused by all frames of the shard.
+            Scratch scratch;
+            for (int64 i = start; i < limit; i++) {
+              status[i] = Convert(
+                  frame, reinterpret_cast<const uint8*>(input(i).data()),
+                  &scratch, data + i * image_bytes);
+            }
+          });
+    for (int64 i = 0; i < batch; i++) {
+      OP_REQUIRES_OK(context, status[i]);
+    }
+  }
+
+ private:
+  struct Scratch {
+    std::vector<uint8> planes;
+    std::vector<uint8> scaled;
+    std::vector<uint8> argb;
+  };
+
+  struct Frame {
+    int64 height;
+    int64 width;
+    int64 crop_y;
+    int64 crop_x;
+    int64 crop_height;
+    int64 crop_width;
+    int64 out_height;
+    int64 out_width;
+  };
+
+  // Returns planar views of the cropped region of `src`. I420 and the luma
+  // of NV12 are read in place, the NV12 chroma and all of YUY2 are split
+  // into `scratch`.
+  YUVPlanes CropPlanes(const Frame& f, const uint8* src,
+                       std::vector<uint8>* scratch) {
+    YUVPlanes planes;
+    const int64 uv_frame_width = f.width / 2;
+    const int64 uv_frame_height = f.height / 2;
+    planes.uv_width = (f.crop_width + 1) / 2;
+    planes.uv_height = (Format == kYUVFormatYUY2) ? f.crop_height
+                                                  : (f.crop_height + 1) / 2;
+    switch (Format) {
+      case kYUVFormatI420: {
+        const uint8* u = src + f.height * f.width;
+        const uint8* v = u + uv_frame_height * uv_frame_width;
+        const int64 uv_offset =
+            (f.crop_y / 2) * uv_frame_width + f.crop_x / 2;
+        planes.y = src + f.crop_y * f.width + f.crop_x;
+        planes.u = u + uv_offset;
+        planes.v = v + uv_offset;
+        planes.y_stride = f.width;
+        planes.uv_stride = uv_frame_width;
+        break;
+      }
+      case kYUVFormatNV12: {
+        const uint8* uv = src + f.height * f.width;
+        const int64 uv_size = planes.uv_width * planes.uv_height;
+        scratch->resize(uv_size * 2);
+        uint8* u = scratch->data();
+        uint8* v = u + uv_size;
+        libyuv::SplitUVPlane(uv + (f.crop_y / 2) * f.width + f.crop_x,
+                             f.width, u, planes.uv_width, v, planes.uv_width,
+                             planes.uv_width, planes.uv_height);
+        planes.y = src + f.crop_y * f.width + f.crop_x;
+        planes.u = u;
+        planes.v = v;
+        planes.y_stride = f.width;
+        planes.uv_stride = planes.uv_width;
+        break;
+      }
+      case kYUVFormatYUY2: {
+        const int64 y_size = f.crop_height * f.crop_width;
+        const int64 uv_size = planes.uv_width * planes.uv_height;
+        scratch->resize(y_size + uv_size * 2);
+        uint8* y = scratch->data();
+        uint8* u = y + y_size;
+        uint8* v = u + uv_size;
+        libyuv::YUY2ToI422(src + (f.crop_y * f.width + f.crop_x) * 2,
+                           f.width * 2, y, f.crop_width, u, planes.uv_width,
+                           v, planes.uv_width, f.crop_width, f.crop_height);
+        planes.y = y;
+        planes.u = u;
+        planes.v = v;
+        planes.y_stride = f.crop_width;
+        planes.uv_stride = planes.uv_width;
+        break;
+      }
+    }
+    return planes;
+  }
+
+  // Converts the cropped region of `src` into ARGB (B, G, R, A in memory).
+  // Without scaling NV12 and YUY2 are converted straight from the frame,
+  // otherwise the planes are scaled to the output size first; scaling the
+  // 4:2:2 YUY2 chroma to 4:2:0 happens in the same pass.
+  Status ConvertToARGB(const Frame& f, const uint8* src, Scratch* scratch,
+                       uint8* argb) {
+    const int argb_stride = f.out_width * 4;
+    const bool scale =
+        (f.out_height != f.crop_height || f.out_width != f.crop_width);
+    int ret = 0;
+    if (!scale && Format == kYUVFormatNV12) {
+      ret = libyuv::NV12ToARGB(
+          src + f.crop_y * f.width + f.crop_x, f.width,
+          src + f.height * f.width + (f.crop_y / 2) * f.width + f.crop_x,
+          f.width, argb, argb_stride, f.crop_width, f.crop_height);
+    } else if (!scale && Format == kYUVFormatYUY2) {
+      ret = libyuv::YUY2ToARGB(src + (f.crop_y * f.width + f.crop_x) * 2,
+                               f.width * 2, argb, argb_stride, f.crop_width,
+                               f.crop_height);
+    } else {
+      const YUVPlanes planes = CropPlanes(f, src, &scratch->planes);
+      const uint8* y = planes.y;
+      const uint8* u = planes.u;
+      const uint8* v = planes.v;
+      int y_stride = planes.y_stride;
+      int uv_stride = planes.uv_stride;
+      if (scale) {
+        const int64 uv_width = (f.out_width + 1) / 2;
+        const int64 uv_height = (f.out_height + 1) / 2;
+        const int64 y_size = f.out_height * f.out_width;
+        const int64 uv_size = uv_height * uv_width;
+        scratch->scaled.resize(y_size + uv_size * 2);
+        uint8* scaled_y = scratch->scaled.data();
+        uint8* scaled_u = scaled_y + y_size;
+        uint8* scaled_v = scaled_u + uv_size;
+        libyuv::ScalePlane(y, y_stride, f.crop_width, f.crop_height,
+                           scaled_y, f.out_width, f.out_width, f.out_height,
+                           libyuv::kFilterBilinear);
+        libyuv::ScalePlane(u, uv_stride, planes.uv_width, planes.uv_height,
+                           scaled_u, uv_width, uv_width, uv_height,
+                           libyuv::kFilterBilinear);
+        libyuv::ScalePlane(v, uv_stride, planes.uv_width, planes.uv_height,
+                           scaled_v, uv_width, uv_width, uv_height,
+                           libyuv::kFilterBilinear);
+        y = scaled_y;
+        u = scaled_u;
+        v = scaled_v;
+        y_stride = f.out_width;
+        uv_stride = uv_width;
+      }
+      ret = libyuv::I420ToARGB(y, y_stride, u, uv_stride, v, uv_stride, argb,
+                               argb_stride, f.out_width, f.out_height);
+    }
+    if (ret != 0) {
+      return errors::InvalidArgument("unable to convert frame to argb: ",
+                                     ret);
+    }
+    return OkStatus();
+  }
+
+  // Writes the ARGB pixels into `output` in the requested channel order,
+  // layout and dtype, floats are normalized to [0, 1].
+  template <typename T>
+  void PackARGB(const Frame& f, const uint8* argb, void* output) {
+    const int64 pixels = f.out_height * f.out_width;
+    const float scale = std::is_floating_point<T>::value ? 1.0f / 255 : 1.0f;
+    // ARGB is stored as B, G, R, A.
+    const int r = bgr_ ? 0 : 2;
+    const int b = bgr_ ? 2 : 0;
+    T* dst = static_cast<T*>(output);
+    if (nchw_) {
+      T* c0 = dst;
+      T* c1 = dst + pixels;
+      T* c2 = dst + pixels * 2;
+      for (int64 p = 0; p < pixels; p++) {
+        c0[p] = static_cast<T>(argb[p * 4 + r] * scale);
+        c1[p] = static_cast<T>(argb[p * 4 + 1] * scale);
+        c2[p] = static_cast<T>(argb[p * 4 + b] * scale);
+      }
+    } else {
+      for (int64 p = 0; p < pixels; p++) {
+        dst[p * 3 + 0] = static_cast<T>(argb[p * 4 + r] * scale);
+        dst[p * 3 + 1] = static_cast<T>(argb[p * 4 + 1] * scale);
+        dst[p * 3 + 2] = static_cast<T>(argb[p * 4 + b] * scale);
+      }
+    }
+  }
+
+  Status Convert(const Frame& f, const uint8* src, Scratch* scratch,
+                 void* output) {
+    const bool scale =
+        (f.out_height != f.crop_height || f.out_width != f.crop_width);
+    uint8* rgb = static_cast<uint8*>(output);
+    const int rgb_stride = f.out_width * 3;
+    // libyuv RAW is R, G, B in memory and RGB24 is B, G, R.
+    if (Format == kYUVFormatNV12 && !scale && !nchw_ && dtype_ == DT_UINT8) {
+      const uint8* y = src + f.crop_y * f.width + f.crop_x;
+      const uint8* uv =
+          src + f.height * f.width + (f.crop_y / 2) * f.width + f.crop_x;
+      const int ret =
+          bgr_ ? libyuv::NV12ToRGB24(y, f.width, uv, f.width, rgb,
+                                     rgb_stride, f.crop_width, f.crop_height)
+               : libyuv::NV12ToRAW(y, f.width, uv, f.width, rgb, rgb_stride,
+                                   f.crop_width, f.crop_height);
+      if (ret != 0) {
+        return errors::InvalidArgument("unable to convert nv12 to rgb: ",
+                                       ret);
+      }
+      return OkStatus();
+    }
+
+    scratch->argb.resize(f.out_height * f.out_width * 4);
+    const uint8* argb = scratch->argb.data();
+    TF_RETURN_IF_ERROR(
+        ConvertToARGB(f, src, scratch, scratch->argb.data()));
+    if (!nchw_ && dtype_ == DT_UINT8) {
+      const int argb_stride = f.out_width * 4;
+      const int ret =
+          bgr_ ? libyuv::ARGBToRGB24(argb, argb_stride, rgb, rgb_stride,
+                                     f.out_width, f.out_height)
+               : libyuv::ARGBToRAW(argb, argb_stride, rgb, rgb_stride,
+                                   f.out_width, f.out_height);
+      if (ret != 0) {
+        return errors::InvalidArgument("unable to convert argb to rgb: ",
+                                       ret);
+      }
+      return OkStatus();
+    }
+    if (dtype_ == DT_UINT8) {
+      PackARGB<uint8>(f, argb, output);
+    } else {
+      PackARGB<float>(f, argb, output);
+    }
+    return OkStatus();
+  }
+
+  std::vector<int64> crop_;
+  std::vector<int64> resize_;
+  bool bgr_;
+  bool nchw_;
+  DataType dtype_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeNV12Batch").Device(DEVICE_CPU),
+                        DecodeYUVBatchOp<kYUVFormatNV12>);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeYUY2Batch").Device(DEVICE_CPU),
+                        DecodeYUVBatchOp<kYUVFormatYUY2>);
+REGISTER_KERNEL_BUILDER(Name("IO>DecodeI420Batch").Device(DEVICE_CPU),
+                        DecodeYUVBatchOp<kYUVFormatI420>);
+
+}  // namespace
+}  // namespace io
+}  // namespace tensorflow
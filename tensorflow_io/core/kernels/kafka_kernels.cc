@@ -13,9 +13,15 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <deque>
+
+#include "rdkafka.h"
 #include "rdkafkacpp.h"
+#include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 namespace io {
@@ -57,10 +63,72 @@ class KafkaEventCb : public RdKafka::EventCb {
   bool run_ TF_GUARDED_BY(mu_) = true;
 };
 
+// A message returned by the librdkafka C batch API. The payload stays in the
+// buffer owned by librdkafka until it is copied into the output tensor.
+typedef std::unique_ptr<rd_kafka_message_t, void (*)(rd_kafka_message_t*)>
+    KafkaMessage;
+
+typedef std::unique_ptr<rd_kafka_queue_t, void (*)(rd_kafka_queue_t*)>
+    KafkaQueue;
+
+// Pulls up to `size` messages (including events such as partition EOF) from
+// `queue`. Messages already fetched are drained without waiting; `timeout`
+// (milliseconds) only applies while the queue is empty. `count` is set to the
+// number of messages appended to `messages`, 0 on timeout.
+Status ConsumeBatch(rd_kafka_queue_t* queue, int timeout, size_t size,
+                    std::deque<KafkaMessage>* messages, size_t* count) {
+  std::vector<rd_kafka_message_t*> batch(size);
+  ssize_t n = rd_kafka_consume_batch_queue(queue, 0, batch.data(), size);
+  if (n == 0) {
+    rd_kafka_message_t* first = rd_kafka_consume_queue(queue, timeout);
+    if (first != nullptr) {
+      batch[0] = first;
+      n = rd_kafka_consume_batch_queue(queue, 0, batch.data() + 1, size - 1);
+      if (n < 0) {
+        rd_kafka_message_destroy(first);
+      } else {
+        n++;
+      }
+    }
+  }
+  if (n < 0) {
+    return errors::Internal("failed to consume: ",
+                            rd_kafka_err2str(rd_kafka_last_error()));
+  }
+  for (ssize_t i = 0; i < n; i++) {
+    messages->emplace_back(batch[i], rd_kafka_message_destroy);
+  }
+  *count = n;
+  return OkStatus();
+}
+
+void AssignBytes(const void* data, size_t size, tstring* value) {
+  if (data == nullptr) {
+    value->clear();
+    return;
+  }
+  value->assign(static_cast<const char*>(data), size);
+}
+
+// Copies payloads and keys of `messages` straight into the output tensors.
+void CopyMessages(const std::vector<KafkaMessage>& messages,
+                  Tensor* message_tensor, Tensor* key_tensor) {
+  for (size_t i = 0; i < messages.size(); i++) {
+    const rd_kafka_message_t* message = messages[i].get();
+    AssignBytes(message->payload, message->len,
+                &message_tensor->flat<tstring>()(i));
+    AssignBytes(message->key, message->key_len,
+                &key_tensor->flat<tstring>()(i));
+  }
+}
+
 class KafkaReadableResource : public ResourceBase {
  public:
-  KafkaReadableResource(Env* env) : env_(env) {}
+  KafkaReadableResource(Env* env)
+      : env_(env), queue_(nullptr, rd_kafka_queue_destroy) {}
   virtual ~KafkaReadableResource() {
+    pending_.clear();
+    queue_.reset(nullptr);
     if (consumer_.get()) {
       consumer_->unassign();
       consumer_->close();
@@ -161,6 +229,9 @@ class KafkaReadableResource : public ResourceBase {
       return errors::Internal("failed to assign partition: ",
                               RdKafka::err2str(err));
     }
+    queue_.reset(rd_kafka_queue_get_consumer(consumer_->c_ptr()));
+    pending_.clear();
+    position_ = -1;
 
     return OkStatus();
   }
@@ -169,54 +240,59 @@ class KafkaReadableResource : public ResourceBase {
                                    Tensor** key)>
                   allocate_func) {
     mutex_lock l(mu_);
-    int64 total = 1024;
-    std::vector<string> message_value, key_value;
-    message_value.reserve(total);
-    key_value.reserve(total);
+    size_t total = 1024;
+    std::vector<KafkaMessage> messages;
+    messages.reserve(total);
 
     LOG(INFO) << "Kafka stream starts with current offset: "
               << subscription_->offset();
-    std::unique_ptr<RdKafka::Message> message;
-    int64 count = 0;
-    while (consumer_.get() != nullptr && count < total) {
+    while (consumer_.get() != nullptr && messages.size() < total) {
       if (!kafka_event_cb_.run()) {
         return errors::Internal("failed to consume due to all brokers down");
       }
-      message.reset(consumer_->consume(timeout_));
-      if (message->err() == RdKafka::ERR_NO_ERROR) {
+      if (pending_.empty()) {
+        size_t count;
+        TF_RETURN_IF_ERROR(ConsumeBatch(queue_.get(), timeout_,
+                                        total - messages.size(), &pending_,
+                                        &count));
+        continue;
+      }
+      KafkaMessage message = std::move(pending_.front());
+      pending_.pop_front();
+      if (message->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
         // Produce the line as output.
-        message_value.emplace_back(string(
-            static_cast<const char*>(message->payload()), message->len()));
-        key_value.emplace_back(
-            (message->key() != nullptr) ? string(*message->key()) : "");
-        count++;
+        position_ = message->offset + 1;
+        messages.emplace_back(std::move(message));
         continue;
-      } else if (message->err() == RdKafka::ERR__TRANSPORT) {
+      } else if (message->err == RD_KAFKA_RESP_ERR__TRANSPORT) {
         // Not return error here because consumer will try re-connect.
-        LOG(ERROR) << "Broker transport failure: " << message->errstr();
-      } else if (message->err() == RdKafka::ERR__PARTITION_EOF) {
-        LOG(ERROR) << "EOF Message: " << message->errstr();
+        LOG(ERROR) << "Broker transport failure: "
+                   << rd_kafka_message_errstr(message.get());
+      } else if (message->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+        LOG(ERROR) << "EOF Message: " << rd_kafka_message_errstr(message.get());
+        pending_.clear();
+        queue_.reset(nullptr);
         consumer_.reset(nullptr);
         break;
-      } else if (message->err() != RdKafka::ERR__TIMED_OUT) {
-        LOG(ERROR) << "Failed to consume: " << message->errstr();
-        return errors::Internal("Failed to consume: ", message->errstr());
+      } else if (message->err != RD_KAFKA_RESP_ERR__TIMED_OUT) {
+        LOG(ERROR) << "Failed to consume: "
+                   << rd_kafka_message_errstr(message.get());
+        return errors::Internal("Failed to consume: ",
+                                rd_kafka_message_errstr(message.get()));
       }
     }
-    TensorShape shape({static_cast<int64>(message_value.size())});
+    TensorShape shape({static_cast<int64>(messages.size())});
     Tensor* message_tensor;
     Tensor* key_tensor;
     TF_RETURN_IF_ERROR(allocate_func(shape, &message_tensor, &key_tensor));
-    for (size_t i = 0; i < message_value.size(); i++) {
-      message_tensor->flat<tstring>()(i) = message_value[i];
-      key_tensor->flat<tstring>()(i) = key_value[i];
-    }
+    CopyMessages(messages, message_tensor, key_tensor);
     return OkStatus();
   }
+  // Collects the messages with offsets in [start, stop). Messages fetched
+  // beyond `stop` are kept for the next call, so that reading contiguous
+  // ranges neither re-seeks the partition nor re-fetches messages.
   Status Read(const int64 start, const int64 stop,
-              std::function<Status(const TensorShape& shape, Tensor** message,
-                                   Tensor** key)>
-                  allocate_func) {
+              std::vector<KafkaMessage>* messages) {
     mutex_lock l(mu_);
 
     int64 stop_offset;
@@ -237,50 +313,60 @@ class KafkaReadableResource : public ResourceBase {
           tail_offset + stop_offset - RdKafka::Consumer::OffsetTail(0);
     }
 
-    std::vector<string> message_value, key_value;
-
-    subscription_->set_offset(start);
-    RdKafka::ErrorCode err = consumer_->seek((*subscription_), timeout_);
-    if (err != RdKafka::ERR_NO_ERROR) {
-      return errors::Internal("failed to seek partition: ",
-                              RdKafka::err2str(err));
+    if (start != position_) {
+      pending_.clear();
+      subscription_->set_offset(start);
+      RdKafka::ErrorCode err = consumer_->seek((*subscription_), timeout_);
+      if (err != RdKafka::ERR_NO_ERROR) {
+        return errors::Internal("failed to seek partition: ",
+                                RdKafka::err2str(err));
+      }
+      position_ = start;
+      LOG(INFO) << "Kafka stream starts with current offset: "
+                << subscription_->offset();
     }
-    LOG(INFO) << "Kafka stream starts with current offset: "
-              << subscription_->offset();
-    int64 index = start;
-    std::unique_ptr<RdKafka::Message> message;
-    while (consumer_.get() != nullptr && index + 1 < stop_offset) {
+    if (stop_offset > position_) {
+      messages->reserve(stop_offset - position_);
+    }
+    while (consumer_.get() != nullptr && position_ < stop_offset) {
       if (!kafka_event_cb_.run()) {
         return errors::Internal("failed to consume due to all brokers down");
       }
-      message.reset(consumer_->consume(timeout_));
-      if (message->err() == RdKafka::ERR_NO_ERROR) {
+      if (pending_.empty()) {
+        size_t count;
+        TF_RETURN_IF_ERROR(ConsumeBatch(
+            queue_.get(), timeout_,
+            std::min<int64>(stop_offset - position_, kMaxBatchSize), &pending_,
+            &count));
+        continue;
+      }
+      if (pending_.front()->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+        if (pending_.front()->offset >= stop_offset) {
+          // Keep it for a subsequent read of the following range.
+          break;
+        }
         // Produce the line as output.
-        message_value.emplace_back(string(
-            static_cast<const char*>(message->payload()), message->len()));
-        key_value.emplace_back(
-            (message->key() != nullptr) ? string(*message->key()) : "");
-        index = message->offset();
+        position_ = pending_.front()->offset + 1;
+        messages->emplace_back(std::move(pending_.front()));
+        pending_.pop_front();
         continue;
-      } else if (message->err() == RdKafka::ERR__PARTITION_EOF) {
-        LOG(ERROR) << "EOF Message: " << message->errstr();
+      }
+      KafkaMessage message = std::move(pending_.front());
+      pending_.pop_front();
+      if (message->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+        LOG(ERROR) << "EOF Message: " << rd_kafka_message_errstr(message.get());
         break;
-      } else if (message->err() == RdKafka::ERR__TRANSPORT) {
+      } else if (message->err == RD_KAFKA_RESP_ERR__TRANSPORT) {
         // Not return error here because consumer will try re-connect.
-        LOG(ERROR) << "Broker transport failure: " << message->errstr();
-      } else if (message->err() != RdKafka::ERR__TIMED_OUT) {
-        LOG(ERROR) << "Failed to consume: " << message->errstr();
-        return errors::Internal("Failed to consume: ", message->errstr());
+        LOG(ERROR) << "Broker transport failure: "
+                   << rd_kafka_message_errstr(message.get());
+      } else if (message->err != RD_KAFKA_RESP_ERR__TIMED_OUT) {
+        LOG(ERROR) << "Failed to consume: "
+                   << rd_kafka_message_errstr(message.get());
+        return errors::Internal("Failed to consume: ",
+                                rd_kafka_message_errstr(message.get()));
       }
     }
-    TensorShape shape({static_cast<int64>(message_value.size())});
-    Tensor* message_tensor;
-    Tensor* key_tensor;
-    TF_RETURN_IF_ERROR(allocate_func(shape, &message_tensor, &key_tensor));
-    for (size_t i = 0; i < message_value.size(); i++) {
-      message_tensor->flat<tstring>()(i) = message_value[i];
-      key_tensor->flat<tstring>()(i) = key_value[i];
-    }
     return OkStatus();
   }
   Status Spec(const int64 start, const int64 stop, int64* start_offset,
@@ -330,6 +416,8 @@ class KafkaReadableResource : public ResourceBase {
   Status Tail(int64* tail_offset) {
     // Resolve tail message
     int64 saved = subscription_->offset();
+    pending_.clear();
+    position_ = -1;
 
     subscription_->set_offset(RdKafka::Consumer::OffsetTail(1));
     RdKafka::ErrorCode err = consumer_->seek(*subscription_, timeout_);
@@ -361,8 +449,16 @@ class KafkaReadableResource : public ResourceBase {
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<RdKafka::TopicPartition> subscription_ TF_GUARDED_BY(mu_);
   std::unique_ptr<RdKafka::KafkaConsumer> consumer_ TF_GUARDED_BY(mu_);
+  // The consumer queue, messages are pulled from it in batches.
+  KafkaQueue queue_ TF_GUARDED_BY(mu_);
+  // Messages consumed from `queue_` but not yet returned.
+  std::deque<KafkaMessage> pending_ TF_GUARDED_BY(mu_);
+  // The offset following the last returned message, or -1 after a seek to
+  // an unknown position.
+  int64 position_ TF_GUARDED_BY(mu_) = -1;
   KafkaEventCb kafka_event_cb_ = KafkaEventCb();
   static const int timeout_ = 5000;
+  static const int64 kMaxBatchSize = 1024;
 };
 
 class KafkaReadableInitOp : public ResourceOpKernel<KafkaReadableResource> {
@@ -464,16 +560,105 @@ class KafkaReadableReadOp : public OpKernel {
     OP_REQUIRES_OK(context, context->input("stop", &stop_tensor));
     const int64 stop = stop_tensor->scalar<int64>()();
 
-    OP_REQUIRES_OK(
-        context,
-        resource->Read(
-            start, stop,
-            [&](const TensorShape& shape, Tensor** message,
-                Tensor** key) -> Status {
-              TF_RETURN_IF_ERROR(context->allocate_output(0, shape, message));
-              TF_RETURN_IF_ERROR(context->allocate_output(1, shape, key));
-              return OkStatus();
-            }));
+    std::vector<KafkaMessage> messages;
+    OP_REQUIRES_OK(context, resource->Read(start, stop, &messages));
+
+    TensorShape shape({static_cast<int64>(messages.size())});
+    Tensor* message_tensor;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, shape, &message_tensor));
+    Tensor* key_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(1, shape, &key_tensor));
+    CopyMessages(messages, message_tensor, key_tensor);
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
+class KafkaReadableReadRecordsOp : public OpKernel {
+ public:
+  explicit KafkaReadableReadRecordsOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    KafkaReadableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* start_tensor;
+    OP_REQUIRES_OK(context, context->input("start", &start_tensor));
+    const int64 start = start_tensor->scalar<int64>()();
+
+    const Tensor* stop_tensor;
+    OP_REQUIRES_OK(context, context->input("stop", &stop_tensor));
+    const int64 stop = stop_tensor->scalar<int64>()();
+
+    std::vector<KafkaMessage> messages;
+    OP_REQUIRES_OK(context, resource->Read(start, stop, &messages));
+
+    TensorShape shape({static_cast<int64>(messages.size())});
+    Tensor* message_tensor;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(0, shape, &message_tensor));
+    Tensor* key_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(1, shape, &key_tensor));
+    CopyMessages(messages, message_tensor, key_tensor);
+
+    Tensor* timestamp_tensor;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(2, shape, &timestamp_tensor));
+    Tensor* offset_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(3, shape, &offset_tensor));
+    Tensor* splits_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                6, TensorShape({shape.dim_size(0) + 1}),
+                                &splits_tensor));
+
+    // Headers are returned as a flat list of key/value pairs plus row splits.
+    int64 total = 0;
+    splits_tensor->flat<int64>()(0) = 0;
+    for (size_t i = 0; i < messages.size(); i++) {
+      rd_kafka_message_t* message = messages[i].get();
+      timestamp_tensor->flat<int64>()(i) =
+          rd_kafka_message_timestamp(message, nullptr);
+      offset_tensor->flat<int64>()(i) = message->offset;
+      rd_kafka_headers_t* headers = nullptr;
+      if (rd_kafka_message_headers(message, &headers) ==
+          RD_KAFKA_RESP_ERR_NO_ERROR) {
+        total += rd_kafka_header_cnt(headers);
+      }
+      splits_tensor->flat<int64>()(i + 1) = total;
+    }
+    Tensor* header_key_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(4, TensorShape({total}),
+                                                     &header_key_tensor));
+    Tensor* header_value_tensor;
+    OP_REQUIRES_OK(context, context->allocate_output(5, TensorShape({total}),
+                                                     &header_value_tensor));
+    int64 index = 0;
+    for (size_t i = 0; i < messages.size(); i++) {
+      rd_kafka_headers_t* headers = nullptr;
+      if (rd_kafka_message_headers(messages[i].get(), &headers) !=
+          RD_KAFKA_RESP_ERR_NO_ERROR) {
+        continue;
+      }
+      const char* name;
+      const void* value;
+      size_t size;
+      for (size_t j = 0; rd_kafka_header_get_all(headers, j, &name, &value,
+                                                 &size) ==
+                         RD_KAFKA_RESP_ERR_NO_ERROR;
+           j++) {
+        header_key_tensor->flat<tstring>()(index) = name;
+        AssignBytes(value, size, &header_value_tensor->flat<tstring>()(index));
+        index++;
+      }
+    }
   }
 
  private:
@@ -566,13 +751,44 @@ class KafkaIterableInitOp : public ResourceOpKernel<KafkaIterableResource> {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 */
-class LayerKafkaResource : public ResourceBase {
+// Tracks the delivery of the messages of one Write() call. The messages are
+// produced without copying, pointing into `message` and `key`, which keep
+// the tensor buffers alive until librdkafka reported every message.
+struct KafkaWriteBatch {
+  int64 id;
+  Tensor message;
+  Tensor key;
+  int64 pending;
+  int64 delivered = 0;
+  int64 failed = 0;
+  string error;
+};
+
+class KafkaWritableResource : public ResourceBase,
+                              public RdKafka::DeliveryReportCb {
  public:
-  LayerKafkaResource(Env* env) : env_(env) {}
-  ~LayerKafkaResource() { Sync(); }
+  KafkaWritableResource(Env* env) : env_(env) {}
+  virtual ~KafkaWritableResource() {
+    Flush(timeout_).IgnoreError();
+    {
+      mutex_lock l(results_mu_);
+      cancelled_ = true;
+    }
+    poller_.reset(nullptr);
+    if (producer_.get() != nullptr) {
+      // Release the batches of messages that could not be delivered.
+      producer_->purge(RdKafka::Producer::PURGE_QUEUE |
+                       RdKafka::Producer::PURGE_INFLIGHT);
+      producer_->poll(0);
+    }
+    topic_.reset(nullptr);
+    producer_.reset(nullptr);
+  }
 
   Status Init(const string& topic, const int32 partition,
               const std::vector<string>& metadata) {
+    mutex_lock l(mu_);
+
     std::unique_ptr<RdKafka::Conf> conf(
         RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
     std::unique_ptr<RdKafka::Conf> conf_topic(
@@ -625,6 +841,11 @@ class LayerKafkaResource : public ResourceBase {
       LOG(INFO) << "Kafka default bootstrap server: " << bootstrap_servers;
     }
 
+    if ((result = conf->set("dr_cb", this, errstr)) !=
+        RdKafka::Conf::CONF_OK) {
+      return errors::Internal("failed to set dr_cb:", errstr);
+    }
+
     producer_.reset(RdKafka::Producer::create(conf.get(), errstr));
     if (!(producer_.get() != nullptr)) {
       return errors::Internal("Failed to create producer:", errstr);
@@ -637,25 +858,88 @@ class LayerKafkaResource : public ResourceBase {
     }
 
     partition_ = partition;
+
+    // Delivery reports are served in the background so that Write() only
+    // hands the messages over to librdkafka.
+    poller_.reset(env_->StartThread(ThreadOptions(), "kafka_writable_poll",
+                                    [this]() { PollLoop(); }));
     return OkStatus();
   }
-  Status Write(const Tensor& content) {
+
+  // Produces every element of `message` (with the matching element of `key`
+  // if `key` is not empty). Returns as soon as the messages are queued; the
+  // outcome is reported under `id` by Results(). Write never waits for room
+  // in the producer queue: once queue.buffering.max.messages is reached the
+  // remaining messages are reported as failed with a queue full error, and
+  // `queued` (if not null) is set to the number of messages handed over.
+  Status Write(const Tensor& message, const Tensor& key, int64* id,
+               int64* queued = nullptr) {
     mutex_lock l(mu_);
-    for (int64 i = 0; i < content.NumElements(); i++) {
+    if (key.NumElements() != 0 && key.NumElements() != message.NumElements()) {
+      return errors::InvalidArgument("key has ", key.NumElements(),
+                                     " elements while message has ",
+                                     message.NumElements());
+    }
+    const int64 count = message.NumElements();
+    KafkaWriteBatch* batch = new KafkaWriteBatch();
+    batch->id = next_id_++;
+    batch->message = message;
+    batch->key = key;
+    batch->pending = count;
+    *id = batch->id;
+    if (queued != nullptr) {
+      *queued = count;
+    }
+    if (count == 0) {
+      mutex_lock results_lock(results_mu_);
+      CompleteLocked(batch);
+      return OkStatus();
+    }
+
+    for (int64 i = 0; i < count; i++) {
+      const tstring& value = batch->message.flat<tstring>()(i);
+      const void* key_data = nullptr;
+      size_t key_size = 0;
+      if (batch->key.NumElements() != 0) {
+        key_data = batch->key.flat<tstring>()(i).data();
+        key_size = batch->key.flat<tstring>()(i).size();
+      }
+      // Neither RK_MSG_COPY nor RK_MSG_FREE: the payload stays in the tensor
+      // buffer, which is held by `batch` until delivery. RK_MSG_BLOCK is not
+      // set so a full queue fails fast instead of stalling the caller.
       RdKafka::ErrorCode err = producer_->produce(
-          topic_.get(), partition_, RdKafka::Producer::RK_MSG_COPY,
-          (void*)content.flat<tstring>()(i).data(),
-          content.flat<tstring>()(i).size(), NULL, NULL);
-      if (!(err == RdKafka::ERR_NO_ERROR)) {
+          topic_.get(), partition_, 0, const_cast<char*>(value.data()),
+          value.size(), key_data, key_size, batch);
+      if (err != RdKafka::ERR_NO_ERROR) {
+        // The remaining messages will never be reported, so account for
+        // them in the delivery result of the batch.
+        if (queued != nullptr) {
+          *queued = i;
+        }
+        mutex_lock results_lock(results_mu_);
+        batch->failed += count - i;
+        batch->pending -= count - i;
+        if (batch->error.empty()) {
+          batch->error = RdKafka::err2str(err);
+        }
+        if (batch->pending == 0) {
+          CompleteLocked(batch);
+        }
+        if (err == RdKafka::ERR__QUEUE_FULL) {
+          return OkStatus();
+        }
         return errors::Internal("Failed to produce message:",
                                 RdKafka::err2str(err));
       }
     }
     return OkStatus();
   }
-  Status Sync() {
+
+  // Waits for the queued messages to be delivered. The producer is thread
+  // safe, so Flush does not hold `mu_` and concurrent Writes keep going.
+  Status Flush(const int64 timeout) {
     if (producer_.get() != nullptr) {
-      RdKafka::ErrorCode err = producer_->flush(timeout_);
+      RdKafka::ErrorCode err = producer_->flush(timeout);
       if (!(err == RdKafka::ERR_NO_ERROR)) {
         return errors::Internal("Failed to flush message:",
                                 RdKafka::err2str(err));
@@ -663,15 +947,246 @@ class LayerKafkaResource : public ResourceBase {
     }
     return OkStatus();
   }
-  string DebugString() const override { return "LayerKafkaResource"; }
 
- private:
+  // Returns (and forgets) the batches whose messages were all reported.
+  Status Results(
+      std::function<Status(const TensorShape& shape, Tensor** id,
+                           Tensor** delivered, Tensor** failed,
+                           Tensor** error)>
+          allocate_func) {
+    std::deque<KafkaWriteBatch> results;
+    {
+      mutex_lock l(results_mu_);
+      results.swap(results_);
+    }
+    TensorShape shape({static_cast<int64>(results.size())});
+    Tensor* id_tensor;
+    Tensor* delivered_tensor;
+    Tensor* failed_tensor;
+    Tensor* error_tensor;
+    TF_RETURN_IF_ERROR(allocate_func(shape, &id_tensor, &delivered_tensor,
+                                     &failed_tensor, &error_tensor));
+    for (size_t i = 0; i < results.size(); i++) {
+      id_tensor->flat<int64>()(i) = results[i].id;
+      delivered_tensor->flat<int64>()(i) = results[i].delivered;
+      failed_tensor->flat<int64>()(i) = results[i].failed;
+      error_tensor->flat<tstring>()(i) = results[i].error;
+    }
+    return OkStatus();
+  }
+
+  void dr_cb(RdKafka::Message& message) override {
+    KafkaWriteBatch* batch =
+        static_cast<KafkaWriteBatch*>(message.msg_opaque());
+    mutex_lock l(results_mu_);
+    if (message.err() == RdKafka::ERR_NO_ERROR) {
+      batch->delivered++;
+    } else {
+      batch->failed++;
+      if (batch->error.empty()) {
+        batch->error = message.errstr();
+      }
+    }
+    if (--batch->pending == 0) {
+      CompleteLocked(batch);
+    }
+  }
+
+  string DebugString() const override { return "KafkaWritableResource"; }
+
+ protected:
+  void PollLoop() {
+    while (true) {
+      {
+        mutex_lock l(results_mu_);
+        if (cancelled_) {
+          return;
+        }
+      }
+      producer_->poll(100);
+    }
+  }
+
+  // Moves the summary of `batch` to the results and releases its tensors.
+  void CompleteLocked(KafkaWriteBatch* batch)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(results_mu_) {
+    if (results_.size() >= kMaxResults) {
+      LOG(WARNING) << "Kafka delivery report of batch " << results_.front().id
+                   << " dropped as results are not retrieved";
+      results_.pop_front();
+    }
+    KafkaWriteBatch result;
+    result.id = batch->id;
+    result.delivered = batch->delivered;
+    result.failed = batch->failed;
+    result.error = std::move(batch->error);
+    results_.emplace_back(std::move(result));
+    delete batch;
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<RdKafka::Producer> producer_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<RdKafka::Producer> producer_;
   std::unique_ptr<RdKafka::Topic> topic_ TF_GUARDED_BY(mu_);
   int32 partition_ TF_GUARDED_BY(mu_);
+  int64 next_id_ TF_GUARDED_BY(mu_) = 0;
+  std::unique_ptr<Thread> poller_;
+
+  mutable mutex results_mu_;
+  std::deque<KafkaWriteBatch> results_ TF_GUARDED_BY(results_mu_);
+  bool cancelled_ TF_GUARDED_BY(results_mu_) = false;
+
   static const int timeout_ = 5000;
+  static const size_t kMaxResults = 1024;
+};
+
+class LayerKafkaResource : public KafkaWritableResource {
+ public:
+  LayerKafkaResource(Env* env) : KafkaWritableResource(env) {}
+
+  Status Write(const Tensor& content) {
+    int64 id, queued;
+    TF_RETURN_IF_ERROR(KafkaWritableResource::Write(
+        content, Tensor(DT_STRING, TensorShape({0})), &id, &queued));
+    // The layer has no delivery results to report dropped messages in.
+    if (queued != content.NumElements()) {
+      return errors::ResourceExhausted(
+          "Kafka producer queue is full, ", content.NumElements() - queued,
+          " of ", content.NumElements(), " messages were dropped");
+    }
+    return OkStatus();
+  }
+  Status Sync() { return Flush(timeout_); }
+  string DebugString() const override { return "LayerKafkaResource"; }
+};
+
+class KafkaWritableInitOp : public ResourceOpKernel<KafkaWritableResource> {
+ public:
+  explicit KafkaWritableInitOp(OpKernelConstruction* context)
+      : ResourceOpKernel<KafkaWritableResource>(context) {
+    env_ = context->env();
+  }
+
+ private:
+  void Compute(OpKernelContext* context) override {
+    ResourceOpKernel<KafkaWritableResource>::Compute(context);
+
+    const Tensor* topic_tensor;
+    OP_REQUIRES_OK(context, context->input("topic", &topic_tensor));
+
+    const Tensor* partition_tensor;
+    OP_REQUIRES_OK(context, context->input("partition", &partition_tensor));
+
+    const Tensor* metadata_tensor;
+    OP_REQUIRES_OK(context, context->input("metadata", &metadata_tensor));
+    std::vector<string> metadata;
+    for (int64 i = 0; i < metadata_tensor->NumElements(); i++) {
+      metadata.push_back(metadata_tensor->flat<tstring>()(i));
+    }
+
+    OP_REQUIRES_OK(context, resource_->Init(topic_tensor->scalar<tstring>()(),
+                                            partition_tensor->scalar<int32>()(),
+                                            metadata));
+  }
+  Status CreateResource(KafkaWritableResource** resource)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) override {
+    *resource = new KafkaWritableResource(env_);
+    return OkStatus();
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
+class KafkaWritableWriteOp : public OpKernel {
+ public:
+  explicit KafkaWritableWriteOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    KafkaWritableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* message_tensor;
+    OP_REQUIRES_OK(context, context->input("message", &message_tensor));
+
+    const Tensor* key_tensor;
+    OP_REQUIRES_OK(context, context->input("key", &key_tensor));
+
+    int64 id;
+    OP_REQUIRES_OK(context,
+                   resource->Write(*message_tensor, *key_tensor, &id));
+
+    Tensor* batch_tensor = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, TensorShape({}),
+                                                     &batch_tensor));
+    batch_tensor->scalar<int64>()() = id;
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
+class KafkaWritableFlushOp : public OpKernel {
+ public:
+  explicit KafkaWritableFlushOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    KafkaWritableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* timeout_tensor;
+    OP_REQUIRES_OK(context, context->input("timeout", &timeout_tensor));
+    const int64 timeout = timeout_tensor->scalar<int64>()();
+
+    OP_REQUIRES_OK(context, resource->Flush(timeout));
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
+class KafkaWritableResultsOp : public OpKernel {
+ public:
+  explicit KafkaWritableResultsOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    KafkaWritableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    OP_REQUIRES_OK(
+        context,
+        resource->Results([&](const TensorShape& shape, Tensor** id,
+                              Tensor** delivered, Tensor** failed,
+                              Tensor** error) -> Status {
+          TF_RETURN_IF_ERROR(context->allocate_output(0, shape, id));
+          TF_RETURN_IF_ERROR(context->allocate_output(1, shape, delivered));
+          TF_RETURN_IF_ERROR(context->allocate_output(2, shape, failed));
+          TF_RETURN_IF_ERROR(context->allocate_output(3, shape, error));
+          return OkStatus();
+        }));
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
 };
 
 class LayerKafkaInitOp : public ResourceOpKernel<LayerKafkaResource> {
@@ -817,8 +1332,11 @@ class KafkaRebalanceCb : public RdKafka::RebalanceCb {
 
 class KafkaGroupReadableResource : public ResourceBase {
  public:
-  KafkaGroupReadableResource(Env* env) : env_(env) {}
+  KafkaGroupReadableResource(Env* env)
+      : env_(env), queue_(nullptr, rd_kafka_queue_destroy) {}
   virtual ~KafkaGroupReadableResource() {
+    pending_.clear();
+    queue_.reset(nullptr);
     if (consumer_.get()) {
       consumer_->unassign();
       consumer_->close();
@@ -949,6 +1467,7 @@ class KafkaGroupReadableResource : public ResourceBase {
       return errors::Internal("failed to subscribe to topics: ",
                               RdKafka::err2str(err));
     }
+    queue_.reset(rd_kafka_queue_get_consumer(consumer_->c_ptr()));
 
     return OkStatus();
   }
@@ -963,49 +1482,56 @@ class KafkaGroupReadableResource : public ResourceBase {
     int64 num_messages = 0;
     max_stream_timeout_polls_ = stream_timeout / message_poll_timeout;
 
-    // Allocate memory for message_value and key_value vectors
-    std::vector<string> message_value, key_value;
-    message_value.reserve(batch_num_messages_);
-    key_value.reserve(batch_num_messages_);
+    std::vector<KafkaMessage> messages;
+    messages.reserve(batch_num_messages_);
 
-    std::unique_ptr<RdKafka::Message> message;
     while (consumer_.get() != nullptr && num_messages < batch_num_messages_) {
       if (!kafka_event_cb_.run()) {
         return errors::Internal(
             "failed to consume messages due to broker issue");
       }
-      message.reset(consumer_->consume(message_poll_timeout));
-      if (message->err() == RdKafka::ERR_NO_ERROR) {
+      if (pending_.empty()) {
+        size_t count;
+        TF_RETURN_IF_ERROR(ConsumeBatch(queue_.get(), message_poll_timeout,
+                                        batch_num_messages_ - num_messages,
+                                        &pending_, &count));
+        if (count == 0) {
+          LOG(ERROR) << "Local: Timed out";
+          stream_timeout_polls_++;
+          break;
+        }
+      }
+      KafkaMessage message = std::move(pending_.front());
+      pending_.pop_front();
+      if (message->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
         // Produce the line as output.
-        message_value.emplace_back(string(
-            static_cast<const char*>(message->payload()), message->len()));
-        key_value.emplace_back(
-            (message->key() != nullptr) ? string(*message->key()) : "");
+        messages.emplace_back(std::move(message));
         num_messages++;
         // Once a message has been successfully retrieved, the
         // `stream_timeout_polls_` is reset to 0. This allows the dataset
         // to wait for the entire `stream_timeout` duration when a data
         // slump occurs in the future.
         stream_timeout_polls_ = 0;
-      } else if (message->err() == RdKafka::ERR__TRANSPORT) {
+      } else if (message->err == RD_KAFKA_RESP_ERR__TRANSPORT) {
         // Not returning an error here as the consumer will try to re-connect.
-        LOG(ERROR) << "Broker transport failure: " << message->errstr();
+        LOG(ERROR) << "Broker transport failure: "
+                   << rd_kafka_message_errstr(message.get());
 
-      } else if (message->err() == RdKafka::ERR__PARTITION_EOF) {
+      } else if (message->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
         if (++eof_count == partition_count) {
           LOG(INFO) << "EOF reached for all " << partition_count
                     << " partition(s)";
           break;
         }
-      } else if (message->err() == RdKafka::ERR__TIMED_OUT) {
-        LOG(ERROR) << message->errstr();
+      } else if (message->err == RD_KAFKA_RESP_ERR__TIMED_OUT) {
+        LOG(ERROR) << rd_kafka_message_errstr(message.get());
         stream_timeout_polls_++;
         break;
       }
     }
 
     // Prepare the outputs
-    TensorShape shape({static_cast<int64>(message_value.size())});
+    TensorShape shape({static_cast<int64>(messages.size())});
     Tensor* message_tensor;
     Tensor* key_tensor;
     Tensor* continue_fetch_tensor;
@@ -1017,10 +1543,7 @@ class KafkaGroupReadableResource : public ResourceBase {
     } else {
       continue_fetch_tensor->scalar<int64>()() = 0;
     }
-    for (size_t i = 0; i < message_value.size(); i++) {
-      message_tensor->flat<tstring>()(i) = message_value[i];
-      key_tensor->flat<tstring>()(i) = key_value[i];
-    }
+    CopyMessages(messages, message_tensor, key_tensor);
 
     return OkStatus();
   }
@@ -1031,6 +1554,8 @@ class KafkaGroupReadableResource : public ResourceBase {
   Env* env_ TF_GUARDED_BY(mu_);
   // std::unique_ptr<RdKafka::TopicPartition> subscription_ TF_GUARDED_BY(mu_);
   std::unique_ptr<RdKafka::KafkaConsumer> consumer_ TF_GUARDED_BY(mu_);
+  KafkaQueue queue_ TF_GUARDED_BY(mu_);
+  std::deque<KafkaMessage> pending_ TF_GUARDED_BY(mu_);
   KafkaEventCb kafka_event_cb_ = KafkaEventCb();
   KafkaRebalanceCb kafka_rebalance_cb_ = KafkaRebalanceCb();
   int max_stream_timeout_polls_ = -1;
@@ -1124,14 +1649,586 @@ class KafkaGroupReadableNextOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+// Reads a set of partitions of one topic in parallel. The messages of every
+// partition are routed to a dedicated librdkafka queue, which a worker thread
+// drains into a bounded prefetch buffer. Next() merges the buffers into
+// batches and keeps track of the next offset to deliver per partition.
+class KafkaPartitionFetcher {
+ public:
+  KafkaPartitionFetcher(Env* env, const int64 capacity, const bool eof)
+      : env_(env), capacity_(capacity), eof_(eof) {}
+  ~KafkaPartitionFetcher() {
+    {
+      mutex_lock l(mu_);
+      cancelled_ = true;
+      cond_.notify_all();
+    }
+    workers_.clear();
+    partitions_.clear();
+    if (consumer_.get()) {
+      consumer_->unassign();
+      consumer_->close();
+      consumer_.reset(nullptr);
+    }
+  }
+
+  Status Init(const string& topic, const std::vector<int32>& partitions,
+              const std::vector<int64>& offsets,
+              const std::vector<string>& metadata) {
+    std::unique_ptr<RdKafka::Conf> conf(
+        RdKafka::Conf::create(RdKafka::Conf::CONF_GLOBAL));
+    std::unique_ptr<RdKafka::Conf> conf_topic(
+        RdKafka::Conf::create(RdKafka::Conf::CONF_TOPIC));
+
+    string errstr;
+    RdKafka::Conf::ConfResult result = RdKafka::Conf::CONF_UNKNOWN;
+    // Consumed offsets are part of the iterator state, so nothing is
+    // committed to the broker unless asked for.
+    if ((result = conf->set("enable.auto.commit", "false", errstr)) !=
+        RdKafka::Conf::CONF_OK) {
+      return errors::Internal("failed to set enable.auto.commit:", errstr);
+    }
+    for (size_t i = 0; i < metadata.size(); i++) {
+      if (metadata[i].find("conf.topic.") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2) {
+          return errors::InvalidArgument("invalid topic configuration: ",
+                                         metadata[i]);
+        }
+        result = conf_topic->set(parts[0].substr(11), parts[1], errstr);
+        if (result != RdKafka::Conf::CONF_OK) {
+          return errors::Internal("failed to do topic configuration:",
+                                  metadata[i], "error:", errstr);
+        }
+      } else if (metadata[i] != "" &&
+                 metadata[i].find("conf.") == string::npos) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2) {
+          return errors::InvalidArgument("invalid topic configuration: ",
+                                         metadata[i]);
+        }
+        if ((result = conf->set(parts[0], parts[1], errstr)) !=
+            RdKafka::Conf::CONF_OK) {
+          return errors::Internal("failed to do global configuration: ",
+                                  metadata[i], "error:", errstr);
+        }
+      }
+      LOG(INFO) << "Kafka configuration: " << metadata[i];
+    }
+    if ((result = conf->set("default_topic_conf", conf_topic.get(), errstr)) !=
+        RdKafka::Conf::CONF_OK) {
+      return errors::Internal("failed to set default_topic_conf:", errstr);
+    }
+
+    string bootstrap_servers;
+    if ((result = conf->get("bootstrap.servers", bootstrap_servers)) !=
+        RdKafka::Conf::CONF_OK) {
+      bootstrap_servers = "localhost:9092";
+      if ((result = conf->set("bootstrap.servers", bootstrap_servers,
+                              errstr)) != RdKafka::Conf::CONF_OK) {
+        return errors::Internal("failed to set bootstrap.servers [",
+                                bootstrap_servers, "]:", errstr);
+      }
+    }
+    string group_id;
+    if ((result = conf->get("group.id", group_id)) != RdKafka::Conf::CONF_OK) {
+      group_id = "test-consumer-group";
+      if ((result = conf->set("group.id", group_id, errstr)) !=
+          RdKafka::Conf::CONF_OK) {
+        return errors::Internal("failed to set group.id [", group_id,
+                                "]:", errstr);
+      }
+    }
+
+    // Always set enable.partition.eof=true
+    if ((result = conf->set("enable.partition.eof", "true", errstr)) !=
+        RdKafka::Conf::CONF_OK) {
+      return errors::Internal("Failed to set enable.partition.eof=true :",
+                              errstr);
+    }
+
+    if ((result = conf->set("event_cb", &kafka_event_cb_, errstr)) !=
+        RdKafka::Conf::CONF_OK) {
+      return errors::Internal("failed to set event_cb:", errstr);
+    }
+
+    consumer_.reset(RdKafka::KafkaConsumer::create(conf.get(), errstr));
+    if (!consumer_.get()) {
+      return errors::Internal("failed to create consumer:", errstr);
+    }
+
+    // No partitions means all partitions of the topic.
+    std::vector<int32> assigned = partitions;
+    if (assigned.empty()) {
+      std::unique_ptr<RdKafka::Topic> handle(
+          RdKafka::Topic::create(consumer_.get(), topic, nullptr, errstr));
+      if (!handle.get()) {
+        return errors::Internal("failed to create topic ", topic, ":", errstr);
+      }
+      RdKafka::Metadata* raw = nullptr;
+      RdKafka::ErrorCode err =
+          consumer_->metadata(false, handle.get(), &raw, timeout_);
+      std::unique_ptr<RdKafka::Metadata> topic_metadata(raw);
+      if (err != RdKafka::ERR_NO_ERROR) {
+        return errors::Internal("failed to get metadata of ", topic, ": ",
+                                RdKafka::err2str(err));
+      }
+      for (const RdKafka::TopicMetadata* entry :
+           *topic_metadata->topics()) {
+        if (entry->topic() != topic) {
+          continue;
+        }
+        for (const RdKafka::PartitionMetadata* partition :
+             *entry->partitions()) {
+          assigned.push_back(partition->id());
+        }
+      }
+      std::sort(assigned.begin(), assigned.end());
+      if (assigned.empty()) {
+        return errors::NotFound("no partitions found for topic ", topic);
+      }
+    }
+
+    std::vector<std::unique_ptr<RdKafka::TopicPartition>> subscriptions;
+    std::vector<RdKafka::TopicPartition*> subscription_ptrs;
+    for (size_t i = 0; i < assigned.size(); i++) {
+      std::unique_ptr<Partition> partition(new Partition());
+      partition->id = assigned[i];
+      partition->offset = (i < offsets.size()) ? offsets[i] : 0;
+      subscriptions.emplace_back(RdKafka::TopicPartition::create(
+          topic, partition->id, partition->offset));
+      subscription_ptrs.push_back(subscriptions.back().get());
+      partitions_.emplace_back(std::move(partition));
+    }
+    RdKafka::ErrorCode err = consumer_->assign(subscription_ptrs);
+    if (err != RdKafka::ERR_NO_ERROR) {
+      return errors::Internal("failed to assign partitions: ",
+                              RdKafka::err2str(err));
+    }
+
+    // Detach every partition queue from the consumer queue so that each one
+    // is served by its own worker.
+    for (size_t i = 0; i < partitions_.size(); i++) {
+      Partition* partition = partitions_[i].get();
+      partition->queue.reset(rd_kafka_queue_get_partition(
+          consumer_->c_ptr(), topic.c_str(), partition->id));
+      if (partition->queue.get() == nullptr) {
+        return errors::Internal("failed to get queue of partition ",
+                                partition->id);
+      }
+      rd_kafka_queue_forward(partition->queue.get(), nullptr);
+    }
+    for (size_t i = 0; i < partitions_.size(); i++) {
+      Partition* partition = partitions_[i].get();
+      workers_.emplace_back(env_->StartThread(
+          ThreadOptions(), strings::StrCat("kafka_partition_", partition->id),
+          [this, partition]() { FetchLoop(partition); }));
+    }
+    return OkStatus();
+  }
+
+  // Returns up to `batch_size` messages taken round-robin from the prefetch
+  // buffers. `end` is set once every partition reached EOF (when `eof_` is
+  // set) or nothing arrived within `timeout` milliseconds (negative waits
+  // forever).
+  Status Next(const int64 batch_size, const int64 timeout,
+              std::vector<KafkaMessage>* messages, bool* end) {
+    mutex_lock l(mu_);
+    const uint64 deadline = env_->NowMicros() + timeout * 1000;
+    *end = false;
+    while (true) {
+      if (!kafka_event_cb_.run()) {
+        return errors::Internal("failed to consume due to all brokers down");
+      }
+      TF_RETURN_IF_ERROR(status_);
+      ServeLocked();
+      bool available = false, exhausted = eof_;
+      for (size_t i = 0; i < partitions_.size(); i++) {
+        available = available || !partitions_[i]->messages.empty();
+        exhausted = exhausted && partitions_[i]->eof;
+      }
+      if (available) {
+        break;
+      }
+      if (exhausted || (timeout >= 0 && env_->NowMicros() >= deadline)) {
+        *end = true;
+        return OkStatus();
+      }
+      cond_.wait_for(l, std::chrono::milliseconds(100));
+    }
+
+    // Take an equal share from each partition per round so that a busy
+    // partition does not starve the others.
+    const size_t limit = batch_size;
+    const size_t share = std::max<size_t>(1, limit / partitions_.size());
+    messages->reserve(limit);
+    bool taken = true;
+    while (taken && messages->size() < limit) {
+      taken = false;
+      for (size_t i = 0; i < partitions_.size(); i++) {
+        Partition* partition =
+            partitions_[(next_ + i) % partitions_.size()].get();
+        for (size_t j = 0; j < share && !partition->messages.empty() &&
+                           messages->size() < limit;
+             j++) {
+          partition->offset = partition->messages.front()->offset + 1;
+          messages->emplace_back(std::move(partition->messages.front()));
+          partition->messages.pop_front();
+          taken = true;
+        }
+      }
+    }
+    next_ = (next_ + 1) % partitions_.size();
+    cond_.notify_all();
+    return OkStatus();
+  }
+
+  // The assigned partitions and the next offset to deliver for each.
+  void Offsets(std::vector<int32>* partitions, std::vector<int64>* offsets) {
+    mutex_lock l(mu_);
+    partitions->clear();
+    offsets->clear();
+    for (size_t i = 0; i < partitions_.size(); i++) {
+      partitions->push_back(partitions_[i]->id);
+      offsets->push_back(partitions_[i]->offset);
+    }
+  }
+
+ private:
+  struct Partition {
+    Partition() : queue(nullptr, rd_kafka_queue_destroy) {}
+    int32 id;
+    int64 offset;
+    bool eof = false;
+    KafkaQueue queue;
+    std::deque<KafkaMessage> messages;
+  };
+
+  void FetchLoop(Partition* partition) {
+    while (true) {
+      size_t size;
+      {
+        mutex_lock l(mu_);
+        while (!cancelled_ && partition->messages.size() >= capacity_) {
+          cond_.wait(l);
+        }
+        if (cancelled_) {
+          return;
+        }
+        size = capacity_ - partition->messages.size();
+      }
+      std::deque<KafkaMessage> batch;
+      size_t count;
+      Status status = ConsumeBatch(partition->queue.get(), kPollTimeout, size,
+                                   &batch, &count);
+      mutex_lock l(mu_);
+      if (!status.ok()) {
+        status_ = status;
+        cond_.notify_all();
+        return;
+      }
+      for (auto& message : batch) {
+        if (message->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+          partition->eof = false;
+          partition->messages.emplace_back(std::move(message));
+        } else if (message->err == RD_KAFKA_RESP_ERR__PARTITION_EOF) {
+          partition->eof = true;
+        } else if (message->err == RD_KAFKA_RESP_ERR__TRANSPORT) {
+          // Not return error here because consumer will try re-connect.
+          LOG(ERROR) << "Broker transport failure: "
+                     << rd_kafka_message_errstr(message.get());
+        } else if (message->err != RD_KAFKA_RESP_ERR__TIMED_OUT) {
+          status_ = errors::Internal("Failed to consume: ",
+                                     rd_kafka_message_errstr(message.get()));
+        }
+      }
+      if (count != 0) {
+        cond_.notify_all();
+      }
+      if (!status_.ok() || (eof_ && partition->eof)) {
+        return;
+      }
+    }
+  }
+
+  // Serves callbacks queued on the consumer queue. Messages that reached it
+  // before their partition queue was detached are moved to their buffer.
+  void ServeLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    rd_kafka_message_t* raw;
+    while ((raw = rd_kafka_consumer_poll(consumer_->c_ptr(), 0)) != nullptr) {
+      KafkaMessage message(raw, rd_kafka_message_destroy);
+      if (message->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+        continue;
+      }
+      for (size_t i = 0; i < partitions_.size(); i++) {
+        if (partitions_[i]->id == message->partition) {
+          partitions_[i]->messages.emplace_back(std::move(message));
+          break;
+        }
+      }
+    }
+  }
+
+  mutable mutex mu_;
+  condition_variable cond_;
+  Env* env_;
+  const size_t capacity_;
+  const bool eof_;
+  std::unique_ptr<RdKafka::KafkaConsumer> consumer_;
+  std::vector<std::unique_ptr<Partition>> partitions_;
+  std::vector<std::unique_ptr<Thread>> workers_;
+  size_t next_ TF_GUARDED_BY(mu_) = 0;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+  KafkaEventCb kafka_event_cb_ = KafkaEventCb();
+  static const int timeout_ = 5000;
+  static const int kPollTimeout = 100;
+};
+
+class KafkaPartitionedDatasetOp : public data::DatasetOpKernel {
+ public:
+  using data::DatasetOpKernel::DatasetOpKernel;
+
+  void MakeDataset(OpKernelContext* ctx, data::DatasetBase** output) override {
+    tstring topic;
+    OP_REQUIRES_OK(ctx,
+                   data::ParseScalarArgument<tstring>(ctx, "topic", &topic));
+
+    const Tensor* partitions_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("partitions", &partitions_tensor));
+    std::vector<int32> partitions;
+    for (int64 i = 0; i < partitions_tensor->NumElements(); i++) {
+      partitions.push_back(partitions_tensor->flat<int32>()(i));
+    }
+
+    const Tensor* offsets_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("offsets", &offsets_tensor));
+    std::vector<int64> offsets;
+    for (int64 i = 0; i < offsets_tensor->NumElements(); i++) {
+      offsets.push_back(offsets_tensor->flat<int64>()(i));
+    }
+
+    int64 batch_size = 0;
+    OP_REQUIRES_OK(ctx, data::ParseScalarArgument<int64>(ctx, "batch_size",
+                                                         &batch_size));
+    OP_REQUIRES(ctx, batch_size > 0,
+                errors::InvalidArgument("batch_size must be positive, got ",
+                                        batch_size));
+    int64 capacity = 0;
+    OP_REQUIRES_OK(
+        ctx, data::ParseScalarArgument<int64>(ctx, "capacity", &capacity));
+    OP_REQUIRES(ctx, capacity > 0,
+                errors::InvalidArgument("capacity must be positive, got ",
+                                        capacity));
+    bool eof = false;
+    OP_REQUIRES_OK(ctx, data::ParseScalarArgument<bool>(ctx, "eof", &eof));
+    int64 timeout = -1;
+    OP_REQUIRES_OK(ctx,
+                   data::ParseScalarArgument<int64>(ctx, "timeout", &timeout));
+
+    const Tensor* metadata_tensor;
+    OP_REQUIRES_OK(ctx, ctx->input("metadata", &metadata_tensor));
+    std::vector<string> metadata;
+    for (int64 i = 0; i < metadata_tensor->NumElements(); i++) {
+      metadata.push_back(metadata_tensor->flat<tstring>()(i));
+    }
+
+    *output = new Dataset(ctx, topic, std::move(partitions),
+                          std::move(offsets), batch_size, capacity, eof,
+                          timeout, std::move(metadata));
+  }
+
+ private:
+  class Dataset : public data::DatasetBase {
+   public:
+    Dataset(OpKernelContext* ctx, const string& topic,
+            std::vector<int32> partitions, std::vector<int64> offsets,
+            const int64 batch_size, const int64 capacity, const bool eof,
+            const int64 timeout, std::vector<string> metadata)
+        : DatasetBase(data::DatasetContext(ctx)),
+          topic_(topic),
+          partitions_(std::move(partitions)),
+          offsets_(std::move(offsets)),
+          batch_size_(batch_size),
+          capacity_(capacity),
+          eof_(eof),
+          timeout_(timeout),
+          metadata_(std::move(metadata)) {}
+
+    std::unique_ptr<data::IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return std::unique_ptr<data::IteratorBase>(new Iterator(
+          {this, strings::StrCat(prefix, "::KafkaPartitioned")}));
+    }
+
+    const DataTypeVector& output_dtypes() const override {
+      static DataTypeVector* dtypes =
+          new DataTypeVector({DT_STRING, DT_STRING, DT_INT32, DT_INT64});
+      return *dtypes;
+    }
+
+    const std::vector<PartialTensorShape>& output_shapes() const override {
+      static std::vector<PartialTensorShape>* shapes =
+          new std::vector<PartialTensorShape>({{-1}, {-1}, {-1}, {-1}});
+      return *shapes;
+    }
+
+    string DebugString() const override {
+      return "KafkaPartitionedDatasetOp::Dataset";
+    }
+
+    Status CheckExternalState() const override { return OkStatus(); }
+
+   protected:
+    Status AsGraphDefInternal(data::SerializationContext* ctx,
+                              data::DatasetGraphDefBuilder* b,
+                              Node** output) const override {
+      Node* topic = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(topic_, &topic));
+      Node* partitions = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(partitions_, &partitions));
+      Node* offsets = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(offsets_, &offsets));
+      Node* batch_size = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(batch_size_, &batch_size));
+      Node* capacity = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(capacity_, &capacity));
+      Node* eof = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(eof_, &eof));
+      Node* timeout = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(timeout_, &timeout));
+      Node* metadata = nullptr;
+      TF_RETURN_IF_ERROR(b->AddVector(metadata_, &metadata));
+      TF_RETURN_IF_ERROR(b->AddDataset(this,
+                                       {topic, partitions, offsets, batch_size,
+                                        capacity, eof, timeout, metadata},
+                                       output));
+      return OkStatus();
+    }
+
+   private:
+    class Iterator : public data::DatasetIterator<Dataset> {
+     public:
+      explicit Iterator(const Params& params)
+          : DatasetIterator<Dataset>(params),
+            partitions_(params.dataset->partitions_),
+            offsets_(params.dataset->offsets_) {}
+
+      Status GetNextInternal(data::IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        if (fetcher_.get() == nullptr) {
+          std::unique_ptr<KafkaPartitionFetcher> fetcher(
+              new KafkaPartitionFetcher(ctx->env(), dataset()->capacity_,
+                                        dataset()->eof_));
+          TF_RETURN_IF_ERROR(fetcher->Init(dataset()->topic_, partitions_,
+                                           offsets_, dataset()->metadata_));
+          fetcher_ = std::move(fetcher);
+        }
+
+        std::vector<KafkaMessage> messages;
+        TF_RETURN_IF_ERROR(fetcher_->Next(dataset()->batch_size_,
+                                          dataset()->timeout_, &messages,
+                                          end_of_sequence));
+        fetcher_->Offsets(&partitions_, &offsets_);
+        if (*end_of_sequence) {
+          return OkStatus();
+        }
+
+        const TensorShape shape({static_cast<int64>(messages.size())});
+        Tensor message_tensor(ctx->allocator({}), DT_STRING, shape);
+        Tensor key_tensor(ctx->allocator({}), DT_STRING, shape);
+        Tensor partition_tensor(ctx->allocator({}), DT_INT32, shape);
+        Tensor offset_tensor(ctx->allocator({}), DT_INT64, shape);
+        CopyMessages(messages, &message_tensor, &key_tensor);
+        for (size_t i = 0; i < messages.size(); i++) {
+          partition_tensor.flat<int32>()(i) = messages[i]->partition;
+          offset_tensor.flat<int64>()(i) = messages[i]->offset;
+        }
+        out_tensors->emplace_back(std::move(message_tensor));
+        out_tensors->emplace_back(std::move(key_tensor));
+        out_tensors->emplace_back(std::move(partition_tensor));
+        out_tensors->emplace_back(std::move(offset_tensor));
+        return OkStatus();
+      }
+
+     protected:
+      // The state is the next offset to deliver for each partition. Messages
+      // that were prefetched but not yet returned are fetched again after a
+      // restore.
+      Status SaveInternal(data::SerializationContext* ctx,
+                          data::IteratorStateWriter* writer) override {
+        mutex_lock l(mu_);
+        TF_RETURN_IF_ERROR(writer->WriteScalar(
+            full_name("partitions"), static_cast<int64>(partitions_.size())));
+        for (size_t i = 0; i < partitions_.size(); i++) {
+          TF_RETURN_IF_ERROR(writer->WriteScalar(
+              full_name(strings::StrCat("partition[", i, "]")),
+              static_cast<int64>(partitions_[i])));
+          TF_RETURN_IF_ERROR(writer->WriteScalar(
+              full_name(strings::StrCat("offset[", i, "]")), offsets_[i]));
+        }
+        return OkStatus();
+      }
+
+      Status RestoreInternal(data::IteratorContext* ctx,
+                             data::IteratorStateReader* reader) override {
+        mutex_lock l(mu_);
+        fetcher_.reset(nullptr);
+        int64 count;
+        TF_RETURN_IF_ERROR(
+            reader->ReadScalar(full_name("partitions"), &count));
+        partitions_.clear();
+        offsets_.clear();
+        for (int64 i = 0; i < count; i++) {
+          int64 partition, offset;
+          TF_RETURN_IF_ERROR(reader->ReadScalar(
+              full_name(strings::StrCat("partition[", i, "]")), &partition));
+          TF_RETURN_IF_ERROR(reader->ReadScalar(
+              full_name(strings::StrCat("offset[", i, "]")), &offset));
+          partitions_.push_back(static_cast<int32>(partition));
+          offsets_.push_back(offset);
+        }
+        return OkStatus();
+      }
+
+     private:
+      mutex mu_;
+      std::vector<int32> partitions_ TF_GUARDED_BY(mu_);
+      std::vector<int64> offsets_ TF_GUARDED_BY(mu_);
+      std::unique_ptr<KafkaPartitionFetcher> fetcher_ TF_GUARDED_BY(mu_);
+    };
+
+    const string topic_;
+    const std::vector<int32> partitions_;
+    const std::vector<int64> offsets_;
+    const int64 batch_size_;
+    const int64 capacity_;
+    const bool eof_;
+    const int64 timeout_;
+    const std::vector<string> metadata_;
+  };
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableInit").Device(DEVICE_CPU),
                         KafkaReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableNext").Device(DEVICE_CPU),
                         KafkaReadableNextOp);
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableRead").Device(DEVICE_CPU),
                         KafkaReadableReadOp);
+REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableReadRecords").Device(DEVICE_CPU),
+                        KafkaReadableReadRecordsOp);
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaReadableSpec").Device(DEVICE_CPU),
                         KafkaReadableSpecOp);
+REGISTER_KERNEL_BUILDER(Name("IO>KafkaWritableInit").Device(DEVICE_CPU),
+                        KafkaWritableInitOp);
+REGISTER_KERNEL_BUILDER(Name("IO>KafkaWritableWrite").Device(DEVICE_CPU),
+                        KafkaWritableWriteOp);
+REGISTER_KERNEL_BUILDER(Name("IO>KafkaWritableFlush").Device(DEVICE_CPU),
+                        KafkaWritableFlushOp);
+REGISTER_KERNEL_BUILDER(Name("IO>KafkaWritableResults").Device(DEVICE_CPU),
+                        KafkaWritableResultsOp);
 REGISTER_KERNEL_BUILDER(Name("IO>LayerKafkaInit").Device(DEVICE_CPU),
                         LayerKafkaInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>LayerKafkaCall").Device(DEVICE_CPU),
@@ -1142,6 +2239,8 @@ REGISTER_KERNEL_BUILDER(Name("IO>KafkaGroupReadableInit").Device(DEVICE_CPU),
                         KafkaGroupReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>KafkaGroupReadableNext").Device(DEVICE_CPU),
                         KafkaGroupReadableNextOp);
+REGISTER_KERNEL_BUILDER(Name("IO>KafkaPartitionedDataset").Device(DEVICE_CPU),
+                        KafkaPartitionedDatasetOp);
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
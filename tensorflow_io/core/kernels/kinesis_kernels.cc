@@ -21,6 +21,7 @@ limitations under the License.
 #include <aws/core/utils/crypto/Hash.h>
 #include <aws/core/utils/crypto/HashResult.h>
 #include <aws/kinesis/KinesisClient.h>
+#include <aws/kinesis/KinesisErrors.h>
 #include <aws/kinesis/model/DescribeStreamRequest.h>
 #include <aws/kinesis/model/GetRecordsRequest.h>
 #include <aws/kinesis/model/GetShardIteratorRequest.h>
@@ -29,8 +30,11 @@ limitations under the License.
 #include <openssl/hmac.h>
 #include <openssl/sha.h>
 
+#include <deque>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 namespace data {
@@ -256,8 +260,19 @@ void ShutdownClient(Aws::Kinesis::KinesisClient* client) {
 class KinesisReadableResource : public ResourceBase {
  public:
   KinesisReadableResource(Env* env)
-      : env_(env), client_(nullptr, ShutdownClient), interval_(100000) {}
-  virtual ~KinesisReadableResource() {}
+      : env_(env),
+        client_(nullptr, ShutdownClient),
+        interval_(100000),
+        limit_(1000) {}
+  virtual ~KinesisReadableResource() {
+    {
+      mutex_lock l(mu_);
+      cancelled_ = true;
+      cond_.notify_all();
+    }
+    // Join the shard workers before the client is released.
+    workers_.clear();
+  }
 
   Status Init(const string& input, const std::vector<string>& metadata) {
     mutex_lock l(mu_);
@@ -272,6 +287,13 @@ class KinesisReadableResource : public ResourceBase {
                                          metadata[i]);
         }
         shard_ = parts[1];
+      } else if (metadata[i].find("limit=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 || !strings::safe_strto64(parts[1], &limit_) ||
+            limit_ <= 0 || limit_ > 10000) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
       }
     }
 
@@ -285,52 +307,47 @@ class KinesisReadableResource : public ResourceBase {
       return errors::Unknown(outcome.GetError().GetExceptionName(), ": ",
                              outcome.GetError().GetMessage());
     }
-    Aws::String shard;
-    Aws::String sequence;
-    if (shard_ == "") {
-      if (outcome.GetResult().GetStreamDescription().GetShards().size() != 1) {
-        return errors::InvalidArgument(
-            "shard has to be provided unless the stream only have one "
-            "shard, there are ",
-            outcome.GetResult().GetStreamDescription().GetShards().size(),
-            " shards in stream ", stream_);
+    // Without an explicit shard, every shard of the stream is consumed.
+    std::vector<std::pair<Aws::String, Aws::String>> shards;
+    for (const auto& entry :
+         outcome.GetResult().GetStreamDescription().GetShards()) {
+      if (shard_ == "" || entry.GetShardId() == shard_.c_str()) {
+        shards.emplace_back(
+            entry.GetShardId(),
+            entry.GetSequenceNumberRange().GetStartingSequenceNumber());
       }
-      shard = outcome.GetResult()
-                  .GetStreamDescription()
-                  .GetShards()[0]
-                  .GetShardId();
-      sequence = outcome.GetResult()
-                     .GetStreamDescription()
-                     .GetShards()[0]
-                     .GetSequenceNumberRange()
-                     .GetStartingSequenceNumber();
-    } else {
-      for (const auto& entry :
-           outcome.GetResult().GetStreamDescription().GetShards()) {
-        if (entry.GetShardId() == shard_.c_str()) {
-          shard = entry.GetShardId();
-          sequence = entry.GetSequenceNumberRange().GetStartingSequenceNumber();
-          break;
-        }
-      }
-      if (shard == "") {
-        return errors::InvalidArgument("no shard ", shard_, " in stream ",
-                                       stream_);
+    }
+    if (shards.size() == 0) {
+      return errors::InvalidArgument("no shard ", shard_, " in stream ",
+                                     stream_);
+    }
+
+    std::vector<Aws::String> iterators;
+    for (const auto& shard : shards) {
+      Aws::Kinesis::Model::GetShardIteratorRequest iterator_request;
+      auto iterator_outcome = client_->GetShardIterator(
+          iterator_request.WithStreamName(stream_.c_str())
+              .WithShardId(shard.first)
+              .WithShardIteratorType(
+                  Aws::Kinesis::Model::ShardIteratorType::AT_SEQUENCE_NUMBER)
+              .WithStartingSequenceNumber(shard.second));
+      if (!iterator_outcome.IsSuccess()) {
+        return errors::Unknown(iterator_outcome.GetError().GetExceptionName(),
+                               ": ", iterator_outcome.GetError().GetMessage());
       }
+      iterators.push_back(iterator_outcome.GetResult().GetShardIterator());
     }
 
-    Aws::Kinesis::Model::GetShardIteratorRequest iterator_request;
-    auto iterator_outcome = client_->GetShardIterator(
-        iterator_request.WithStreamName(stream_.c_str())
-            .WithShardId(shard)
-            .WithShardIteratorType(
-                Aws::Kinesis::Model::ShardIteratorType::AT_SEQUENCE_NUMBER)
-            .WithStartingSequenceNumber(sequence));
-    if (!iterator_outcome.IsSuccess()) {
-      return errors::Unknown(iterator_outcome.GetError().GetExceptionName(),
-                             ": ", iterator_outcome.GetError().GetMessage());
+    // One worker per shard keeps up to `limit_` records of its shard in
+    // flight, so the buffer holds at most one more batch per shard.
+    capacity_ = limit_ * shards.size();
+    active_ = shards.size();
+    for (size_t i = 0; i < iterators.size(); i++) {
+      Aws::String iterator = iterators[i];
+      workers_.emplace_back(env_->StartThread(
+          ThreadOptions(), strings::StrCat("kinesis_shard_", i),
+          [this, iterator]() { ShardLoop(iterator); }));
     }
-    iterator_ = iterator_outcome.GetResult().GetShardIterator();
     return OkStatus();
   }
   Status Read(
@@ -339,53 +356,30 @@ class KinesisReadableResource : public ResourceBase {
                            Tensor** sequence_tensor)>
           allocate_func) {
     mutex_lock l(mu_);
-    do {
-      Aws::Kinesis::Model::GetRecordsRequest request;
-      auto outcome = client_->GetRecords(
-          request.WithShardIterator(iterator_).WithLimit(1));
-      if (!outcome.IsSuccess()) {
-        return errors::Unknown(outcome.GetError().GetExceptionName(), ": ",
-                               outcome.GetError().GetMessage());
-      }
-      if (outcome.GetResult().GetRecords().size() == 0) {
-        // TODO: break if option provided, as no records were returned then
-        // nothing is available at the moment.
-
-        // Otherwise continue the loop after a period of time.
-        env_->SleepForMicroseconds(interval_);
-        continue;
-      }
-      if (outcome.GetResult().GetRecords().size() != 1) {
-        return errors::Unknown("invalid number of records ",
-                               outcome.GetResult().GetRecords().size(),
-                               " returned");
-      }
-      iterator_ = outcome.GetResult().GetNextShardIterator();
-
-      Tensor* timestamp_tensor;
-      Tensor* data_tensor;
-      Tensor* partition_tensor;
-      Tensor* sequence_tensor;
-      TF_RETURN_IF_ERROR(allocate_func(TensorShape({1}), &timestamp_tensor,
-                                       &data_tensor, &partition_tensor,
-                                       &sequence_tensor));
-      const auto& timestamp =
-          outcome.GetResult().GetRecords()[0].GetApproximateArrivalTimestamp();
-      const auto& data = outcome.GetResult().GetRecords()[0].GetData();
-      const auto& partition =
-          outcome.GetResult().GetRecords()[0].GetPartitionKey();
-      const auto& sequence =
-          outcome.GetResult().GetRecords()[0].GetSequenceNumber();
-      timestamp_tensor->flat<int64>()(0) = timestamp.Millis();
-      data_tensor->flat<tstring>()(0) =
-          string(reinterpret_cast<const char*>(data.GetUnderlyingData()),
-                 data.GetLength());
-      partition_tensor->flat<tstring>()(0) =
-          string(partition.c_str(), partition.size());
-      sequence_tensor->flat<tstring>()(0) =
-          string(sequence.c_str(), sequence.size());
-      return OkStatus();
-    } while (true);
+    while (records_.empty() && active_ > 0 && status_.ok()) {
+      cond_.wait(l);
+    }
+    TF_RETURN_IF_ERROR(status_);
+
+    // All records buffered so far are returned at once; an empty batch means
+    // every shard has been closed and drained.
+    int64 count = std::min<int64>(records_.size(), limit_);
+    Tensor* timestamp_tensor;
+    Tensor* data_tensor;
+    Tensor* partition_tensor;
+    Tensor* sequence_tensor;
+    TF_RETURN_IF_ERROR(allocate_func(TensorShape({count}), &timestamp_tensor,
+                                     &data_tensor, &partition_tensor,
+                                     &sequence_tensor));
+    for (int64 i = 0; i < count; i++) {
+      Record& record = records_.front();
+      timestamp_tensor->flat<int64>()(i) = record.timestamp;
+      data_tensor->flat<tstring>()(i) = std::move(record.data);
+      partition_tensor->flat<tstring>()(i) = std::move(record.partition);
+      sequence_tensor->flat<tstring>()(i) = std::move(record.sequence);
+      records_.pop_front();
+    }
+    cond_.notify_all();
     return OkStatus();
   }
   string DebugString() const override {
@@ -394,14 +388,92 @@ class KinesisReadableResource : public ResourceBase {
   }
 
  protected:
+  struct Record {
+    int64 timestamp;
+    string data;
+    string partition;
+    string sequence;
+  };
+
+  // Pulls batches of up to `limit_` records from a single shard into
+  // `records_` until the shard is closed or the resource is destroyed.
+  void ShardLoop(Aws::String iterator) {
+    while (true) {
+      {
+        mutex_lock l(mu_);
+        while (records_.size() >= capacity_ && !cancelled_) {
+          cond_.wait(l);
+        }
+        if (cancelled_) {
+          return;
+        }
+      }
+      Aws::Kinesis::Model::GetRecordsRequest request;
+      auto outcome = client_->GetRecords(
+          request.WithShardIterator(iterator).WithLimit(limit_));
+      if (!outcome.IsSuccess()) {
+        if (outcome.GetError().GetErrorType() ==
+            Aws::Kinesis::KinesisErrors::PROVISIONED_THROUGHPUT_EXCEEDED) {
+          // Each shard only allows five GetRecords calls per second.
+          env_->SleepForMicroseconds(interval_ * 2);
+          continue;
+        }
+        mutex_lock l(mu_);
+        if (status_.ok()) {
+          status_ = errors::Unknown(outcome.GetError().GetExceptionName(),
+                                    ": ", outcome.GetError().GetMessage());
+        }
+        active_--;
+        cond_.notify_all();
+        return;
+      }
+      const auto& records = outcome.GetResult().GetRecords();
+      iterator = outcome.GetResult().GetNextShardIterator();
+      {
+        mutex_lock l(mu_);
+        for (const auto& entry : records) {
+          const auto& data = entry.GetData();
+          const auto& partition = entry.GetPartitionKey();
+          const auto& sequence = entry.GetSequenceNumber();
+          records_.push_back(
+              {entry.GetApproximateArrivalTimestamp().Millis(),
+               string(reinterpret_cast<const char*>(data.GetUnderlyingData()),
+                      data.GetLength()),
+               string(partition.c_str(), partition.size()),
+               string(sequence.c_str(), sequence.size())});
+        }
+        if (iterator.empty()) {
+          // The shard has been closed (e.g., after resharding).
+          active_--;
+          cond_.notify_all();
+          return;
+        }
+        if (records.size() != 0) {
+          cond_.notify_all();
+        }
+      }
+      if (records.size() == 0) {
+        // Nothing is available at the moment, retry after a period of time.
+        env_->SleepForMicroseconds(interval_);
+      }
+    }
+  }
+
   mutable mutex mu_;
-  Env* env_ TF_GUARDED_BY(mu_);
+  condition_variable cond_;
+  Env* env_;
   string stream_ TF_GUARDED_BY(mu_);
   string shard_ TF_GUARDED_BY(mu_);
-  Aws::String iterator_ TF_GUARDED_BY(mu_);
   std::unique_ptr<Aws::Kinesis::KinesisClient, decltype(&ShutdownClient)>
-      client_ TF_GUARDED_BY(mu_);
-  int64 interval_ TF_GUARDED_BY(mu_);
+      client_;
+  int64 interval_;
+  int64 limit_;
+  size_t capacity_ TF_GUARDED_BY(mu_) = 0;
+  size_t active_ TF_GUARDED_BY(mu_) = 0;
+  bool cancelled_ TF_GUARDED_BY(mu_) = false;
+  Status status_ TF_GUARDED_BY(mu_);
+  std::deque<Record> records_ TF_GUARDED_BY(mu_);
+  std::vector<std::unique_ptr<Thread>> workers_;
 };
 
 class KinesisReadableInitOp : public ResourceOpKernel<KinesisReadableResource> {
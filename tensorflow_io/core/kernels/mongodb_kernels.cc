@@ -23,10 +23,113 @@ namespace tensorflow {
 namespace io {
 namespace {
 
+// Decodes the BSON value under `iter` into row `index` of `tensor`. Numeric
+// values are converted between the BSON integer, double and boolean types,
+// while strings also accept object ids, binaries and (as relaxed extended
+// JSON) embedded documents and arrays.
+Status MongoDBDecodeValue(const bson_iter_t* iter, const string& field,
+                          int64 index, Tensor* tensor) {
+  const bson_type_t type = bson_iter_type(iter);
+  const bool numeric = (type == BSON_TYPE_INT32 || type == BSON_TYPE_INT64 ||
+                        type == BSON_TYPE_DOUBLE || type == BSON_TYPE_BOOL);
+  switch (tensor->dtype()) {
+    case DT_BOOL:
+      if (numeric) {
+        tensor->flat<bool>()(index) = bson_iter_as_bool(iter);
+        return OkStatus();
+      }
+      break;
+    case DT_INT32:
+      if (numeric) {
+        tensor->flat<int32>()(index) =
+            static_cast<int32>(bson_iter_as_int64(iter));
+        return OkStatus();
+      }
+      break;
+    case DT_INT64:
+      if (numeric) {
+        tensor->flat<int64>()(index) = bson_iter_as_int64(iter);
+        return OkStatus();
+      }
+      if (type == BSON_TYPE_DATE_TIME) {
+        tensor->flat<int64>()(index) = bson_iter_date_time(iter);
+        return OkStatus();
+      }
+      break;
+    case DT_FLOAT:
+      if (numeric) {
+        tensor->flat<float>()(index) =
+            static_cast<float>(bson_iter_as_double(iter));
+        return OkStatus();
+      }
+      break;
+    case DT_DOUBLE:
+      if (numeric) {
+        tensor->flat<double>()(index) = bson_iter_as_double(iter);
+        return OkStatus();
+      }
+      break;
+    case DT_STRING:
+      switch (type) {
+        case BSON_TYPE_UTF8: {
+          uint32_t length = 0;
+          const char* value = bson_iter_utf8(iter, &length);
+          tensor->flat<tstring>()(index).assign(value, length);
+          return OkStatus();
+        }
+        case BSON_TYPE_OID: {
+          char value[25];
+          bson_oid_to_string(bson_iter_oid(iter), value);
+          tensor->flat<tstring>()(index).assign(value, 24);
+          return OkStatus();
+        }
+        case BSON_TYPE_BINARY: {
+          bson_subtype_t subtype;
+          uint32_t length = 0;
+          const uint8_t* value = nullptr;
+          bson_iter_binary(iter, &subtype, &length, &value);
+          tensor->flat<tstring>()(index).assign(
+              reinterpret_cast<const char*>(value), length);
+          return OkStatus();
+        }
+        case BSON_TYPE_DOCUMENT:
+        case BSON_TYPE_ARRAY: {
+          uint32_t length = 0;
+          const uint8_t* data = nullptr;
+          if (type == BSON_TYPE_DOCUMENT) {
+            bson_iter_document(iter, &length, &data);
+          } else {
+            bson_iter_array(iter, &length, &data);
+          }
+          bson_t value;
+          if (!bson_init_static(&value, data, length)) {
+            return errors::DataLoss("Corrupted BSON value in field: ", field);
+          }
+          char* json = bson_as_relaxed_extended_json(&value, NULL);
+          tensor->flat<tstring>()(index) = json;
+          bson_free(json);
+          return OkStatus();
+        }
+        default:
+          break;
+      }
+      break;
+    default:
+      return errors::InvalidArgument("Unsupported data type for field ",
+                                     field, ": ",
+                                     DataTypeString(tensor->dtype()));
+  }
+  return errors::InvalidArgument("Unable to convert BSON type ",
+                                 static_cast<int>(type), " of field ", field,
+                                 " to ", DataTypeString(tensor->dtype()));
+}
+
 class MongoDBReadableResource : public ResourceBase {
  public:
   MongoDBReadableResource(Env* env) : env_(env) {}
   ~MongoDBReadableResource() {
+    mongoc_cursor_destroy(cursor_obj_);
+    bson_destroy(opts_);
     mongoc_collection_destroy(collection_obj_);
     mongoc_database_destroy(database_obj_);
     mongoc_uri_destroy(uri_obj_);
@@ -35,7 +138,8 @@ class MongoDBReadableResource : public ResourceBase {
   }
 
   Status Init(const std::string& uri, const std::string& database,
-              const std::string& collection) {
+              const std::string& collection,
+              const std::vector<string>& fields, const int64 batch_size) {
     //   Required to initialize libmongoc's internals
     mongoc_init();
 
@@ -47,6 +151,28 @@ class MongoDBReadableResource : public ResourceBase {
                                         "due to: ", error_.message);
     }
 
+    // Push the projection and the cursor batch size to the server, so that
+    // only the requested fields travel over the wire in as few round trips
+    // as the read batch needs.
+    fields_ = fields;
+    batch_size_ = batch_size;
+    if (fields_.size() > 0) {
+      bson_t projection;
+      BSON_APPEND_DOCUMENT_BEGIN(opts_, "projection", &projection);
+      bool id = false;
+      for (const auto& field : fields_) {
+        BSON_APPEND_INT32(&projection, field.c_str(), 1);
+        id = id || (field == "_id");
+      }
+      if (!id) {
+        BSON_APPEND_INT32(&projection, "_id", 0);
+      }
+      bson_append_document_end(opts_, &projection);
+    }
+    if (batch_size_ > 0) {
+      BSON_APPEND_INT32(opts_, "batchSize", static_cast<int32>(batch_size_));
+    }
+
     // Initialize the MongoDB client
 
     client_obj_ = mongoc_client_new_from_uri(uri_obj_);
@@ -61,7 +187,7 @@ class MongoDBReadableResource : public ResourceBase {
         client_obj_, database.c_str(), collection.c_str());
 
     cursor_obj_ =
-        mongoc_collection_find_with_opts(collection_obj_, query_, NULL, NULL);
+        mongoc_collection_find_with_opts(collection_obj_, query_, opts_, NULL);
 
     // Perform healthcheck before proceeding
     Healthcheck();
@@ -94,8 +220,9 @@ class MongoDBReadableResource : public ResourceBase {
 
     if (records.size() == 0) {
       // resetting the cursor after reaching the end of the collection.
-      cursor_obj_ =
-          mongoc_collection_find_with_opts(collection_obj_, query_, NULL, NULL);
+      mongoc_cursor_destroy(cursor_obj_);
+      cursor_obj_ = mongoc_collection_find_with_opts(collection_obj_, query_,
+                                                     opts_, NULL);
     }
     TensorShape shape({static_cast<int32>(records.size())});
     Tensor* records_tensor;
@@ -110,6 +237,59 @@ class MongoDBReadableResource : public ResourceBase {
     return OkStatus();
   }
 
+  // Decodes the projected fields of the next batch of documents straight
+  // into one column tensor per field, without a JSON round trip.
+  Status Read(const DataTypeVector& dtypes, std::vector<Tensor>* values) {
+    mutex_lock l(mu_);
+
+    if (dtypes.size() != fields_.size()) {
+      return errors::InvalidArgument("Expected ", fields_.size(),
+                                     " dtypes to match the projection, got ",
+                                     dtypes.size());
+    }
+
+    const int64 capacity = (batch_size_ > 0) ? batch_size_ : 1024;
+    values->clear();
+    values->reserve(dtypes.size());
+    for (size_t i = 0; i < dtypes.size(); i++) {
+      values->emplace_back(dtypes[i], TensorShape({capacity}));
+    }
+
+    const bson_t* doc;
+    int64 rows = 0;
+    while (rows < capacity && mongoc_cursor_next(cursor_obj_, &doc)) {
+      for (size_t i = 0; i < fields_.size(); i++) {
+        bson_iter_t iter, value;
+        if (!bson_iter_init(&iter, doc) ||
+            !bson_iter_find_descendant(&iter, fields_[i].c_str(), &value) ||
+            bson_iter_type(&value) == BSON_TYPE_NULL) {
+          return errors::InvalidArgument("Field ", fields_[i],
+                                         " is missing in document ", rows);
+        }
+        TF_RETURN_IF_ERROR(
+            MongoDBDecodeValue(&value, fields_[i], rows, &(*values)[i]));
+      }
+      rows++;
+    }
+    if (mongoc_cursor_error(cursor_obj_, &error_)) {
+      return errors::Internal("Failed to read from the cursor due to: ",
+                              error_.message);
+    }
+
+    if (rows == 0) {
+      // resetting the cursor after reaching the end of the collection.
+      mongoc_cursor_destroy(cursor_obj_);
+      cursor_obj_ = mongoc_collection_find_with_opts(collection_obj_, query_,
+                                                     opts_, NULL);
+    }
+    if (rows < capacity) {
+      for (size_t i = 0; i < values->size(); i++) {
+        (*values)[i] = (*values)[i].Slice(0, rows);
+      }
+    }
+    return OkStatus();
+  }
+
   string DebugString() const override { return "MongoDBReadableResource"; }
 
  protected:
@@ -132,12 +312,15 @@ class MongoDBReadableResource : public ResourceBase {
 
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
-  mongoc_uri_t* uri_obj_;
-  mongoc_client_t* client_obj_;
-  mongoc_database_t* database_obj_;
-  mongoc_collection_t* collection_obj_;
-  mongoc_cursor_t* cursor_obj_;
+  mongoc_uri_t* uri_obj_ = nullptr;
+  mongoc_client_t* client_obj_ = nullptr;
+  mongoc_database_t* database_obj_ = nullptr;
+  mongoc_collection_t* collection_obj_ = nullptr;
+  mongoc_cursor_t* cursor_obj_ = nullptr;
   bson_t* query_ = bson_new();
+  bson_t* opts_ = bson_new();
+  std::vector<string> fields_;
+  int64 batch_size_ = 0;
   bson_t *cmd_, reply_;
   bson_error_t error_;
   char* str;
@@ -149,6 +332,8 @@ class MongoDBReadableInitOp : public ResourceOpKernel<MongoDBReadableResource> {
   explicit MongoDBReadableInitOp(OpKernelConstruction* context)
       : ResourceOpKernel<MongoDBReadableResource>(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("fields", &fields_));
+    OP_REQUIRES_OK(context, context->GetAttr("batch_size", &batch_size_));
   }
 
  private:
@@ -167,7 +352,8 @@ class MongoDBReadableInitOp : public ResourceOpKernel<MongoDBReadableResource> {
     OP_REQUIRES_OK(context, context->input("collection", &collection_tensor));
     const string& collection = collection_tensor->scalar<tstring>()();
 
-    OP_REQUIRES_OK(context, resource_->Init(uri, database, collection));
+    OP_REQUIRES_OK(context, resource_->Init(uri, database, collection,
+                                            fields_, batch_size_));
   }
 
   Status CreateResource(MongoDBReadableResource** resource)
@@ -179,6 +365,8 @@ class MongoDBReadableInitOp : public ResourceOpKernel<MongoDBReadableResource> {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  std::vector<string> fields_;
+  int64 batch_size_;
 };
 
 class MongoDBReadableNextOp : public OpKernel {
@@ -203,6 +391,30 @@ class MongoDBReadableNextOp : public OpKernel {
   mutable mutex mu_;
 };
 
+class MongoDBReadableReadOp : public OpKernel {
+ public:
+  explicit MongoDBReadableReadOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("dtypes", &dtypes_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    MongoDBReadableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "resource", &resource));
+    core::ScopedUnref unref(resource);
+
+    std::vector<Tensor> values;
+    OP_REQUIRES_OK(context, resource->Read(dtypes_, &values));
+    for (size_t i = 0; i < values.size(); i++) {
+      context->set_output(i, values[i]);
+    }
+  }
+
+ private:
+  DataTypeVector dtypes_;
+};
+
 class MongoDBWritableResource : public ResourceBase {
  public:
   MongoDBWritableResource(Env* env) : env_(env) {}
@@ -404,6 +616,8 @@ REGISTER_KERNEL_BUILDER(Name("IO>MongoDBReadableInit").Device(DEVICE_CPU),
                         MongoDBReadableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>MongoDBReadableNext").Device(DEVICE_CPU),
                         MongoDBReadableNextOp);
+REGISTER_KERNEL_BUILDER(Name("IO>MongoDBReadableRead").Device(DEVICE_CPU),
+                        MongoDBReadableReadOp);
 REGISTER_KERNEL_BUILDER(Name("IO>MongoDBWritableInit").Device(DEVICE_CPU),
                         MongoDBWritableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>MongoDBWritableWrite").Device(DEVICE_CPU),
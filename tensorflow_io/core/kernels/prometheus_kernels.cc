@@ -13,9 +13,14 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <limits>
+
 #include "absl/time/clock.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow_io/core/golang_ops.h"
 
 namespace tensorflow {
@@ -36,6 +41,8 @@ class PrometheusReadableResource : public ResourceBase {
     endpoint_ = "http://localhost:9090";
     int64 length = -1;
     int64 offset = -1;
+    int64 concurrency = 4;
+    window_ = 1000;
     for (size_t i = 0; i < metadata.size(); i++) {
       if (metadata[i].find("length=") == 0) {
         std::vector<string> parts = str_util::Split(metadata[i], "=");
@@ -56,11 +63,30 @@ class PrometheusReadableResource : public ResourceBase {
                                          metadata[i]);
         }
         endpoint_ = parts[1];
+      } else if (metadata[i].find("window=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 || !strings::safe_strto64(parts[1], &window_) ||
+            window_ <= 0) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
+      } else if (metadata[i].find("concurrency=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            !strings::safe_strto64(parts[1], &concurrency) ||
+            concurrency <= 0) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
       }
     }
     if (length < 0) {
       return errors::InvalidArgument("length must be provided");
     }
+    // Sub-windows are fetched on a dedicated pool as the range queries
+    // block on the network rather than on the CPU.
+    pool_.reset(new thread::ThreadPool(env_, "prometheus_read",
+                                       static_cast<int>(concurrency)));
     if (offset < 0) {
       stop_ = absl::GetCurrentTimeNanos() / 1000000;
     } else {
@@ -131,6 +157,7 @@ class PrometheusReadableResource : public ResourceBase {
       metrics->tensor<tstring, 2>()(index, 1) = instance;
       metrics->tensor<tstring, 2>()(index, 2) = name;
     }
+    CacheSeries();
     return OkStatus();
   }
   Status Spec(int64* start, int64* stop) {
@@ -139,6 +166,12 @@ class PrometheusReadableResource : public ResourceBase {
     *stop = stop_;
     return OkStatus();
   }
+  // Reads [start, stop) at a one second step. The range is split into
+  // step-aligned sub-windows of at most `window_` samples, which keeps every
+  // query below the server's sample limit, and the sub-windows are fetched
+  // concurrently. Each query returns all series at once and writes them in
+  // place into the preallocated value tensor; samples missing on the server
+  // are NaN.
   Status Read(const int64 start, const int64 stop, std::vector<string>& jobs,
               std::vector<string>& instances, std::vector<string>& names,
               std::function<Status(const TensorShape& timestamp_shape,
@@ -146,7 +179,8 @@ class PrometheusReadableResource : public ResourceBase {
                                    Tensor** timestamp, Tensor** value)>
                   allocate_func) {
     mutex_lock l(mu_);
-    int64 interval = (stop - start) / 1000;
+    const int64 step = 1000;
+    int64 interval = (stop - start) / step;
 
     if (jobs.size() != instances.size() || jobs.size() != names.size()) {
       return errors::InvalidArgument(
@@ -160,28 +194,51 @@ class PrometheusReadableResource : public ResourceBase {
         allocate_func(TensorShape({interval}),
                       TensorShape({static_cast<int64>(names.size()), interval}),
                       &timestamp, &value));
+    for (int64 i = 0; i < interval; i++) {
+      timestamp->flat<int64>()(i) = start + i * step;
+    }
+    value->flat<double>().setConstant(std::numeric_limits<double>::quiet_NaN());
+    if (interval <= 0 || names.size() == 0) {
+      return OkStatus();
+    }
+
+    // The series metadata only changes when the caller asks for a different
+    // set of metrics, so the Go strings pointing into it are kept around.
+    if (jobs != jobs_ || instances != instances_ || names != names_) {
+      jobs_ = jobs;
+      instances_ = instances;
+      names_ = names;
+      CacheSeries();
+    }
+    const GoInt count = static_cast<GoInt>(jobs_.size());
+    GoSlice jobs_go = {jobs_go_.data(), count, count};
+    GoSlice instances_go = {instances_go_.data(), count, count};
+    GoSlice names_go = {names_go_.data(), count, count};
+    GoSlice value_go = {value->flat<double>().data(), value->NumElements(),
+                        value->NumElements()};
 
     GoString endpoint_go = {endpoint_.c_str(),
                             static_cast<int64>(endpoint_.size())};
     GoString query_go = {query_.c_str(), static_cast<int64>(query_.size())};
 
-    for (size_t index = 0; index < jobs.size(); index++) {
-      GoString job_go = {jobs[index].data(),
-                         static_cast<ptrdiff_t>(jobs[index].size())};
-      GoString instance_go = {instances[index].data(),
-                              static_cast<ptrdiff_t>(instances[index].size())};
-      GoString name_go = {names[index].data(),
-                          static_cast<ptrdiff_t>(names[index].size())};
-      GoSlice timestamp_go = {timestamp->flat<int64>().data(),
-                              timestamp->NumElements(),
-                              timestamp->NumElements()};
-      double* value_p = (double*)(value->flat<double>().data()) +
-                        index * timestamp->NumElements();
-      GoSlice value_go = {value_p, timestamp->NumElements(),
-                          timestamp->NumElements()};
-      GoInt returned = QueryRange(endpoint_go, query_go, start, stop, job_go,
-                                  instance_go, name_go, timestamp_go, value_go);
-      if (returned < 0) {
+    const int64 window = window_;
+    const int64 windows = (interval + window - 1) / window;
+    std::vector<GoInt> returned(windows, 0);
+    BlockingCounter counter(windows);
+    for (int64 w = 0; w < windows; w++) {
+      pool_->Schedule([&, w]() {
+        const int64 offset = w * window;
+        const int64 size = std::min(window, interval - offset);
+        returned[w] = QueryRangeWindow(
+            endpoint_go, query_go, start + offset * step,
+            start + (offset + size) * step, step, jobs_go, instances_go,
+            names_go, value_go, offset, interval);
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+    for (int64 w = 0; w < windows; w++) {
+      if (returned[w] < 0) {
         return errors::InvalidArgument("unable to query prometheus");
       }
     }
@@ -194,6 +251,21 @@ class PrometheusReadableResource : public ResourceBase {
   }
 
  protected:
+  void CacheSeries() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    jobs_go_.clear();
+    instances_go_.clear();
+    names_go_.clear();
+    for (size_t index = 0; index < jobs_.size(); index++) {
+      jobs_go_.push_back({jobs_[index].data(),
+                          static_cast<ptrdiff_t>(jobs_[index].size())});
+      instances_go_.push_back(
+          {instances_[index].data(),
+           static_cast<ptrdiff_t>(instances_[index].size())});
+      names_go_.push_back({names_[index].data(),
+                           static_cast<ptrdiff_t>(names_[index].size())});
+    }
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   string query_ TF_GUARDED_BY(mu_);
@@ -203,6 +275,11 @@ class PrometheusReadableResource : public ResourceBase {
   std::vector<string> jobs_ TF_GUARDED_BY(mu_);
   std::vector<string> instances_ TF_GUARDED_BY(mu_);
   std::vector<string> names_ TF_GUARDED_BY(mu_);
+  std::vector<GoString> jobs_go_ TF_GUARDED_BY(mu_);
+  std::vector<GoString> instances_go_ TF_GUARDED_BY(mu_);
+  std::vector<GoString> names_go_ TF_GUARDED_BY(mu_);
+  int64 window_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<thread::ThreadPool> pool_;
 };
 
 class PrometheusReadableInitOp
@@ -25,21 +25,41 @@ limitations under the License.
 #include "google/pubsub/v1/pubsub.grpc.pb.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
 using google::pubsub::v1::AcknowledgeRequest;
+using google::pubsub::v1::ModifyAckDeadlineRequest;
 using google::pubsub::v1::PullRequest;
 using google::pubsub::v1::PullResponse;
 using google::pubsub::v1::Subscriber;
 using grpc::ClientContext;
 
+// Upper bound of ack ids sent in a single Acknowledge/ModifyAckDeadline RPC.
+constexpr size_t kMaxAckIds = 1000;
+
 class PubSubReadableResource : public ResourceBase {
  public:
   PubSubReadableResource(Env* env) : env_(env) {}
-  ~PubSubReadableResource() {}
+  ~PubSubReadableResource() {
+    if (ack_thread_ != nullptr) {
+      {
+        mutex_lock l(ack_mu_);
+        // Messages of the last batch were delivered, acknowledge them too.
+        for (const auto& entry : inflight_) {
+          pending_.push_back(entry.first);
+        }
+        inflight_.clear();
+        cancelled_ = true;
+        ack_cond_.notify_all();
+      }
+      // Joins the ack thread after the final flush.
+      ack_thread_.reset(nullptr);
+    }
+  }
 
   Status Init(const string& input, const std::vector<string>& metadata) {
     mutex_lock l(mu_);
@@ -47,6 +67,8 @@ class PubSubReadableResource : public ResourceBase {
     endpoint_ = "";
     subscription_ = input;
     timeout_ = 10 * 1000;
+    max_messages_ = 1000;
+    ack_deadline_ = 10;
     for (size_t i = 0; i < metadata.size(); i++) {
       if (metadata[i].find("endpoint=") == 0) {
         std::vector<string> parts = str_util::Split(metadata[i], "=");
@@ -61,6 +83,22 @@ class PubSubReadableResource : public ResourceBase {
           return errors::InvalidArgument("invalid configuration: ",
                                          metadata[i]);
         }
+      } else if (metadata[i].find("max_messages=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            !strings::safe_strto64(parts[1], &max_messages_) ||
+            max_messages_ <= 0) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
+      } else if (metadata[i].find("ack_deadline=") == 0) {
+        std::vector<string> parts = str_util::Split(metadata[i], "=");
+        if (parts.size() != 2 ||
+            !strings::safe_strto64(parts[1], &ack_deadline_) ||
+            ack_deadline_ < 10 || ack_deadline_ > 600) {
+          return errors::InvalidArgument("invalid configuration: ",
+                                         metadata[i]);
+        }
       }
     }
     string endpoint = endpoint_;
@@ -73,6 +111,12 @@ class PubSubReadableResource : public ResourceBase {
       endpoint = endpoint_.substr(8);
     }
     stub_ = Subscriber::NewStub(grpc::CreateChannel(endpoint, creds));
+    eof_ = false;
+
+    if (ack_thread_ == nullptr) {
+      ack_thread_.reset(env_->StartThread(ThreadOptions(), "pubsub_ack",
+                                          [this]() { AckLoop(); }));
+    }
 
     return OkStatus();
   }
@@ -80,57 +124,63 @@ class PubSubReadableResource : public ResourceBase {
                                    Tensor** data_tensor, Tensor** time_tensor)>
                   allocate_func) {
     mutex_lock l(mu_);
-    if (stub_.get() == nullptr) {
+    if (eof_) {
       return errors::OutOfRange("EOF reached");
     }
-    ClientContext context;
-    if (timeout_ > 0) {
-      std::chrono::system_clock::time_point deadline =
-          std::chrono::system_clock::now() +
-          std::chrono::milliseconds(timeout_);
-      context.set_deadline(deadline);
+    // A new read means the previous batch has been consumed, so its messages
+    // are handed over to the ack thread.
+    {
+      mutex_lock ack_lock(ack_mu_);
+      for (const auto& entry : inflight_) {
+        pending_.push_back(entry.first);
+      }
+      inflight_.clear();
+      ack_cond_.notify_all();
     }
     Tensor* id_tensor;
     Tensor* data_tensor;
     Tensor* time_tensor;
     while (true) {
+      ClientContext context;
+      if (timeout_ > 0) {
+        std::chrono::system_clock::time_point deadline =
+            std::chrono::system_clock::now() +
+            std::chrono::milliseconds(timeout_);
+        context.set_deadline(deadline);
+      }
       PullRequest request;
       request.set_subscription(subscription_);
-      request.set_max_messages(1);
+      request.set_max_messages(max_messages_);
       PullResponse response;
       auto status = stub_->Pull(&context, request, &response);
-      if (!status.ok()) {
+      if (!status.ok() &&
+          !(timeout_ > 0 &&
+            status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)) {
         return errors::Internal("Failed to receive message: ",
                                 status.error_message());
       }
-      if (response.received_messages().size() == 0 && timeout_ > 0) {
+      const int64 count = response.received_messages().size();
+      if (count == 0 && timeout_ > 0) {
         // break subscription if there is a timeout, and no message.
         TF_RETURN_IF_ERROR(allocate_func(TensorShape({0}), &id_tensor,
                                          &data_tensor, &time_tensor));
-        stub_.reset(nullptr);
+        eof_ = true;
         return OkStatus();
       }
-      if (response.received_messages().size() != 0) {
-        TF_RETURN_IF_ERROR(allocate_func(TensorShape({1}), &id_tensor,
+      if (count != 0) {
+        TF_RETURN_IF_ERROR(allocate_func(TensorShape({count}), &id_tensor,
                                          &data_tensor, &time_tensor));
-        id_tensor->scalar<tstring>()() =
-            std::string((response.received_messages(0).message().message_id()));
-        data_tensor->scalar<tstring>()() =
-            std::string((response.received_messages(0).message().data()));
-        time_tensor->scalar<int64>()() =
-            response.received_messages(0).message().publish_time().seconds() *
-                1000 +
-            response.received_messages(0).message().publish_time().nanos() /
-                1000000;
-
-        // Acknowledge
-        AcknowledgeRequest acknowledge;
-        acknowledge.add_ack_ids(response.received_messages(0).ack_id());
-        acknowledge.set_subscription(subscription_);
-        google::protobuf::Empty empty;
-        ClientContext ack_context;
-        status = stub_->Acknowledge(&ack_context, acknowledge, &empty);
-
+        const uint64 now = env_->NowMicros();
+        mutex_lock ack_lock(ack_mu_);
+        for (int64 i = 0; i < count; i++) {
+          const auto& received = response.received_messages(i);
+          id_tensor->flat<tstring>()(i) = received.message().message_id();
+          data_tensor->flat<tstring>()(i) = received.message().data();
+          time_tensor->flat<int64>()(i) =
+              received.message().publish_time().seconds() * 1000 +
+              received.message().publish_time().nanos() / 1000000;
+          inflight_.emplace_back(received.ack_id(), now);
+        }
         return OkStatus();
       }
     }
@@ -142,15 +192,83 @@ class PubSubReadableResource : public ResourceBase {
   }
 
  protected:
+  // Flushes pending acks in bulk, and extends the ack deadline of messages
+  // that have been delivered but not yet acknowledged, so that a slow
+  // consumer does not cause redelivery.
+  void AckLoop() {
+    while (true) {
+      std::vector<string> acks;
+      std::vector<string> extends;
+      bool cancelled;
+      {
+        mutex_lock l(ack_mu_);
+        if (pending_.empty() && !cancelled_) {
+          ack_cond_.wait_for(l, std::chrono::milliseconds(100));
+        }
+        acks.swap(pending_);
+        const uint64 now = env_->NowMicros();
+        const uint64 extend_after = static_cast<uint64>(ack_deadline_) * 500000;
+        for (auto& entry : inflight_) {
+          if (now - entry.second > extend_after) {
+            extends.push_back(entry.first);
+            entry.second = now;
+          }
+        }
+        cancelled = cancelled_;
+      }
+      for (size_t i = 0; i < acks.size(); i += kMaxAckIds) {
+        AcknowledgeRequest request;
+        request.set_subscription(subscription_);
+        for (size_t j = i; j < std::min(acks.size(), i + kMaxAckIds); j++) {
+          request.add_ack_ids(acks[j]);
+        }
+        google::protobuf::Empty empty;
+        ClientContext context;
+        auto status = stub_->Acknowledge(&context, request, &empty);
+        if (!status.ok()) {
+          LOG(WARNING) << "Failed to acknowledge messages: "
+                       << status.error_message();
+        }
+      }
+      for (size_t i = 0; i < extends.size(); i += kMaxAckIds) {
+        ModifyAckDeadlineRequest request;
+        request.set_subscription(subscription_);
+        request.set_ack_deadline_seconds(ack_deadline_);
+        for (size_t j = i; j < std::min(extends.size(), i + kMaxAckIds); j++) {
+          request.add_ack_ids(extends[j]);
+        }
+        google::protobuf::Empty empty;
+        ClientContext context;
+        auto status = stub_->ModifyAckDeadline(&context, request, &empty);
+        if (!status.ok()) {
+          LOG(WARNING) << "Failed to extend ack deadline: "
+                       << status.error_message();
+        }
+      }
+      if (cancelled) {
+        return;
+      }
+    }
+  }
+
   mutable mutex mu_;
-  Env* env_ TF_GUARDED_BY(mu_);
-  string subscription_ TF_GUARDED_BY(mu_);
+  Env* env_;
+  string subscription_;
   string endpoint_ TF_GUARDED_BY(mu_);
   int64 timeout_ TF_GUARDED_BY(mu_);
-  std::unique_ptr<Subscriber::Stub> stub_ TF_GUARDED_BY(mu_);
-  string message_id_ TF_GUARDED_BY(mu_);
-  string message_data_ TF_GUARDED_BY(mu_);
-  int64 message_time_ TF_GUARDED_BY(mu_);
+  int64 max_messages_ TF_GUARDED_BY(mu_);
+  int64 ack_deadline_;
+  bool eof_ TF_GUARDED_BY(mu_) = false;
+  std::unique_ptr<Subscriber::Stub> stub_;
+
+  mutex ack_mu_;
+  condition_variable ack_cond_;
+  // Ack ids of messages ready to be acknowledged.
+  std::vector<string> pending_ TF_GUARDED_BY(ack_mu_);
+  // Ack ids of delivered messages, with the time of the last deadline update.
+  std::vector<std::pair<string, uint64>> inflight_ TF_GUARDED_BY(ack_mu_);
+  bool cancelled_ TF_GUARDED_BY(ack_mu_) = false;
+  std::unique_ptr<Thread> ack_thread_;
 };
 
 class PubSubReadableInitOp : public ResourceOpKernel<PubSubReadableResource> {
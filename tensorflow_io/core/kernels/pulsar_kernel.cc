@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <unordered_map>
+
 #include "pulsar/Client.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
@@ -44,7 +46,8 @@ class PulsarResourceBase : public ResourceBase {
 class PulsarReadableResource final : public PulsarResourceBase {
  public:
   Status Init(const std::string& service_url, const std::string& topic,
-              const std::string& subscription, int64 ack_grouping_time) {
+              const std::string& subscription, int64 ack_grouping_time,
+              bool batch_receive, int64 batch_receive_timeout) {
     mutex_lock l(mu_);
     PulsarResourceBase::Init(service_url);
 
@@ -52,6 +55,13 @@ class PulsarReadableResource final : public PulsarResourceBase {
     conf.setConsumerType(pulsar::ConsumerFailover);
     conf.setSubscriptionInitialPosition(pulsar::InitialPositionEarliest);
     conf.setAckGroupingTimeMs(ack_grouping_time);
+    batch_receive_ = batch_receive;
+    if (batch_receive_) {
+      // No limit on bytes, a batch is complete with max_num_messages or once
+      // batch_receive_timeout passed.
+      conf.setBatchReceivePolicy(pulsar::BatchReceivePolicy(
+          max_num_messages, -1, batch_receive_timeout));
+    }
 
     auto result = client_->subscribe(topic, subscription, conf, consumer_);
     if (result != pulsar::ResultOk) {
@@ -71,7 +81,10 @@ class PulsarReadableResource final : public PulsarResourceBase {
                   allocate_func) {
     mutex_lock l(mu_);
 
-    constexpr size_t max_num_messages = 1024;
+    if (batch_receive_) {
+      return NextBatch(timeout, poll_timeout, allocate_func);
+    }
+
     std::vector<std::string> values;
     std::vector<std::string> keys;
     values.reserve(max_num_messages);
@@ -122,13 +135,83 @@ class PulsarReadableResource final : public PulsarResourceBase {
   std::string DebugString() const override { return "PulsarReadableResource"; }
 
  private:
+  // Receives whole batches with batchReceive and acknowledges each batch
+  // with one cumulative acknowledgement per partition, instead of one round
+  // trip per message.
+  Status NextBatch(const int32 timeout, const int32 poll_timeout,
+                   std::function<Status(const TensorShape& shape,
+                                        Tensor** message, Tensor** key,
+                                        Tensor** continue_fetch)>
+                       allocate_func) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    std::vector<pulsar::Message> received;
+    received.reserve(max_num_messages);
+
+    int32 elapsed_time = 0;
+    while (elapsed_time < timeout && received.size() < max_num_messages) {
+      pulsar::Messages messages;
+      auto result = consumer_.batchReceive(messages);
+      if (result != pulsar::ResultOk && result != pulsar::ResultTimeout) {
+        return errors::Internal("failed to receive messages, error: ",
+                                pulsar::strResult(result));
+      }
+      if (messages.empty()) {
+        elapsed_time += poll_timeout;
+        continue;
+      }
+      elapsed_time = 0;  // reset the current timeout
+      for (auto& message : messages) {
+        received.emplace_back(std::move(message));
+      }
+    }
+
+    // Messages of a partition are received in order, so acknowledging the
+    // last one of each partition covers the whole batch.
+    std::unordered_map<std::string, pulsar::MessageId> last;
+    for (const auto& message : received) {
+      last[message.getTopicName()] = message.getMessageId();
+    }
+    for (const auto& entry : last) {
+      pulsar::MessageId id = entry.second;
+      consumer_.acknowledgeCumulativeAsync(id, [id](pulsar::Result result) {
+        if (result != pulsar::ResultOk) {
+          LOG(ERROR) << "Failed to acknowledge up to " << id;
+        }
+      });
+    }
+
+    TensorShape shape({static_cast<int64>(received.size())});
+    Tensor* value_tensor;
+    Tensor* key_tensor;
+    Tensor* continue_fetch_tensor;
+    TF_RETURN_IF_ERROR(allocate_func(shape, &value_tensor, &key_tensor,
+                                     &continue_fetch_tensor));
+
+    continue_fetch_tensor->scalar<int64>()() = (received.empty() ? 0 : 1);
+    for (size_t i = 0; i < received.size(); i++) {
+      const pulsar::Message& message = received[i];
+      value_tensor->flat<tstring>()(i).assign(
+          static_cast<const char*>(message.getData()), message.getLength());
+      if (message.hasPartitionKey()) {
+        key_tensor->flat<tstring>()(i) = message.getPartitionKey();
+      }
+    }
+
+    return OkStatus();
+  }
+
+  static constexpr size_t max_num_messages = 1024;
   pulsar::Consumer consumer_;
+  bool batch_receive_ = false;
 };
 
 class PulsarReadableInitOp : public ResourceOpKernel<PulsarReadableResource> {
  public:
   explicit PulsarReadableInitOp(OpKernelConstruction* context)
-      : ResourceOpKernel<PulsarReadableResource>(context) {}
+      : ResourceOpKernel<PulsarReadableResource>(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("batch_receive", &batch_receive_));
+    OP_REQUIRES_OK(context, context->GetAttr("batch_receive_timeout",
+                                             &batch_receive_timeout_));
+  }
 
  private:
   void Compute(OpKernelContext* context) override {
@@ -154,7 +237,8 @@ class PulsarReadableInitOp : public ResourceOpKernel<PulsarReadableResource> {
     const int64 ack_grouping_time = ack_grouping_time_tensor->scalar<int64>()();
 
     OP_REQUIRES_OK(context, resource_->Init(service_url, topic, subscription,
-                                            ack_grouping_time));
+                                            ack_grouping_time, batch_receive_,
+                                            batch_receive_timeout_));
   }
 
   Status CreateResource(PulsarReadableResource** resource)
@@ -165,6 +249,8 @@ class PulsarReadableInitOp : public ResourceOpKernel<PulsarReadableResource> {
 
  private:
   mutable mutex mu_;
+  bool batch_receive_;
+  int64 batch_receive_timeout_;
 };
 
 class PulsarReadableNextOp : public OpKernel {
@@ -207,7 +293,16 @@ class PulsarReadableNextOp : public OpKernel {
 
 class PulsarWritableResource final : public PulsarResourceBase {
  public:
-  Status Init(const std::string& service_url, const std::string& topic) {
+  ~PulsarWritableResource() {
+    // Completes the pending send callbacks while this resource is alive.
+    producer_.flush();
+    producer_.close();
+  }
+
+  Status Init(const std::string& service_url, const std::string& topic,
+              bool batching, int64 batching_max_messages,
+              int64 batching_max_publish_delay,
+              const std::string& compression) {
     mutex_lock l(mu_);
     PulsarResourceBase::Init(service_url);
     index_ = 0;
@@ -215,6 +310,26 @@ class PulsarWritableResource final : public PulsarResourceBase {
     pulsar::ProducerConfiguration conf;
     conf.setPartitionsRoutingMode(
         pulsar::ProducerConfiguration::RoundRobinDistribution);
+    // With batching, messages queued by sendAsync are sent in one request
+    // per batch instead of one per message.
+    conf.setBatchingEnabled(batching);
+    if (batching) {
+      conf.setBatchingMaxMessagesPerBatch(batching_max_messages);
+      conf.setBatchingMaxPublishDelayMs(batching_max_publish_delay);
+      conf.setBlockIfQueueFull(true);
+    }
+    if (compression == "lz4") {
+      conf.setCompressionType(pulsar::CompressionLZ4);
+    } else if (compression == "zlib") {
+      conf.setCompressionType(pulsar::CompressionZLib);
+    } else if (compression == "zstd") {
+      conf.setCompressionType(pulsar::CompressionZSTD);
+    } else if (compression == "snappy") {
+      conf.setCompressionType(pulsar::CompressionSNAPPY);
+    } else if (!compression.empty() && compression != "none") {
+      return errors::InvalidArgument("unsupported compression: ",
+                                     compression);
+    }
 
     auto result = client_->createProducer(topic, conf, producer_);
     if (result != pulsar::ResultOk) {
@@ -226,28 +341,42 @@ class PulsarWritableResource final : public PulsarResourceBase {
     return OkStatus();
   }
 
-  Status WriteAsync(const std::string& value, const std::string& key) {
+  // Queues every element of `value`; `key` is either a single key for all
+  // of them or one key per element.
+  Status WriteAsync(const Tensor& value, const Tensor& key) {
     mutex_lock l(mu_);
-    pulsar::MessageBuilder builder;
-    if (!key.empty()) {
-      builder.setPartitionKey(key);
+    if (key.NumElements() != 1 && key.NumElements() != value.NumElements()) {
+      return errors::InvalidArgument("key has ", key.NumElements(),
+                                     " elements while value has ",
+                                     value.NumElements());
     }
-    auto send_async_result = pulsar::ResultOk;
-    producer_.sendAsync(
-        builder.setContent(value).build(),
-        [index = index_, &send_async_result](pulsar::Result result,
-                                             const pulsar::MessageId& id) {
-          if (result != pulsar::ResultOk) {
-            LOG(ERROR) << "failed to send message-" << index << ": " << result;
-          }
-          send_async_result = result;
-        });
-    // sendAsync may fail immediately caused by queue is full
-    if (send_async_result != pulsar::ResultOk) {
-      return errors::Internal("sendAsync failed for index: ", index_,
-                              " error: ", pulsar::strResult(send_async_result));
+    TF_RETURN_IF_ERROR(SendStatus());
+    for (int64 i = 0; i < value.NumElements(); i++) {
+      const tstring& content = value.flat<tstring>()(i);
+      const tstring& partition_key =
+          key.flat<tstring>()(key.NumElements() == 1 ? 0 : i);
+      pulsar::MessageBuilder builder;
+      if (!partition_key.empty()) {
+        builder.setPartitionKey(partition_key);
+      }
+      builder.setContent(content.data(), content.size());
+      producer_.sendAsync(
+          builder.build(), [this, index = index_](pulsar::Result result,
+                                                  const pulsar::MessageId& id) {
+            if (result != pulsar::ResultOk) {
+              LOG(ERROR) << "failed to send message-" << index << ": "
+                         << result;
+              mutex_lock l(send_mu_);
+              if (send_result_ == pulsar::ResultOk) {
+                send_result_ = result;
+                send_index_ = index;
+              }
+            }
+          });
+      // sendAsync may fail immediately caused by queue is full
+      TF_RETURN_IF_ERROR(SendStatus());
+      index_++;
     }
-    index_++;
     return OkStatus();
   }
 
@@ -257,20 +386,43 @@ class PulsarWritableResource final : public PulsarResourceBase {
     if (result != pulsar::ResultOk) {
       return errors::Internal("failed to flush: ", pulsar::strResult(result));
     }
-    return OkStatus();
+    return SendStatus();
   }
 
   std::string DebugString() const override { return "PulsarWritableResource"; }
 
  private:
+  // Reports (once) the first failure of an asynchronous send.
+  Status SendStatus() {
+    mutex_lock l(send_mu_);
+    if (send_result_ == pulsar::ResultOk) {
+      return OkStatus();
+    }
+    Status status =
+        errors::Internal("sendAsync failed for index: ", send_index_,
+                         " error: ", pulsar::strResult(send_result_));
+    send_result_ = pulsar::ResultOk;
+    return status;
+  }
+
   pulsar::Producer producer_;
   unsigned long index_;
+  mutex send_mu_;
+  pulsar::Result send_result_ TF_GUARDED_BY(send_mu_) = pulsar::ResultOk;
+  unsigned long send_index_ TF_GUARDED_BY(send_mu_) = 0;
 };
 
 class PulsarWritableInitOp : public ResourceOpKernel<PulsarWritableResource> {
  public:
   explicit PulsarWritableInitOp(OpKernelConstruction* context)
-      : ResourceOpKernel<PulsarWritableResource>(context) {}
+      : ResourceOpKernel<PulsarWritableResource>(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("batching", &batching_));
+    OP_REQUIRES_OK(context, context->GetAttr("batching_max_messages",
+                                             &batching_max_messages_));
+    OP_REQUIRES_OK(context, context->GetAttr("batching_max_publish_delay",
+                                             &batching_max_publish_delay_));
+    OP_REQUIRES_OK(context, context->GetAttr("compression", &compression_));
+  }
 
  private:
   void Compute(OpKernelContext* context) override {
@@ -284,7 +436,10 @@ class PulsarWritableInitOp : public ResourceOpKernel<PulsarWritableResource> {
     OP_REQUIRES_OK(context, context->input("topic", &topic_tensor));
     const std::string topic = topic_tensor->flat<tstring>()(0);
 
-    OP_REQUIRES_OK(context, resource_->Init(service_url, topic));
+    OP_REQUIRES_OK(context,
+                   resource_->Init(service_url, topic, batching_,
+                                   batching_max_messages_,
+                                   batching_max_publish_delay_, compression_));
   }
 
   Status CreateResource(PulsarWritableResource** resource)
@@ -295,6 +450,10 @@ class PulsarWritableInitOp : public ResourceOpKernel<PulsarWritableResource> {
 
  private:
   mutable mutex mu_;
+  bool batching_;
+  int64 batching_max_messages_;
+  int64 batching_max_publish_delay_;
+  std::string compression_;
 };
 
 class PulsarWritableWriteOp : public OpKernel {
@@ -312,13 +471,11 @@ class PulsarWritableWriteOp : public OpKernel {
 
     const Tensor* value_tensor;
     OP_REQUIRES_OK(context, context->input("value", &value_tensor));
-    const std::string value = value_tensor->flat<tstring>()(0);
 
     const Tensor* key_tensor;
     OP_REQUIRES_OK(context, context->input("key", &key_tensor));
-    const std::string key = key_tensor->flat<tstring>()(0);
 
-    OP_REQUIRES_OK(context, resource->WriteAsync(value, key));
+    OP_REQUIRES_OK(context, resource->WriteAsync(*value_tensor, *key_tensor));
   }
 };
 
@@ -16,6 +16,10 @@ limitations under the License.
 #include <libpq-fe.h>
 #include <pg_config_types.h>
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
 
@@ -61,6 +65,57 @@ Status SqlDataCopy(int oid, char* data, Tensor* value) {
   return OkStatus();
 };
 
+uint32 SqlLoad32(const char* data) {
+  const uint8* p = reinterpret_cast<const uint8*>(data);
+  return (static_cast<uint32>(p[0]) << 24) | (static_cast<uint32>(p[1]) << 16) |
+         (static_cast<uint32>(p[2]) << 8) | static_cast<uint32>(p[3]);
+}
+
+uint64 SqlLoad64(const char* data) {
+  return (static_cast<uint64>(SqlLoad32(data)) << 32) | SqlLoad32(data + 4);
+}
+
+// Decodes a value in PostgreSQL binary format (network byte order) into
+// element `index` of `value`, without going through text.
+Status SqlBinaryCopy(int oid, const char* data, int length, int64 index,
+                     Tensor* value) {
+  if (length < 0) {
+    return errors::InvalidArgument("NULL value is not supported");
+  }
+  switch (oid) {
+    case INT4OID:
+      if (length == 4) {
+        value->flat<int32>()(index) = static_cast<int32>(SqlLoad32(data));
+        return OkStatus();
+      }
+      break;
+    case INT8OID:
+      if (length == 8) {
+        value->flat<int64>()(index) = static_cast<int64>(SqlLoad64(data));
+        return OkStatus();
+      }
+      break;
+    case FLOAT4OID:
+      if (length == 4) {
+        uint32 bits = SqlLoad32(data);
+        std::memcpy(&value->flat<float>()(index), &bits, sizeof(bits));
+        return OkStatus();
+      }
+      break;
+    case FLOAT8OID:
+      if (length == 8) {
+        uint64 bits = SqlLoad64(data);
+        std::memcpy(&value->flat<double>()(index), &bits, sizeof(bits));
+        return OkStatus();
+      }
+      break;
+    default:
+      return errors::InvalidArgument("sql data type ", oid, " not supported");
+  }
+  return errors::InvalidArgument("unexpected length ", length,
+                                 " for sql data type ", oid);
+}
+
 class SqlIterableResource : public ResourceBase {
  public:
   SqlIterableResource(Env* env)
@@ -78,8 +133,15 @@ class SqlIterableResource : public ResourceBase {
         }) {}
   ~SqlIterableResource() {}
 
-  Status Init(const string& query, const string& endpoint, int64* count,
-              std::vector<string>* fields, std::vector<DataType>* dtypes) {
+  // `mode` selects how rows are retrieved:
+  //   "": the whole result set is buffered by PQexec and read by index.
+  //   "cursor": rows are fetched `batch` at a time from a server-side cursor,
+  //     in binary format.
+  //   "copy": rows are streamed with COPY ... TO STDOUT (FORMAT binary).
+  // In the streaming modes `count` is -1 and rows are read with Next().
+  Status Init(const string& query, const string& endpoint, const string& mode,
+              const int64 batch, int64* count, std::vector<string>* fields,
+              std::vector<DataType>* dtypes) {
     mutex_lock l(mu_);
     conn_.reset(PQconnectdb(endpoint.c_str()));
     if (PQstatus(conn_.get()) != CONNECTION_OK) {
@@ -88,14 +150,22 @@ class SqlIterableResource : public ResourceBase {
     }
     LOG(INFO) << "Connection to database succeed.";
 
-    result_.reset(PQexec(conn_.get(), query.c_str()));
-    if (PQresultStatus(result_.get()) != PGRES_TUPLES_OK) {
-      return errors::InvalidArgument("Exec of query failed: ",
-                                     PQerrorMessage(conn_.get()));
+    mode_ = mode;
+    batch_ = batch;
+    if (mode_ == "cursor" || mode_ == "copy") {
+      TF_RETURN_IF_ERROR(Stream(query));
+    } else if (mode_ != "") {
+      return errors::InvalidArgument("unsupported mode: ", mode_);
+    } else {
+      result_.reset(PQexec(conn_.get(), query.c_str()));
+      if (PQresultStatus(result_.get()) != PGRES_TUPLES_OK) {
+        return errors::InvalidArgument("Exec of query failed: ",
+                                       PQerrorMessage(conn_.get()));
+      }
     }
     LOG(INFO) << "Exec of query succeed.";
 
-    count_ = PQntuples(result_.get());
+    count_ = (mode_ == "") ? PQntuples(result_.get()) : -1;
     fields_.clear();
     dtypes_.clear();
     int field_count = PQnfields(result_.get());
@@ -140,9 +210,224 @@ class SqlIterableResource : public ResourceBase {
     }
     return OkStatus();
   }
+  // Returns the next (up to) `batch` rows in the streaming modes; no rows
+  // once the result set is exhausted.
+  Status Next(const Tensor* field_tensor,
+              std::function<Status(const int64 field_index, const int64 rows,
+                                   Tensor** value)>
+                  allocate_func) {
+    mutex_lock l(mu_);
+    std::vector<int> columns;
+    for (int64 i = 0; i < field_tensor->NumElements(); i++) {
+      const string& field = field_tensor->flat<tstring>()(i);
+      auto it = std::find(fields_.begin(), fields_.end(), field);
+      if (it == fields_.end()) {
+        return errors::InvalidArgument("field ", field, " not found");
+      }
+      columns.push_back(it - fields_.begin());
+    }
+    if (mode_ == "cursor") {
+      return NextCursor(columns, allocate_func);
+    }
+    if (mode_ == "copy") {
+      return NextCopy(columns, allocate_func);
+    }
+    return errors::FailedPrecondition("Next requires cursor or copy mode");
+  }
   string DebugString() const override { return "SqlIterableResource"; }
 
  private:
+  // Describes `query` (to know fields and types before any row arrives) and
+  // starts streaming it. result_ holds the description afterwards.
+  Status Stream(const string& query) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    // The query is embedded in another statement.
+    string statement = query;
+    while (!statement.empty() &&
+           (statement.back() == ';' ||
+            isspace(static_cast<unsigned char>(statement.back()))))) {
+      statement.pop_back();
+    }
+
+    std::unique_ptr<PGresult, void (*)(PGresult*)> prepared(
+        PQprepare(conn_.get(), "", statement.c_str(), 0, nullptr), PQclear);
+    if (PQresultStatus(prepared.get()) != PGRES_COMMAND_OK) {
+      return errors::InvalidArgument("Prepare of query failed: ",
+                                     PQerrorMessage(conn_.get()));
+    }
+    result_.reset(PQdescribePrepared(conn_.get(), ""));
+    if (PQresultStatus(result_.get()) != PGRES_COMMAND_OK) {
+      return errors::InvalidArgument("Describe of query failed: ",
+                                     PQerrorMessage(conn_.get()));
+    }
+
+    std::vector<string> commands;
+    if (mode_ == "cursor") {
+      // A cursor only lives within a transaction.
+      commands.push_back("BEGIN");
+      commands.push_back("DECLARE tfio_cursor NO SCROLL CURSOR FOR " +
+                         statement);
+    } else {
+      commands.push_back("COPY (" + statement + ") TO STDOUT (FORMAT binary)");
+    }
+    for (const string& command : commands) {
+      std::unique_ptr<PGresult, void (*)(PGresult*)> result(
+          PQexec(conn_.get(), command.c_str()), PQclear);
+      ExecStatusType status = PQresultStatus(result.get());
+      if (status != PGRES_COMMAND_OK && status != PGRES_COPY_OUT) {
+        return errors::InvalidArgument("Exec of ", command, " failed: ",
+                                       PQerrorMessage(conn_.get()));
+      }
+    }
+    copy_header_ = false;
+    copy_done_ = false;
+    copy_buffer_.clear();
+    return OkStatus();
+  }
+
+  Status NextCursor(const std::vector<int>& columns,
+                    std::function<Status(const int64 field_index,
+                                         const int64 rows, Tensor** value)>
+                        allocate_func) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    // Request the rows in binary format so they are decoded without
+    // parsing text.
+    const string command =
+        strings::StrCat("FETCH ", batch_, " FROM tfio_cursor");
+    std::unique_ptr<PGresult, void (*)(PGresult*)> result(
+        PQexecParams(conn_.get(), command.c_str(), 0, nullptr, nullptr,
+                     nullptr, nullptr, 1),
+        PQclear);
+    if (PQresultStatus(result.get()) != PGRES_TUPLES_OK) {
+      return errors::InvalidArgument("Fetch failed: ",
+                                     PQerrorMessage(conn_.get()));
+    }
+    const int64 rows = PQntuples(result.get());
+    for (size_t i = 0; i < columns.size(); i++) {
+      Tensor* value;
+      TF_RETURN_IF_ERROR(allocate_func(i, rows, &value));
+      const int oid = PQftype(result.get(), columns[i]);
+      for (int64 row = 0; row < rows; row++) {
+        const int length = PQgetisnull(result.get(), row, columns[i])
+                               ? -1
+                               : PQgetlength(result.get(), row, columns[i]);
+        TF_RETURN_IF_ERROR(
+            SqlBinaryCopy(oid, PQgetvalue(result.get(), row, columns[i]),
+                          length, row, value));
+      }
+    }
+    return OkStatus();
+  }
+
+  Status NextCopy(const std::vector<int>& columns,
+                  std::function<Status(const int64 field_index,
+                                       const int64 rows, Tensor** value)>
+                      allocate_func) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    // Offsets of the fields of every complete tuple in copy_buffer_.
+    const size_t field_count = fields_.size();
+    std::vector<std::pair<size_t, int>> offsets;
+    size_t position = 0;
+    int64 rows = 0;
+    while (rows < batch_) {
+      TF_RETURN_IF_ERROR(ParseCopyTuple(&position, &offsets));
+      if (offsets.size() == (rows + 1) * field_count) {
+        rows++;
+        continue;
+      }
+      if (copy_done_) {
+        break;
+      }
+      // Need more data.
+      char* data = nullptr;
+      int length = PQgetCopyData(conn_.get(), &data, 0);
+      if (length == -1) {
+        std::unique_ptr<PGresult, void (*)(PGresult*)> result(
+            PQgetResult(conn_.get()), PQclear);
+        if (PQresultStatus(result.get()) != PGRES_COMMAND_OK) {
+          return errors::InvalidArgument("Copy failed: ",
+                                         PQerrorMessage(conn_.get()));
+        }
+        copy_done_ = true;
+        continue;
+      }
+      if (length < 0) {
+        return errors::InvalidArgument("Copy failed: ",
+                                       PQerrorMessage(conn_.get()));
+      }
+      copy_buffer_.append(data, length);
+      PQfreemem(data);
+    }
+
+    for (size_t i = 0; i < columns.size(); i++) {
+      Tensor* value;
+      TF_RETURN_IF_ERROR(allocate_func(i, rows, &value));
+      const int oid = PQftype(result_.get(), columns[i]);
+      for (int64 row = 0; row < rows; row++) {
+        const auto& field = offsets[row * field_count + columns[i]];
+        TF_RETURN_IF_ERROR(SqlBinaryCopy(oid, copy_buffer_.data() + field.first,
+                                         field.second, row, value));
+      }
+    }
+    copy_buffer_.erase(0, position);
+    return OkStatus();
+  }
+
+  // Parses one tuple of the binary COPY stream starting at `*position` of
+  // copy_buffer_, appending (offset, length) of each field to `offsets`.
+  // Nothing is consumed if the tuple is not complete yet.
+  Status ParseCopyTuple(size_t* position,
+                        std::vector<std::pair<size_t, int>>* offsets)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    static const char kSignature[] = "PGCOPY\n\377\r\n\0";
+    size_t p = *position;
+    if (!copy_header_) {
+      // Signature (11 bytes), flags (4 bytes) and header extension.
+      if (copy_buffer_.size() < 19) {
+        return OkStatus();
+      }
+      if (std::memcmp(copy_buffer_.data(), kSignature, 11) != 0) {
+        return errors::DataLoss("invalid binary copy signature");
+      }
+      const size_t extension = SqlLoad32(copy_buffer_.data() + 15);
+      if (copy_buffer_.size() < 19 + extension) {
+        return OkStatus();
+      }
+      p = 19 + extension;
+      *position = p;
+      copy_header_ = true;
+    }
+    if (copy_buffer_.size() < p + 2) {
+      return OkStatus();
+    }
+    const int16 count = static_cast<int16>(
+        (static_cast<uint8>(copy_buffer_[p]) << 8) |
+        static_cast<uint8>(copy_buffer_[p + 1]));
+    if (count == -1) {
+      // Trailer.
+      return OkStatus();
+    }
+    if (count != static_cast<int16>(fields_.size())) {
+      return errors::DataLoss("expected ", fields_.size(), " fields, got ",
+                              count);
+    }
+    p += 2;
+    std::vector<std::pair<size_t, int>> fields;
+    for (int16 i = 0; i < count; i++) {
+      if (copy_buffer_.size() < p + 4) {
+        return OkStatus();
+      }
+      const int length = static_cast<int32>(SqlLoad32(&copy_buffer_[p]));
+      p += 4;
+      const size_t size = (length < 0) ? 0 : length;
+      if (copy_buffer_.size() < p + size) {
+        return OkStatus();
+      }
+      fields.emplace_back(p, length);
+      p += size;
+    }
+    offsets->insert(offsets->end(), fields.begin(), fields.end());
+    *position = p;
+    return OkStatus();
+  }
+
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
   std::unique_ptr<PGconn, void (*)(PGconn*)> conn_ TF_GUARDED_BY(mu_);
@@ -150,6 +435,12 @@ class SqlIterableResource : public ResourceBase {
   int64 count_ TF_GUARDED_BY(mu_);
   std::vector<string> fields_ TF_GUARDED_BY(mu_);
   std::vector<DataType> dtypes_ TF_GUARDED_BY(mu_);
+  string mode_ TF_GUARDED_BY(mu_);
+  int64 batch_ TF_GUARDED_BY(mu_);
+  // Undecoded bytes of the binary COPY stream.
+  string copy_buffer_ TF_GUARDED_BY(mu_);
+  bool copy_header_ TF_GUARDED_BY(mu_) = false;
+  bool copy_done_ TF_GUARDED_BY(mu_) = false;
 };
 
 class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
@@ -157,6 +448,8 @@ class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
   explicit SqlIterableInitOp(OpKernelConstruction* context)
       : ResourceOpKernel<SqlIterableResource>(context) {
     env_ = context->env();
+    OP_REQUIRES_OK(context, context->GetAttr("mode", &mode_));
+    OP_REQUIRES_OK(context, context->GetAttr("batch", &batch_));
   }
 
  private:
@@ -174,8 +467,8 @@ class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
     int64 count;
     std::vector<string> fields;
     std::vector<DataType> dtypes;
-    OP_REQUIRES_OK(context,
-                   resource_->Init(input, endpoint, &count, &fields, &dtypes));
+    OP_REQUIRES_OK(context, resource_->Init(input, endpoint, mode_, batch_,
+                                            &count, &fields, &dtypes));
 
     Tensor* count_tensor;
     OP_REQUIRES_OK(context,
@@ -208,6 +501,8 @@ class SqlIterableInitOp : public ResourceOpKernel<SqlIterableResource> {
  private:
   mutable mutex mu_;
   Env* env_ TF_GUARDED_BY(mu_);
+  string mode_;
+  int64 batch_;
 };
 
 class SqlIterableReadOp : public OpKernel {
@@ -245,10 +540,44 @@ class SqlIterableReadOp : public OpKernel {
   Env* env_ TF_GUARDED_BY(mu_);
 };
 
+class SqlIterableNextOp : public OpKernel {
+ public:
+  explicit SqlIterableNextOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    env_ = context->env();
+  }
+
+  void Compute(OpKernelContext* context) override {
+    SqlIterableResource* resource;
+    OP_REQUIRES_OK(context,
+                   GetResourceFromContext(context, "input", &resource));
+    core::ScopedUnref unref(resource);
+
+    const Tensor* field_tensor;
+    OP_REQUIRES_OK(context, context->input("field", &field_tensor));
+
+    OP_REQUIRES_OK(
+        context,
+        resource->Next(field_tensor,
+                       [&](const int64 field_index, const int64 rows,
+                           Tensor** value) -> Status {
+                         TF_RETURN_IF_ERROR(context->allocate_output(
+                             field_index, TensorShape({rows}), value));
+                         return OkStatus();
+                       }));
+  }
+
+ private:
+  mutable mutex mu_;
+  Env* env_ TF_GUARDED_BY(mu_);
+};
+
 REGISTER_KERNEL_BUILDER(Name("IO>SqlIterableInit").Device(DEVICE_CPU),
                         SqlIterableInitOp);
 REGISTER_KERNEL_BUILDER(Name("IO>SqlIterableRead").Device(DEVICE_CPU),
                         SqlIterableReadOp);
+REGISTER_KERNEL_BUILDER(Name("IO>SqlIterableNext").Device(DEVICE_CPU),
+                        SqlIterableNextOp);
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -21,6 +21,16 @@ namespace tensorflow {
 namespace io {
 namespace {
 
+// Shape function shared by the IO>AudioDecode*Batch ops.
+Status AudioDecodeBatchShapeFn(shape_inference::InferenceContext* c) {
+  shape_inference::ShapeHandle input;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &input));
+  c->set_output(0, c->MakeShape({c->Dim(input, 0), c->UnknownDim(),
+                                 c->UnknownDim()}));
+  c->set_output(1, c->MakeShape({c->Dim(input, 0)}));
+  return OkStatus();
+}
+
 REGISTER_OP("IO>AudioReadableInit")
     .Input("input: string")
     .Output("resource: resource")
@@ -60,11 +70,53 @@ REGISTER_OP("IO>AudioResample")
     .Input("rate_out: int64")
     .Output("output: T")
     .Attr("T: type")
+    .Attr("quality: int = 4")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
       c->set_output(0, c->MakeShape({c->UnknownDim(), c->UnknownDim()}));
       return OkStatus();
     });
 
+REGISTER_OP("IO>AudioResampleBatch")
+    .Input("input: T")
+    .Input("rate_in: int64")
+    .Input("rate_out: int64")
+    .Output("output: T")
+    .Attr("T: {int16, float}")
+    .Attr("quality: int = 4")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle input;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 3, &input));
+      c->set_output(0, c->MakeShape({c->Dim(input, 0), c->UnknownDim(),
+                                     c->Dim(input, 2)}));
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>AudioResamplerInit")
+    .Input("rate_in: int64")
+    .Input("rate_out: int64")
+    .Input("channels: int64")
+    .Output("resource: resource")
+    .Attr("quality: int = 4")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      c->set_output(0, c->Scalar());
+      return OkStatus();
+    });
+
+REGISTER_OP("IO>AudioResamplerProcess")
+    .Input("resource: resource")
+    .Input("input: T")
+    .Input("flush: bool")
+    .Output("output: T")
+    .Attr("T: {int16, float}")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle input;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 2, &input));
+      c->set_output(0, c->MakeShape({c->UnknownDim(), c->Dim(input, 1)}));
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>AudioDecodeWAV")
     .Input("input: string")
     .Input("shape: int64")
@@ -144,6 +196,12 @@ REGISTER_OP("IO>AudioDecodeVorbis")
       return OkStatus();
     });
 
+REGISTER_OP("IO>AudioDecodeVorbisBatch")
+    .Input("input: string")
+    .Output("value: float32")
+    .Output("length: int64")
+    .SetShapeFn(AudioDecodeBatchShapeFn);
+
 REGISTER_OP("IO>AudioEncodeVorbis")
     .Input("input: float32")
     .Input("rate: int64")
@@ -200,6 +258,12 @@ REGISTER_OP("IO>AudioDecodeAAC")
       return OkStatus();
     });
 
+REGISTER_OP("IO>AudioDecodeAACBatch")
+    .Input("input: string")
+    .Output("value: float32")
+    .Output("length: int64")
+    .SetShapeFn(AudioDecodeBatchShapeFn);
+
 REGISTER_OP("IO>AudioEncodeAAC")
     .Input("input: float32")
     .Input("rate: int64")
@@ -47,6 +47,34 @@ REGISTER_OP("IO>ElasticsearchReadableNext")
       return OkStatus();
     });
 
+REGISTER_OP("IO>ElasticsearchSlicedInit")
+    .Input("url: string")
+    .Input("path: string")
+    .Input("query: string")
+    .Input("headers: string")
+    .Output("resource: resource")
+    .Attr("fields: list(string) >= 1")
+    .Attr("dtypes: list(type) >= 1")
+    .Attr("slices: int = 1")
+    .Attr("size: int = 1000")
+    .Attr("keep_alive: string = '1m'")
+    .Attr("capacity: int = 2")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetShapeFn(shape_inference::ScalarShape);
+
+REGISTER_OP("IO>ElasticsearchSlicedNext")
+    .SetIsStateful()
+    .Input("resource: resource")
+    .Output("value: dtypes")
+    .Attr("dtypes: list(type) >= 1")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      for (int64 i = 0; i < c->num_outputs(); ++i) {
+        c->set_output(i, c->MakeShape({c->UnknownDim()}));
+      }
+      return OkStatus();
+    });
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -114,4 +114,26 @@ REGISTER_OP("IO>FfmpegVideoReadableNext")
       return OkStatus();
     });
 
+REGISTER_OP("IO>FfmpegVideoReadableRead")
+    .Input("input: resource")
+    .Input("start: float64")
+    .Input("stop: float64")
+    .Input("stride: int64")
+    .Input("size: int64")
+    .Output("value: uint8")
+    .Attr("unit: {'frame', 'second'} = 'frame'")
+    .Attr("threads: int = 0")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle size;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromShapeTensor(4, &size));
+      shape_inference::DimensionHandle height = c->UnknownDim();
+      shape_inference::DimensionHandle width = c->UnknownDim();
+      if (c->RankKnown(size) && c->Rank(size) == 2) {
+        height = c->Dim(size, 0);
+        width = c->Dim(size, 1);
+      }
+      c->set_output(0, c->MakeShape({c->UnknownDim(), height, width, 3}));
+      return OkStatus();
+    });
+
 }  // namespace tensorflow
@@ -46,6 +46,30 @@ REGISTER_OP("IO>DecodeTiff")
       return OkStatus();
     });
 
+REGISTER_OP("IO>DecodeTiffRegion")
+    .Input("input: string")
+    .Input("index: int64")
+    .Input("offset: int64")
+    .Input("size: int64")
+    .Output("image: dtype")
+    .Attr(
+        "dtype: {uint8, uint16, uint32, int8, int16, int32, half, float, "
+        "double}")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(2), 1, &unused));
+      shape_inference::ShapeHandle size;
+      TF_RETURN_IF_ERROR(c->MakeShapeFromShapeTensor(3, &size));
+      TF_RETURN_IF_ERROR(c->WithRank(size, 2, &size));
+      shape_inference::ShapeHandle output;
+      TF_RETURN_IF_ERROR(
+          c->Concatenate(size, c->Vector(c->UnknownDim()), &output));
+      c->set_output(0, output);
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>EncodeBmp")
     .Input("input: uint8")
     .Output("output: string")
@@ -144,6 +168,8 @@ REGISTER_OP("IO>DecodeHdr")
 
 REGISTER_OP("IO>DecodeDICOMImage")
     .Input("contents: string")
+    .Input("frame_start: int64")
+    .Input("frame_count: int64")
     .Output("output: dtype")
     .Attr(
         "dtype: {uint8, uint16, uint32, uint64, float16, float, double} = "
@@ -158,6 +184,8 @@ REGISTER_OP("IO>DecodeDICOMImage")
     })
     .Doc(R"doc(
 loads a dicom image file and returns its pixel information in the specified output format
+frame_start: index of the first frame to decode.
+frame_count: number of frames to decode, -1 decodes all frames from frame_start.
 )doc");
 
 REGISTER_OP("IO>DecodeDICOMData")
@@ -221,6 +249,132 @@ REGISTER_OP("IO>DecodeJPEG2K")
       return OkStatus();
     });
 
+// Shape function shared by the IO>Decode*Batch ops, `channels` is the
+// channel dimension of the decoded images.
+Status DecodeImageBatchShapeFn(shape_inference::InferenceContext* c,
+                               shape_inference::DimensionHandle channels) {
+  shape_inference::ShapeHandle contents;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &contents));
+  std::vector<int64> size;
+  TF_RETURN_IF_ERROR(c->GetAttr("size", &size));
+  if (size.size() == 2) {
+    c->set_output(0, c->MakeShape({c->Dim(contents, 0), size[0], size[1],
+                                   channels}));
+  } else {
+    c->set_output(0, c->MakeShape({c->Dim(contents, 0), c->UnknownDim(),
+                                   c->UnknownDim(), channels}));
+  }
+  return OkStatus();
+}
+
+REGISTER_OP("IO>DecodeWebPBatch")
+    .Input("contents: string")
+    .Output("image: uint8")
+    .Attr("size: list(int) = []")
+    .Attr("preserve_aspect_ratio: bool = false")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      return DecodeImageBatchShapeFn(c, c->MakeDim(4));
+    });
+
+REGISTER_OP("IO>DecodeAVIFBatch")
+    .Input("contents: string")
+    .Output("image: uint8")
+    .Attr("size: list(int) = []")
+    .Attr("preserve_aspect_ratio: bool = false")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      return DecodeImageBatchShapeFn(c, c->MakeDim(3));
+    });
+
+REGISTER_OP("IO>DecodeHdrBatch")
+    .Input("contents: string")
+    .Output("image: float")
+    .Attr("size: list(int) = []")
+    .Attr("preserve_aspect_ratio: bool = false")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      return DecodeImageBatchShapeFn(c, c->MakeDim(3));
+    });
+
+REGISTER_OP("IO>DecodePnmBatch")
+    .Input("contents: string")
+    .Output("image: dtype")
+    .Attr("dtype: {uint8, uint16} = DT_UINT8")
+    .Attr("size: list(int) = []")
+    .Attr("preserve_aspect_ratio: bool = false")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      return DecodeImageBatchShapeFn(c, c->UnknownDim());
+    });
+
+REGISTER_OP("IO>DecodeJPEG2KBatch")
+    .Input("contents: string")
+    .Output("image: dtype")
+    .Attr("dtype: {uint8, uint16}")
+    .Attr("size: list(int) = []")
+    .Attr("preserve_aspect_ratio: bool = false")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      return DecodeImageBatchShapeFn(c, c->UnknownDim());
+    });
+
+// Shape function shared by the IO>Decode*Batch ops of raw YUV frames.
+Status DecodeYUVBatchShapeFn(shape_inference::InferenceContext* c) {
+  shape_inference::ShapeHandle input;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &input));
+  shape_inference::ShapeHandle unused;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 1, &unused));
+  std::vector<int64> crop, resize;
+  TF_RETURN_IF_ERROR(c->GetAttr("crop", &crop));
+  TF_RETURN_IF_ERROR(c->GetAttr("resize", &resize));
+  string data_format;
+  TF_RETURN_IF_ERROR(c->GetAttr("data_format", &data_format));
+  shape_inference::DimensionHandle height = c->UnknownDim();
+  shape_inference::DimensionHandle width = c->UnknownDim();
+  if (resize.size() == 2) {
+    height = c->MakeDim(resize[0]);
+    width = c->MakeDim(resize[1]);
+  } else if (crop.size() == 4) {
+    height = c->MakeDim(crop[2]);
+    width = c->MakeDim(crop[3]);
+  }
+  if (data_format == "NCHW") {
+    c->set_output(0, c->MakeShape({c->Dim(input, 0), 3, height, width}));
+  } else {
+    c->set_output(0, c->MakeShape({c->Dim(input, 0), height, width, 3}));
+  }
+  return OkStatus();
+}
+
+REGISTER_OP("IO>DecodeNV12Batch")
+    .Input("input: string")
+    .Input("size: int32")
+    .Output("image: dtype")
+    .Attr("crop: list(int) = []")
+    .Attr("resize: list(int) = []")
+    .Attr("channel_order: {'RGB', 'BGR'} = 'RGB'")
+    .Attr("data_format: {'NHWC', 'NCHW'} = 'NHWC'")
+    .Attr("dtype: {uint8, float} = DT_UINT8")
+    .SetShapeFn(DecodeYUVBatchShapeFn);
+
+REGISTER_OP("IO>DecodeYUY2Batch")
+    .Input("input: string")
+    .Input("size: int32")
+    .Output("image: dtype")
+    .Attr("crop: list(int) = []")
+    .Attr("resize: list(int) = []")
+    .Attr("channel_order: {'RGB', 'BGR'} = 'RGB'")
+    .Attr("data_format: {'NHWC', 'NCHW'} = 'NHWC'")
+    .Attr("dtype: {uint8, float} = DT_UINT8")
+    .SetShapeFn(DecodeYUVBatchShapeFn);
+
+REGISTER_OP("IO>DecodeI420Batch")
+    .Input("input: string")
+    .Input("size: int32")
+    .Output("image: dtype")
+    .Attr("crop: list(int) = []")
+    .Attr("resize: list(int) = []")
+    .Attr("channel_order: {'RGB', 'BGR'} = 'RGB'")
+    .Attr("data_format: {'NHWC', 'NCHW'} = 'NHWC'")
+    .Attr("dtype: {uint8, float} = DT_UINT8")
+    .SetShapeFn(DecodeYUVBatchShapeFn);
+
 REGISTER_OP("IO>EncodeGif")
     .Input("input: uint8")
     .Output("output: string")
@@ -57,6 +57,24 @@ REGISTER_OP("IO>KafkaReadableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>KafkaReadableReadRecords")
+    .Input("input: resource")
+    .Input("start: int64")
+    .Input("stop: int64")
+    .Output("message: string")
+    .Output("key: string")
+    .Output("timestamp: int64")
+    .Output("offset: int64")
+    .Output("header_key: string")
+    .Output("header_value: string")
+    .Output("header_splits: int64")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      for (int i = 0; i < c->num_outputs(); i++) {
+        c->set_output(i, c->MakeShape({c->UnknownDim()}));
+      }
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>KafkaReadableSpec")
     .Input("input: resource")
     .Input("start: int64")
@@ -103,6 +121,43 @@ REGISTER_OP("IO>LayerKafkaSync")
     .Input("resource: resource")
     .SetShapeFn(shape_inference::ScalarShape);
 
+REGISTER_OP("IO>KafkaWritableInit")
+    .Input("topic: string")
+    .Input("partition: int32")
+    .Input("metadata: string")
+    .Output("resource: resource")
+    .Attr("container: string = ''")
+    .Attr("shared_name: string = ''")
+    .SetShapeFn(shape_inference::ScalarShape);
+
+REGISTER_OP("IO>KafkaWritableWrite")
+    .Input("input: resource")
+    .Input("message: string")
+    .Input("key: string")
+    .Output("batch: int64")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+
+REGISTER_OP("IO>KafkaWritableFlush")
+    .Input("input: resource")
+    .Input("timeout: int64")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::NoOutputs);
+
+REGISTER_OP("IO>KafkaWritableResults")
+    .Input("input: resource")
+    .Output("batch: int64")
+    .Output("delivered: int64")
+    .Output("failed: int64")
+    .Output("error: string")
+    .SetIsStateful()
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      for (int i = 0; i < c->num_outputs(); i++) {
+        c->set_output(i, c->MakeShape({c->UnknownDim()}));
+      }
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>KafkaGroupReadableInit")
     .Input("topics: string")
     .Input("metadata: string")
@@ -129,6 +184,19 @@ REGISTER_OP("IO>KafkaGroupReadableNext")
       return OkStatus();
     });
 
+REGISTER_OP("IO>KafkaPartitionedDataset")
+    .Input("topic: string")
+    .Input("partitions: int32")
+    .Input("offsets: int64")
+    .Input("batch_size: int64")
+    .Input("capacity: int64")
+    .Input("eof: bool")
+    .Input("timeout: int64")
+    .Input("metadata: string")
+    .Output("handle: variant")
+    .SetIsStateful()
+    .SetShapeFn(shape_inference::ScalarShape);
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
@@ -26,6 +26,8 @@ REGISTER_OP("IO>MongoDBReadableInit")
     .Input("database: string")
     .Input("collection: string")
     .Output("resource: resource")
+    .Attr("fields: list(string) = []")
+    .Attr("batch_size: int = 0")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''");
 
@@ -37,6 +39,18 @@ REGISTER_OP("IO>MongoDBReadableNext")
       return OkStatus();
     });
 
+REGISTER_OP("IO>MongoDBReadableRead")
+    .SetIsStateful()
+    .Input("resource: resource")
+    .Output("value: dtypes")
+    .Attr("dtypes: list(type) >= 1")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      for (int64 i = 0; i < c->num_outputs(); ++i) {
+        c->set_output(i, c->MakeShape({c->UnknownDim()}));
+      }
+      return OkStatus();
+    });
+
 REGISTER_OP("IO>MongoDBWritableInit")
     .Input("uri: string")
     .Input("database: string")
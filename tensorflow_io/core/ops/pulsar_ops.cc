@@ -27,6 +27,8 @@ REGISTER_OP("IO>PulsarReadableInit")
     .Input("subscription: string")
     .Input("ack_grouping_time: int64")
     .Output("resource: resource")
+    .Attr("batch_receive: bool = false")
+    .Attr("batch_receive_timeout: int = 100")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
@@ -52,6 +54,10 @@ REGISTER_OP("IO>PulsarWritableInit")
     .Input("service_url: string")
     .Input("topic: string")
     .Output("resource: resource")
+    .Attr("batching: bool = false")
+    .Attr("batching_max_messages: int = 1000")
+    .Attr("batching_max_publish_delay: int = 10")
+    .Attr("compression: string = ''")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
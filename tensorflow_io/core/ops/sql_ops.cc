@@ -29,6 +29,8 @@ REGISTER_OP("IO>SqlIterableInit")
     .Output("count: int64")
     .Output("field: string")
     .Output("dtype: int64")
+    .Attr("mode: string = ''")
+    .Attr("batch: int = 1024")
     .Attr("container: string = ''")
     .Attr("shared_name: string = ''")
     .SetShapeFn([](shape_inference::InferenceContext* c) {
@@ -53,6 +55,19 @@ REGISTER_OP("IO>SqlIterableRead")
       return OkStatus();
     });
 
+REGISTER_OP("IO>SqlIterableNext")
+    .SetIsStateful()
+    .Input("input: resource")
+    .Input("field: string")
+    .Output("value: dtypes")
+    .Attr("dtypes: list(type)")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      for (int64 i = 0; i < c->num_outputs(); ++i) {
+        c->set_output(i, c->MakeShape({c->UnknownDim()}));
+      }
+      return OkStatus();
+    });
+
 }  // namespace
 }  // namespace io
 }  // namespace tensorflow
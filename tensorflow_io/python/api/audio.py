@@ -26,15 +26,18 @@ from tensorflow_io.python.ops.audio_ops import (  # pylint: disable=unused-impor
     time_mask,
     fade,
     resample,
+    AudioResampler,
     decode_wav,
     encode_wav,
     decode_flac,
     encode_flac,
     decode_vorbis,
+    decode_vorbis_batch,
     encode_vorbis,
     decode_mp3,
     encode_mp3,
     decode_aac,
+    decode_aac_batch,
     encode_aac,
     AudioIOTensor,
     AudioIODataset,
@@ -16,4 +16,5 @@
 
 from tensorflow_io.python.experimental.ffmpeg_ops import (  # pylint: disable=unused-import
     decode_video,
+    read_video,
 )
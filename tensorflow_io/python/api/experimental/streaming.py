@@ -20,6 +20,12 @@ from tensorflow_io.python.experimental.kafka_group_io_dataset_ops import (  # py
 from tensorflow_io.python.experimental.kafka_batch_io_dataset_ops import (  # pylint: disable=unused-import
     KafkaBatchIODataset,
 )
+from tensorflow_io.python.experimental.kafka_partitioned_io_dataset_ops import (  # pylint: disable=unused-import
+    KafkaPartitionedIODataset,
+)
+from tensorflow_io.python.experimental.kafka_writer_ops import (  # pylint: disable=unused-import
+    KafkaWriter,
+)
 from tensorflow_io.python.experimental.pulsar_dataset_ops import (  # pylint: disable=unused-import
     PulsarIODataset,
 )
@@ -14,6 +14,7 @@
 # ==============================================================================
 """ElasticsearchIODatasets"""
 
+import json
 from urllib.parse import urlparse
 import tensorflow as tf
 from tensorflow_io.python.ops import core_ops
@@ -150,6 +151,32 @@ class _ElasticsearchHandler:
         )
         return values
 
+    def get_sliced_resource(self, request_url, query, spec, slices, size):
+        """Prepares the resource reading the index with a sliced scroll.
+
+        Args:
+            request_url: The request url of the healthy node.
+            query: A JSON string with the search body.
+            spec: A dict of field names to `tf.DType`.
+            slices: The number of slices read in parallel.
+            size: The number of hits per page and slice.
+        Returns:
+            The sliced resource.
+        """
+
+        url_obj = urlparse(request_url)
+        path = self.index if self.doc_type is None else f"{self.index}/{self.doc_type}"
+        return core_ops.io_elasticsearch_sliced_init(
+            url=f"{url_obj.scheme}://{url_obj.netloc}",
+            path=path,
+            query=query,
+            headers=self.headers,
+            fields=list(spec.keys()),
+            dtypes=list(spec.values()),
+            slices=slices,
+            size=size,
+        )
+
     def parse_json(self, raw_item, columns, dtypes):
         """Prepares the next batch of data based on the request url and
         the counter index.
@@ -223,9 +250,33 @@ class ElasticsearchIODataset(tf.compat.v2.data.Dataset):
                     index="people",
                     doc_type="survivors",
                     headers=HEADERS)
+
+    Large indices can be exported faster by reading a sliced scroll, where
+    each slice is fetched by its own worker over a kept-alive connection.
+    Only the fields in `spec` are requested (`_source` filtering) and they
+    are decoded directly into tensors:
+
+    >>> dataset = tfio.experimental.elasticsearch.ElasticsearchIODataset(
+                    nodes=["localhost:9092"],
+                    index="people",
+                    headers=HEADERS,
+                    spec={"age": tf.int64, "fare": tf.double},
+                    query={"query": {"range": {"age": {"gte": 18}}}},
+                    slices=4)
     """
 
-    def __init__(self, nodes, index, doc_type=None, headers=None, internal=True):
+    def __init__(
+        self,
+        nodes,
+        index,
+        doc_type=None,
+        headers=None,
+        spec=None,
+        query=None,
+        slices=None,
+        size=1000,
+        internal=True,
+    ):
         """Prepare the ElasticsearchIODataset.
 
         Args:
@@ -237,6 +288,17 @@ class ElasticsearchIODataset(tf.compat.v2.data.Dataset):
                 in the index to query.
             headers: (Optional) A dict of headers. For example:
                 {'Content-Type': 'application/json'}
+            spec: (Optional) A dict mapping `_source` fields (dotted paths for
+                nested fields) to `tf.DType` or `tf.TensorSpec`. Defaults to
+                the fields and types of the first document.
+            query: (Optional) A dict or JSON string with the search body, e.g.
+                `{"query": {"term": {"gender": "Male"}}}`.
+            slices: (Optional) The number of scroll slices read in parallel.
+                When any of `spec`, `query` or `slices` is given, the index
+                is read with the sliced reader, which decodes the fields
+                natively instead of through serialized JSON records.
+            size: (Optional) The number of hits fetched per page and slice
+                by the sliced reader.
         """
         with tf.name_scope("ElasticsearchIODataset"):
             assert internal
@@ -246,20 +308,66 @@ class ElasticsearchIODataset(tf.compat.v2.data.Dataset):
             )
             resource, columns, dtypes, request_url = handler.get_healthy_resource()
 
-            dataset = tf.data.experimental.Counter()
-            dataset = dataset.map(
-                lambda i: handler.get_next_batch(
-                    resource=resource, request_url=request_url
+            if spec is None and query is None and slices is None:
+                dataset = tf.data.experimental.Counter()
+                dataset = dataset.map(
+                    lambda i: handler.get_next_batch(
+                        resource=resource, request_url=request_url
+                    )
+                )
+                dataset = dataset.apply(
+                    tf.data.experimental.take_while(
+                        lambda v: tf.greater(tf.shape(v)[0], 0)
+                    )
+                )
+                dataset = dataset.flat_map(
+                    lambda x: tf.data.Dataset.from_tensor_slices(x)
+                )
+                dataset = dataset.map(
+                    lambda v: handler.parse_json(v, columns=columns, dtypes=dtypes),
+                    num_parallel_calls=tf.data.experimental.AUTOTUNE,
+                )
+            else:
+                if spec is None:
+                    spec = {
+                        column.decode("utf-8"): dtype
+                        for column, dtype in zip(columns, dtypes)
+                    }
+                spec = {
+                    k: (v.dtype if isinstance(v, tf.TensorSpec) else tf.as_dtype(v))
+                    for k, v in spec.items()
+                }
+                if query is None:
+                    query = ""
+                elif not isinstance(query, str):
+                    query = json.dumps(query)
+                fields = list(spec.keys())
+                sliced = handler.get_sliced_resource(
+                    request_url=request_url,
+                    query=query,
+                    spec=spec,
+                    slices=slices or 1,
+                    size=size,
+                )
+                dataset = tf.data.experimental.Counter()
+                dataset = dataset.map(
+                    lambda i: dict(
+                        zip(
+                            fields,
+                            core_ops.io_elasticsearch_sliced_next(
+                                sliced, dtypes=list(spec.values())
+                            ),
+                        )
+                    )
+                )
+                dataset = dataset.apply(
+                    tf.data.experimental.take_while(
+                        lambda v: tf.greater(tf.shape(v[fields[0]])[0], 0)
+                    )
+                )
+                dataset = dataset.flat_map(
+                    lambda x: tf.data.Dataset.from_tensor_slices(x)
                 )
-            )
-            dataset = dataset.apply(
-                tf.data.experimental.take_while(lambda v: tf.greater(tf.shape(v)[0], 0))
-            )
-            dataset = dataset.flat_map(lambda x: tf.data.Dataset.from_tensor_slices(x))
-            dataset = dataset.map(
-                lambda v: handler.parse_json(v, columns=columns, dtypes=dtypes),
-                num_parallel_calls=tf.data.experimental.AUTOTUNE,
-            )
             self._dataset = dataset
 
             super().__init__(
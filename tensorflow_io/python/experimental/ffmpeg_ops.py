@@ -14,6 +14,8 @@
 # ==============================================================================
 """FFmpeg"""
 
+import tensorflow as tf
+
 
 def decode_video(content, index=0, name=None):
     """Decode video stream from a video file.
@@ -30,3 +32,50 @@ def decode_video(content, index=0, name=None):
     )
 
     return ffmpeg_ops.io_ffmpeg_decode_video(content, index, name=name)
+
+
+def read_video(
+    filename,
+    start=0,
+    stop=-1,
+    stride=1,
+    size=None,
+    unit="frame",
+    index=0,
+    threads=0,
+    name=None,
+):
+    """Read a range of frames of a video stream from a video file.
+
+    Decoding starts from the keyframe before `start`, so only the part of
+    the file overlapping the range is read and decoded.
+
+    Args:
+      filename: A `Tensor` of type `string`, the path of the video file.
+      start: The first frame, or the start time in seconds.
+      stop: The frame (or time) the range ends before, -1 reads to the end.
+      stride: Keep every `stride`-th frame of the range.
+      size: An optional `[height, width]` to scale frames to.
+      unit: Either "frame" or "second", the unit of `start` and `stop`.
+      index: The stream index.
+      threads: The number of decoding threads, 0 uses one per core.
+      name: A name for the operation (optional).
+
+    Returns:
+      value: A `uint8` Tensor of shape `[frames, height, width, 3]`.
+    """
+    from tensorflow_io.python.ops import (  # pylint: disable=import-outside-toplevel
+        ffmpeg_ops,
+    )
+
+    with tf.name_scope(name or "ReadVideo"):
+        resource = ffmpeg_ops.io_ffmpeg_video_readable_init(filename, index)
+        return ffmpeg_ops.io_ffmpeg_video_readable_read(
+            resource,
+            start=tf.cast(start, tf.float64),
+            stop=tf.cast(stop, tf.float64),
+            stride=tf.cast(stride, tf.int64),
+            size=tf.constant([], tf.int64) if size is None else size,
+            unit=unit,
+            threads=threads,
+        )
@@ -87,6 +87,38 @@ def decode_tiff(contents, index=0, name=None):
     return core_ops.io_decode_tiff(contents, index, name=name)
 
 
+def decode_tiff_region(contents, offset, size, index=0, dtype=tf.uint8, name=None):
+    """
+    Decode a region of a TIFF-encoded image in its native dtype.
+
+    Only the tiles or strips that intersect the region are decoded, in
+    parallel. For pyramidal TIFFs each level is a separate directory.
+
+    Args:
+      contents: A `Tensor` of type `string`. 0-D.  The TIFF-encoded image.
+      offset: A 1-D `Tensor` of type int64, the `[y, x]` of the top-left
+        corner of the region.
+      size: A 1-D `Tensor` of type int64, the `[height, width]` of the
+        region. A negative value extends the region to the image edge.
+      index: A `Tensor` of type int64. 0-D. The 0-based index of the
+        directory (or pyramid level) inside TIFF-encoded image.
+      dtype: Data type of the samples, which has to match the file, see
+        `decode_tiff_info`. Default `tf.uint8`.
+      name: A name for the operation (optional).
+
+    Returns:
+      A `Tensor` of type `dtype` and shape of `[height, width, channels]`.
+    """
+    return core_ops.io_decode_tiff_region(
+        contents,
+        tf.cast(index, tf.int64),
+        tf.cast(offset, tf.int64),
+        tf.cast(size, tf.int64),
+        dtype=dtype,
+        name=name,
+    )
+
+
 def decode_exr_info(contents, name=None):
     """
     Decode a EXR-encoded image meta data.
@@ -223,3 +255,121 @@ def decode_obj(contents, name=None):
       A `Tensor` of type `float32` and shape of `[n, 3]` for vertices.
     """
     return core_ops.io_decode_obj(contents, name=name)
+
+
+def decode_batch(
+    contents, format, dtype=None, size=None, preserve_aspect_ratio=False, name=None
+):
+    """
+    Decode a batch of encoded images in parallel.
+
+    The images are decoded on the CPU worker threads straight into one
+    `[batch, height, width, channels]` tensor.
+
+    Args:
+      contents: A `Tensor` of type `string`. 1-D. The encoded images.
+      format: The image format, one of `"webp"`, `"avif"`, `"hdr"`, `"pnm"`
+        or `"jp2"`.
+      dtype: Data type of the decoded images for `"pnm"` and `"jp2"`.
+        Default `tf.uint8`.
+      size: An optional `[height, width]`. When set every image is resized
+        to it, otherwise all images must have the same shape.
+      preserve_aspect_ratio: Whether to keep the aspect ratio when resizing,
+        the image is centered and zero padded to `size`.
+      name: A name for the operation (optional).
+
+    Returns:
+      A `Tensor` of shape `[batch, height, width, channels]`.
+    """
+    size = [] if size is None else list(size)
+    if format == "webp":
+        return core_ops.io_decode_web_p_batch(
+            contents,
+            size=size,
+            preserve_aspect_ratio=preserve_aspect_ratio,
+            name=name,
+        )
+    if format == "avif":
+        return core_ops.io_decode_avif_batch(
+            contents,
+            size=size,
+            preserve_aspect_ratio=preserve_aspect_ratio,
+            name=name,
+        )
+    if format == "hdr":
+        return core_ops.io_decode_hdr_batch(
+            contents,
+            size=size,
+            preserve_aspect_ratio=preserve_aspect_ratio,
+            name=name,
+        )
+    dtype = tf.uint8 if dtype is None else dtype
+    if format == "pnm":
+        return core_ops.io_decode_pnm_batch(
+            contents,
+            dtype=dtype,
+            size=size,
+            preserve_aspect_ratio=preserve_aspect_ratio,
+            name=name,
+        )
+    if format == "jp2":
+        return core_ops.io_decode_jpeg2k_batch(
+            contents,
+            dtype=dtype,
+            size=size,
+            preserve_aspect_ratio=preserve_aspect_ratio,
+            name=name,
+        )
+    raise ValueError("unsupported format: {}".format(format))
+
+
+def decode_yuv_batch(
+    contents,
+    format,
+    size,
+    crop=None,
+    resize=None,
+    channel_order="RGB",
+    data_format="NHWC",
+    dtype=tf.uint8,
+    name=None,
+):
+    """
+    Convert a batch of raw YUV frames to RGB in parallel.
+
+    Crop, resize, color conversion and output layout are fused into one
+    pass per frame, and the frames are converted on the CPU worker threads.
+
+    Args:
+      contents: A `Tensor` of type `string`. 1-D. The raw frames.
+      format: The frame format, one of `"nv12"`, `"yuy2"` or `"i420"`.
+      size: A 1-D int32 Tensor of 2 elements: height, width. The size
+        of the frames, must be even.
+      crop: An optional `[offset_height, offset_width, target_height,
+        target_width]` region to convert, the offsets must be even.
+      resize: An optional `[height, width]` the (cropped) frames are scaled
+        to with bilinear filtering.
+      channel_order: `"RGB"` or `"BGR"`.
+      data_format: `"NHWC"` or `"NCHW"`.
+      dtype: `tf.uint8`, or `tf.float32` normalized to `[0, 1]`.
+      name: A name for the operation (optional).
+
+    Returns:
+      A `Tensor` of shape `[batch, height, width, 3]` (`"NHWC"`) or
+      `[batch, 3, height, width]` (`"NCHW"`).
+    """
+    kwargs = dict(
+        crop=[] if crop is None else list(crop),
+        resize=[] if resize is None else list(resize),
+        channel_order=channel_order,
+        data_format=data_format,
+        dtype=dtype,
+        name=name,
+    )
+    if format == "nv12":
+        return core_ops.io_decode_nv12_batch(contents, size, **kwargs)
+    if format == "yuy2":
+        return core_ops.io_decode_yuy2_batch(contents, size, **kwargs)
+    if format == "i420":
+        return core_ops.io_decode_i420_batch(contents, size, **kwargs)
+    raise ValueError("unsupported format: {}".format(format))
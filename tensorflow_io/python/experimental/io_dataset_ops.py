@@ -105,14 +105,17 @@ class IODataset(io_dataset.IODataset):
 
         Args:
           stream: A string, the stream name.
-          shard: A string, the shard of kinesis.
+          shard: A string, the shard of kinesis. All shards are read if empty.
+          limit: The maximum number of records per GetRecords call (optional).
           name: A name prefix for the IODataset (optional).
 
         Returns:
           A `IODataset`.
         """
         with tf.name_scope(kwargs.get("name", "IOFromKinesis")):
-            return kinesis_dataset_ops.KinesisIODataset(stream, shard, internal=True)
+            return kinesis_dataset_ops.KinesisIODataset(
+                stream, shard, limit=kwargs.get("limit", 1000), internal=True
+            )
 
     @classmethod
     def from_numpy(cls, a, **kwargs):
@@ -193,7 +196,9 @@ class IODataset(io_dataset.IODataset):
             )
 
     @classmethod
-    def from_prometheus(cls, query, length, offset=None, endpoint=None, spec=None):
+    def from_prometheus(
+        cls, query, length, offset=None, endpoint=None, spec=None, **kwargs
+    ):
         """Creates an `GraphIODataset` from a prometheus endpoint.
 
         Args:
@@ -207,6 +212,11 @@ class IODataset(io_dataset.IODataset):
             The format should be {"job": {"instance": {"name": tf.TensorSpec}}}.
             In graph mode, spec is needed. In eager mode,
             spec is probed automatically.
+          window: The number of one second samples fetched by each range
+            query, 1000 by default (optional). Long ranges are split into
+            sub-windows of this size to stay below the server's sample limit.
+          concurrency: The number of sub-windows fetched in parallel, 4 by
+            default (optional).
           name: A name prefix for the IODataset (optional).
 
         Returns:
@@ -217,11 +227,17 @@ class IODataset(io_dataset.IODataset):
         )
 
         return prometheus_dataset_ops.PrometheusIODataset(
-            query, length, offset=offset, endpoint=endpoint, spec=spec
+            query,
+            length,
+            offset=offset,
+            endpoint=endpoint,
+            spec=spec,
+            window=kwargs.get("window", None),
+            concurrency=kwargs.get("concurrency", None),
         )
 
     @classmethod
-    def from_sql(cls, query, endpoint=None, spec=None):
+    def from_sql(cls, query, endpoint=None, spec=None, **kwargs):
         """Creates an `GraphIODataset` from a postgresql server endpoint.
 
         Args:
@@ -230,12 +246,25 @@ class IODataset(io_dataset.IODataset):
           spec: A structured (tuple) tf.TensorSpec of the dataset.
             In graph mode, spec is needed. In eager mode,
             spec is probed automatically.
+          mode: How rows are retrieved (optional). By default the whole result
+            set is loaded into client memory first. "cursor" fetches `batch`
+            rows at a time from a server-side cursor, and "copy" streams rows
+            with a binary `COPY ... TO STDOUT`; both decode binary values
+            directly into tensors.
+          batch: The number of rows per fetch in "cursor" and "copy" mode
+            (optional, 1024 by default).
           name: A name prefix for the IODataset (optional).
 
         Returns:
           A `IODataset`.
         """
-        return sql_dataset_ops.SQLIODataset(query, endpoint=endpoint, spec=spec)
+        return sql_dataset_ops.SQLIODataset(
+            query,
+            endpoint=endpoint,
+            spec=spec,
+            mode=kwargs.get("mode", None),
+            batch=kwargs.get("batch", 1024),
+        )
 
     @classmethod
     def from_video(cls, filename):
@@ -313,6 +342,10 @@ class StreamIODataset(tf.data.Dataset):
           subscription: A string, the subscription of the pubsub messages.
           endpoint: A string, the address of pubsub endpoint.
           timeout: An integer, the timeout of the pubsub pull.
+          max_messages: The maximum number of messages returned by each
+            pull (optional).
+          ack_deadline: The ack deadline in seconds, extended for messages
+            that are pulled but not yet acknowledged (optional).
           name: A name prefix for the IODataset (optional).
 
         Returns:
@@ -320,7 +353,12 @@ class StreamIODataset(tf.data.Dataset):
         """
         with tf.name_scope(kwargs.get("name", "IOFromPubSub")):
             return pubsub_dataset_ops.PubSubStreamIODataset(
-                subscription, endpoint=endpoint, timeout=timeout, internal=True
+                subscription,
+                endpoint=endpoint,
+                timeout=timeout,
+                max_messages=kwargs.get("max_messages", 1000),
+                ack_deadline=kwargs.get("ack_deadline", 10),
+                internal=True,
             )
 
     @classmethod
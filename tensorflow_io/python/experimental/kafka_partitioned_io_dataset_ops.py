@@ -0,0 +1,103 @@
+# Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""KafkaPartitionedIODataset"""
+
+import tensorflow as tf
+from tensorflow.python.data.ops import dataset_ops
+from tensorflow_io.python.ops import core_ops
+
+
+class KafkaPartitionedIODataset(dataset_ops.DatasetSource):
+    """Reads all (or a subset of the) partitions of a kafka topic in parallel.
+
+    Every partition is fetched by its own worker thread into a bounded
+    prefetch buffer, and the buffers are merged into batches of
+    `(message, key, partition, offset)`. The next offset of each partition
+    is part of the iterator state, so checkpointing the iterator with
+    `tf.train.Checkpoint` resumes every partition where it left off:
+
+    >>> import tensorflow_io as tfio
+    >>> dataset = tfio.experimental.streaming.KafkaPartitionedIODataset(
+    ...     "topic1", servers="localhost:9092", batch_size=1024)
+    >>> iterator = iter(dataset)
+    >>> checkpoint = tf.train.Checkpoint(iterator=iterator)
+    >>> for message, key, partition, offset in iterator:
+    ...     pass
+
+    Offsets are not committed to the broker, use `checkpoint.save(...)` and
+    `checkpoint.restore(...)` instead.
+    """
+
+    def __init__(
+        self,
+        topic,
+        partitions=None,
+        offsets=None,
+        servers=None,
+        configuration=None,
+        batch_size=1024,
+        capacity=4096,
+        eof=True,
+        timeout=-1,
+    ):
+        """Creates a `KafkaPartitionedIODataset`.
+
+        Args:
+          topic: A `tf.string` tensor containing the topic.
+          partitions: An optional list of partitions, by default all
+            partitions of the topic.
+          offsets: An optional list of start offsets, one for each partition,
+            by default 0.
+          servers: An optional list of bootstrap servers, by default
+             `localhost:9092`.
+          configuration: An optional `tf.string` tensor containing
+            configurations in [Key=Value] format.
+            Global configuration: please refer to 'Global configuration properties'
+              in librdkafka doc.
+            Topic configuration: please refer to 'Topic configuration properties'
+              in librdkafka doc. Note all topic configurations should be
+              prefixed with `conf.topic.`.
+            Reference: https://github.com/edenhill/librdkafka/blob/master/CONFIGURATION.md
+          batch_size: The maximum number of messages per element.
+          capacity: The number of messages prefetched per partition.
+          eof: If True, the dataset ends once every partition reaches its end.
+          timeout: The time in milliseconds to wait for new messages before
+            the dataset ends, by default -1 to wait forever.
+        """
+        with tf.name_scope("KafkaPartitionedIODataset"):
+            metadata = list(configuration or [])
+            if servers is not None:
+                metadata.append("bootstrap.servers=%s" % servers)
+            self._element_spec = (
+                tf.TensorSpec(shape=[None], dtype=tf.string),
+                tf.TensorSpec(shape=[None], dtype=tf.string),
+                tf.TensorSpec(shape=[None], dtype=tf.int32),
+                tf.TensorSpec(shape=[None], dtype=tf.int64),
+            )
+            variant_tensor = core_ops.io_kafka_partitioned_dataset(
+                topic=topic,
+                partitions=tf.constant(partitions or [], tf.int32),
+                offsets=tf.constant(offsets or [], tf.int64),
+                batch_size=batch_size,
+                capacity=capacity,
+                eof=eof,
+                timeout=timeout,
+                metadata=tf.constant(metadata, tf.string),
+            )
+            super().__init__(variant_tensor)
+
+    @property
+    def element_spec(self):
+        return self._element_spec
@@ -0,0 +1,112 @@
+# Copyright 2021 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ==============================================================================
+"""KafkaWriter"""
+
+import tensorflow as tf
+from tensorflow_io.python.ops import core_ops
+
+
+class KafkaWriter:
+    """Writes batches of messages to a kafka topic asynchronously.
+
+    `write` hands a whole string tensor to librdkafka without copying the
+    messages and returns a batch id right away. Delivery reports are
+    collected in the background and retrieved per batch with `results`:
+
+    >>> import tensorflow_io as tfio
+    >>> writer = tfio.experimental.streaming.KafkaWriter(
+    ...     "predictions", servers="localhost:9092", linger_ms=10)
+    >>> batch = writer.write(tf.constant(["D0", "D1"]))
+    >>> writer.flush()
+    >>> results = writer.results()
+    """
+
+    def __init__(
+        self,
+        topic,
+        partition=-1,
+        servers=None,
+        configuration=None,
+        linger_ms=None,
+        batch_size=None,
+        compression=None,
+    ):
+        """Creates a `KafkaWriter`.
+
+        Args:
+          topic: A `tf.string` tensor containing the topic name.
+          partition: The partition to write to, by default -1 to let the
+            partitioner choose based on the key.
+          servers: An optional list of bootstrap servers, by default
+             `localhost:9092`.
+          configuration: An optional `tf.string` tensor containing
+            configurations in [Key=Value] format, see
+            https://github.com/edenhill/librdkafka/blob/master/CONFIGURATION.md
+          linger_ms: An optional `linger.ms`, the time to wait for messages
+            to accumulate before sending a request.
+          batch_size: An optional `batch.num.messages`, the maximum number of
+            messages per request.
+          compression: An optional `compression.codec`, e.g. "lz4" or "zstd".
+        """
+        with tf.name_scope("KafkaWriter"):
+            metadata = list(configuration or [])
+            if servers is not None:
+                metadata.append("bootstrap.servers=%s" % servers)
+            if linger_ms is not None:
+                metadata.append("linger.ms=%d" % linger_ms)
+            if batch_size is not None:
+                metadata.append("batch.num.messages=%d" % batch_size)
+            if compression is not None:
+                metadata.append("compression.codec=%s" % compression)
+            self._resource = core_ops.io_kafka_writable_init(topic, partition, metadata)
+
+    def write(self, message, key=None):
+        """Queues messages for delivery without waiting for them.
+
+        `write` never blocks on a full producer queue. Messages that do not
+        fit into `queue.buffering.max.messages` are reported as `failed` in
+        `results` with a queue full error.
+
+        Args:
+          message: A `tf.string` tensor with the messages to write.
+          key: An optional `tf.string` tensor with one key per message.
+
+        Returns:
+          A `tf.int64` scalar identifying the batch in `results`.
+        """
+        if key is None:
+            key = tf.constant([], tf.string)
+        return core_ops.io_kafka_writable_write(self._resource, message, key)
+
+    def flush(self, timeout=5000):
+        """Waits up to `timeout` milliseconds for queued messages to be sent."""
+        return core_ops.io_kafka_writable_flush(self._resource, timeout)
+
+    def results(self):
+        """Returns the delivery reports of completed batches since the last call.
+
+        Returns:
+          A dict of `batch` ids with the number of `delivered` and `failed`
+          messages and the first `error` of each batch.
+        """
+        batch, delivered, failed, error = core_ops.io_kafka_writable_results(
+            self._resource
+        )
+        return {
+            "batch": batch,
+            "delivered": delivered,
+            "failed": failed,
+            "error": error,
+        }
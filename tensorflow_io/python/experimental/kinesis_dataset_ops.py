@@ -45,20 +45,31 @@ class KinesisIODataset(tf.data.Dataset):
     is `True`, then `KinesisIODataset` will keep retrying to retrieve data
     from the stream. If `read_indefinitely` is `False`, an `OutOfRangeError`
     is returned immediately instead.
+
+    Records are fetched with batched `GetRecords` calls of up to `limit`
+    records. If `shard` is not provided, all shards of the stream are
+    consumed concurrently (one reader per shard). Records of a shard keep
+    their sequence order and each fetched batch is returned contiguously,
+    but batches of different shards are returned in the order their fetches
+    complete, so there is no ordering across shards.
     """
 
-    def __init__(self, stream, shard="", internal=False):
+    def __init__(self, stream, shard="", limit=1000, internal=False):
         """Create a KinesisIODataset.
 
         Args:
           stream: A `tf.string` tensor containing the name of the stream.
-          shard: A `tf.string` tensor containing the id of the shard.
+          shard: A `tf.string` tensor containing the id of the shard. If
+            empty, all shards of the stream are read.
+          limit: The maximum number of records fetched per `GetRecords`
+            call (up to 10000).
         """
         with tf.name_scope("KinesisIODataset"):
             assert internal
 
             metadata = []
             metadata.append("shard=%s" % shard)
+            metadata.append("limit=%d" % limit)
             resource = core_ops.io_kinesis_readable_init(stream, metadata)
 
             self._resource = resource
@@ -25,10 +25,12 @@ class _MongoDBHandler:
     session data.
     """
 
-    def __init__(self, uri, database, collection):
+    def __init__(self, uri, database, collection, fields=None, batch_size=0):
         self.uri = uri
         self.database = database
         self.collection = collection
+        self.fields = fields or []
+        self.batch_size = batch_size
 
     def get_healthy_resource(self):
         """Retrieve the resource which is connected to a healthy node"""
@@ -37,6 +39,8 @@ class _MongoDBHandler:
             uri=self.uri,
             database=self.database,
             collection=self.collection,
+            fields=self.fields,
+            batch_size=self.batch_size,
         )
         print(f"Connection successful: {self.uri}")
         return resource
@@ -53,6 +57,18 @@ class _MongoDBHandler:
 
         return core_ops.io_mongo_db_readable_next(resource=resource)
 
+    def get_next_columns(self, resource, dtypes):
+        """Decodes the projected fields of the next batch of documents.
+
+        Args:
+            resource: the init op resource.
+            dtypes: the dtypes of the projected fields.
+        Returns:
+            A list of Tensors, one column per projected field.
+        """
+
+        return core_ops.io_mongo_db_readable_read(resource=resource, dtypes=dtypes)
+
 
 class MongoDBIODataset(tf.data.Dataset):
     """Fetch records from mongoDB
@@ -70,6 +86,14 @@ class MongoDBIODataset(tf.data.Dataset):
     >>> dataset = tfio.experimental.mongodb.MongoDBIODataset(
         uri=URI, database=DATABASE, collection=COLLECTION)
 
+    Passing a `spec` projects the documents on the server and decodes the
+    BSON fields directly into tensors, skipping the JSON serialization:
+
+    >>> dataset = tfio.experimental.mongodb.MongoDBIODataset(
+        uri=URI, database=DATABASE, collection=COLLECTION,
+        spec={"age": tf.int32, "fare": tf.float64, "address.city": tf.string},
+        batch_size=512)
+
     Perform operations on the dataset as one would with any `tf.data.Dataset`
     >>> dataset = dataset.map(transform_func)
     >>> dataset = dataset.batch(batch_size)
@@ -82,7 +106,7 @@ class MongoDBIODataset(tf.data.Dataset):
 
     """
 
-    def __init__(self, uri, database, collection):
+    def __init__(self, uri, database, collection, spec=None, batch_size=0):
         """Initialize the dataset with the following parameters
 
         Args:
@@ -107,14 +131,45 @@ class MongoDBIODataset(tf.data.Dataset):
                 server or a replica set to connect to.
             collection: A string, representing the collection from which the documents
                 have to be retrieved.
+            spec: An optional dict mapping field names (dotted paths for nested
+                fields) to `tf.DType` or `tf.TensorSpec`. When given, only those
+                fields are fetched and each element is a dict of scalar tensors
+                instead of a JSON string. Integer, double and boolean values are
+                converted between each other, datetimes read as int64
+                milliseconds, and string fields also accept object ids, binary
+                data and (as JSON) embedded documents and arrays.
+            batch_size: An optional int, the number of documents the server
+                returns per cursor round trip and the number decoded per read.
+                Defaults to the server's choice and 1024 documents per read.
         """
-        handler = _MongoDBHandler(uri=uri, database=database, collection=collection)
+        fields = list(spec.keys()) if spec is not None else None
+        handler = _MongoDBHandler(
+            uri=uri,
+            database=database,
+            collection=collection,
+            fields=fields,
+            batch_size=batch_size,
+        )
         resource = handler.get_healthy_resource()
         dataset = tf.data.experimental.Counter()
-        dataset = dataset.map(lambda i: handler.get_next_batch(resource=resource))
-        dataset = dataset.apply(
-            tf.data.experimental.take_while(lambda v: tf.greater(tf.shape(v)[0], 0))
-        )
+        if spec is None:
+            dataset = dataset.map(lambda i: handler.get_next_batch(resource=resource))
+            dataset = dataset.apply(
+                tf.data.experimental.take_while(lambda v: tf.greater(tf.shape(v)[0], 0))
+            )
+        else:
+            dtypes = [
+                v.dtype if isinstance(v, tf.TensorSpec) else tf.as_dtype(v)
+                for v in spec.values()
+            ]
+            dataset = dataset.map(
+                lambda i: dict(zip(fields, handler.get_next_columns(resource, dtypes)))
+            )
+            dataset = dataset.apply(
+                tf.data.experimental.take_while(
+                    lambda v: tf.greater(tf.shape(v[fields[0]])[0], 0)
+                )
+            )
         dataset = dataset.flat_map(lambda x: tf.data.Dataset.from_tensor_slices(x))
         self._dataset = dataset
 
@@ -21,7 +21,15 @@ from tensorflow_io.python.ops import core_ops
 class PubSubStreamIODataset(tf.data.Dataset):
     """PubSubStreamGraphIODataset"""
 
-    def __init__(self, subscription, endpoint=None, timeout=10000, internal=True):
+    def __init__(
+        self,
+        subscription,
+        endpoint=None,
+        timeout=10000,
+        max_messages=1000,
+        ack_deadline=10,
+        internal=True,
+    ):
         """PubSubStreamIODataset."""
         with tf.name_scope("PubSubStreamIODataset"):
             assert internal
@@ -30,6 +38,8 @@ class PubSubStreamIODataset(tf.data.Dataset):
             if endpoint is not None:
                 metadata.append("endpoint=%s" % endpoint)
             metadata.append("timeout=%d" % timeout)
+            metadata.append("max_messages=%d" % max_messages)
+            metadata.append("ack_deadline=%d" % ack_deadline)
             resource = core_ops.io_pub_sub_readable_init(subscription, metadata)
 
             self._resource = resource
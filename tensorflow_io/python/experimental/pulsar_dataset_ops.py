@@ -29,6 +29,7 @@ class PulsarIODataset(tf.data.Dataset):
         timeout,
         ack_grouping_time=-1,
         poll_timeout=100,
+        batch_receive=False,
     ):
         """Creates a `PulsarIODataset` from pulsar server with a subscription
 
@@ -51,6 +52,10 @@ class PulsarIODataset(tf.data.Dataset):
             message was received, it would try again until `timeout` exceeds.
             `poll_timeout` must be positive and not larger than `timeout`.
             Default: 100
+          batch_receive: If True, messages are received in batches of up to 1024
+            messages or whatever arrived within `poll_timeout`, and each batch is
+            acknowledged cumulatively instead of message by message.
+            Default: False
         """
         with tf.name_scope("PulsarIODataset"):
             if timeout <= 0:
@@ -69,7 +74,12 @@ class PulsarIODataset(tf.data.Dataset):
                 )
 
             resource = core_ops.io_pulsar_readable_init(
-                service_url, topic, subscription, ack_grouping_time
+                service_url,
+                topic,
+                subscription,
+                ack_grouping_time,
+                batch_receive=batch_receive,
+                batch_receive_timeout=poll_timeout,
             )
             self._resource = resource
             dataset = tf.data.experimental.Counter()
@@ -21,24 +21,50 @@ from tensorflow_io.python.ops import core_ops
 class PulsarWriter:
     """PulsarWriter"""
 
-    def __init__(self, service_url, topic):
+    def __init__(
+        self,
+        service_url,
+        topic,
+        batching=False,
+        batching_max_messages=1000,
+        batching_max_publish_delay=10,
+        compression="",
+    ):
         """Creates a `PulsarWriter` for writing messages to a pulsar topic
 
         Args:
           service_url: A `tf.string` tensor containing the service url of pulsar broker.
             For example: "pulsar://localhost:6650".
           topic: A `tf.string` tensor containing the topic name.
+          batching: If True, queued messages are sent in batches.
+            Default: False
+          batching_max_messages: The maximum number of messages per batch.
+            Default: 1000
+          batching_max_publish_delay: The time in milliseconds a batch may wait
+            for more messages before it is sent.
+            Default: 10
+          compression: The compression of the messages, one of "lz4", "zlib",
+            "zstd" or "snappy". Default: "" (no compression)
         """
         with tf.name_scope("PulsarWriter"):
-            resource = core_ops.io_pulsar_writable_init(service_url, topic)
+            resource = core_ops.io_pulsar_writable_init(
+                service_url,
+                topic,
+                batching=batching,
+                batching_max_messages=batching_max_messages,
+                batching_max_publish_delay=batching_max_publish_delay,
+                compression=compression,
+            )
             self._resource = resource
 
     def write(self, value, key=""):
         """Write a message to pulsar topic asynchronously
 
         Args:
-          value: A `tf.string` tensor containing the value of message
+          value: A `tf.string` tensor containing the value of message, or a
+            tensor of values to write them all at once.
           key: A `tf.string` tensor containing the key of message, if it's an empty string, the message will have no key.
+            Either a single key for all values or one key per value.
             Default: ""
         """
         return core_ops.io_pulsar_writable_write(self._resource, value, key)
@@ -432,15 +432,19 @@ def fade(input, fade_in, fade_out, mode, name=None):
     return factor_in * factor_out * input
 
 
-def resample(input, rate_in, rate_out, name=None):
+def resample(input, rate_in, rate_out, quality=4, name=None):
     """Resample audio.
 
+    A batch of clips is resampled in parallel. Each clip is resampled on its
+    own, use `AudioResampler` to resample a stream chunk by chunk.
+
     Args:
       input: A 1-D (`[samples]`) or 2-D (`[samples, channels]`) or 3-D
         (`[batch, samples, channels]`) `Tensor` of type
         `int16` or `float`. Audio input.
       rate_in: The rate of the audio input.
       rate_out: The rate of the audio output.
+      quality: The resampler quality, from 0 (fastest) to 10 (best).
       name: A name for the operation (optional).
 
     Returns:
@@ -461,12 +465,9 @@ def resample(input, rate_in, rate_out, name=None):
         [(tf.math.equal(rank, 1), f1), (tf.math.equal(rank, 2), f2)], default=f3
     )
 
-    def f(i):
-        return core_ops.io_audio_resample(
-            i, rate_in=rate_in, rate_out=rate_out, name=name
-        )
-
-    value = tf.vectorized_map(f, input)
+    value = core_ops.io_audio_resample_batch(
+        input, rate_in=rate_in, rate_out=rate_out, quality=quality, name=name
+    )
 
     def g1():
         return tf.squeeze(value, [0, -1])
@@ -482,6 +483,60 @@ def resample(input, rate_in, rate_out, name=None):
     )
 
 
+class AudioResampler:
+    """AudioResampler resamples a stream of audio chunk by chunk.
+
+    The resampler state is kept between calls, so resampling consecutive
+    chunks gives the same result as resampling the whole stream at once,
+    without discontinuities at the chunk boundaries.
+
+    Example:
+
+    ```python
+    resampler = tfio.audio.AudioResampler(44100, 16000, channels=2)
+    for chunk in chunks:
+        output = resampler(chunk)
+    output = resampler(last_chunk, flush=True)
+    ```
+    """
+
+    def __init__(self, rate_in, rate_out, channels, quality=4):
+        """Create an AudioResampler.
+
+        Args:
+          rate_in: The rate of the audio input.
+          rate_out: The rate of the audio output.
+          channels: The number of channels of the audio.
+          quality: The resampler quality, from 0 (fastest) to 10 (best).
+        """
+        with tf.name_scope("AudioResampler"):
+            self._resource = core_ops.io_audio_resampler_init(
+                rate_in=tf.cast(rate_in, tf.int64),
+                rate_out=tf.cast(rate_out, tf.int64),
+                channels=tf.cast(channels, tf.int64),
+                quality=quality,
+            )
+
+    def __call__(self, input, flush=False, name=None):
+        """Resample the next chunk of the stream.
+
+        Args:
+          input: A 2-D (`[samples, channels]`) `Tensor` of type `int16` or
+            `float`. The next chunk of the audio.
+          flush: Whether this is the last chunk. The samples still held by
+            the filter are returned and the resampler is reset for a new
+            stream.
+          name: A name for the operation (optional).
+
+        Returns:
+          output: The resampled chunk, the number of samples may vary
+            between calls.
+        """
+        return core_ops.io_audio_resampler_process(
+            self._resource, input, flush, name=name
+        )
+
+
 def decode_wav(
     input, shape=None, dtype=None, name=None
 ):  # pylint: disable=redefined-builtin
@@ -570,6 +625,21 @@ def decode_vorbis(input, shape=None, name=None):  # pylint: disable=redefined-bu
     return core_ops.io_audio_decode_vorbis(input, shape=shape, name=name)
 
 
+def decode_vorbis_batch(input, name=None):  # pylint: disable=redefined-builtin
+    """Decode a batch of Ogg(Vorbis) audio clips in parallel.
+
+    Args:
+      input: A 1-D string `Tensor` of the audio inputs.
+      name: A name for the operation (optional).
+
+    Returns:
+      output: A tuple of the decoded audio as tf.float32 of shape
+        `[batch, samples, channels]`, zero padded to the longest clip, and
+        the number of samples of each clip as tf.int64.
+    """
+    return core_ops.io_audio_decode_vorbis_batch(input, name=name)
+
+
 def encode_vorbis(input, rate, name=None):  # pylint: disable=redefined-builtin
     """Encode Ogg(Vorbis) audio into string.
 
@@ -637,6 +707,31 @@ def decode_aac(input, shape=None, name=None):  # pylint: disable=redefined-built
     return core_ops.io_audio_decode_aac(input, shape=shape, name=name)
 
 
+def decode_aac_batch(input, name=None):  # pylint: disable=redefined-builtin
+    """Decode a batch of MP4 (AAC) audio clips in parallel.
+
+    Clips are decoded on the CPU worker threads, which reuse pooled decoder
+    contexts, so short clips are much cheaper than one `decode_aac` each.
+
+    Args:
+      input: A 1-D string `Tensor` of the audio inputs.
+      name: A name for the operation (optional).
+
+    Returns:
+      output: A tuple of the decoded audio as tf.float32 of shape
+        `[batch, samples, channels]`, zero padded to the longest clip, and
+        the number of samples of each clip as tf.int64.
+    """
+    if sys.platform == "linux":
+        try:
+            from tensorflow_io.python.ops import (  # pylint: disable=import-outside-toplevel,unused-import
+                ffmpeg_ops,
+            )
+        except NotImplementedError:
+            pass
+    return core_ops.io_audio_decode_aac_batch(input, name=name)
+
+
 def encode_aac(input, rate, name=None):  # pylint: disable=redefined-builtin
     """Encode MP4(AAC) audio into string.
 
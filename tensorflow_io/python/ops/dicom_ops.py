@@ -28,6 +28,8 @@ def decode_dicom_image(
     on_error="skip",
     scale="preserve",
     dtype=tf.uint16,
+    frame_start=0,
+    frame_count=-1,
     name=None,
 ):
     """Getting DICOM Image Data.
@@ -76,6 +78,11 @@ def decode_dicom_image(
         dtype: An optional `tf.DType` from: `tf.uint8`, `tf.uint16`, `tf.uint32`,
         `tf.uint64`, `tf.float16`, `tf.float32`, `tf.float64`. Defaults to
         `tf.uint16`.
+        frame_start: An optional `int`. Defaults to `0`. Index of the first
+        frame to decode from a multi-frame image.
+        frame_count: An optional `int`. Defaults to `-1`. Number of frames to
+        decode starting at `frame_start`, `-1` decodes all the remaining
+        frames. Frames outside of the range are not decompressed.
         name: A name for the operation (optional).
 
     Returns:
@@ -83,6 +90,8 @@ def decode_dicom_image(
     """
     return core_ops.io_decode_dicom_image(
         contents=contents,
+        frame_start=tf.cast(frame_start, tf.int64),
+        frame_count=tf.cast(frame_count, tf.int64),
         color_dim=color_dim,
         on_error=on_error,
         scale=scale,
@@ -61,3 +61,4 @@ io_ffmpeg_audio_readable_init = _ffmpeg_ops.io_ffmpeg_audio_readable_init
 io_ffmpeg_audio_readable_next = _ffmpeg_ops.io_ffmpeg_audio_readable_next
 io_ffmpeg_video_readable_init = _ffmpeg_ops.io_ffmpeg_video_readable_init
 io_ffmpeg_video_readable_next = _ffmpeg_ops.io_ffmpeg_video_readable_next
+io_ffmpeg_video_readable_read = _ffmpeg_ops.io_ffmpeg_video_readable_read
@@ -148,6 +148,8 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
               prefixed with `conf.topic.`. Examples include
               ["conf.topic.auto.offset.reset=earliest"]
             Reference: https://github.com/edenhill/librdkafka/blob/master/CONFIGURATION.md
+          include_metadata: If True, elements are dicts that also carry the
+            timestamp, offset and headers of each message (optional).
           name: A name prefix for the IODataset (optional).
 
         Returns:
@@ -162,6 +164,7 @@ class IODataset(io_dataset_ops._IODataset):  # pylint: disable=protected-access
                 stop=stop,
                 servers=servers,
                 configuration=configuration,
+                include_metadata=kwargs.get("include_metadata", False),
                 internal=True,
             )
 
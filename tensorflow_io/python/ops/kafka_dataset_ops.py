@@ -22,7 +22,15 @@ class KafkaIODataset(tf.data.Dataset):
     """KafkaIODataset"""
 
     def __init__(
-        self, topic, partition, start, stop, servers, configuration, internal=True
+        self,
+        topic,
+        partition,
+        start,
+        stop,
+        servers,
+        configuration,
+        include_metadata=False,
+        internal=True,
     ):
         """Creates a `KafkaIODataset` from kafka server with an offset range.
 
@@ -43,6 +51,9 @@ class KafkaIODataset(tf.data.Dataset):
               prefixed with `conf.topic.`. Examples include
               ["conf.topic.auto.offset.reset=earliest"]
             Reference: https://github.com/edenhill/librdkafka/blob/master/CONFIGURATION.md
+          include_metadata: If True, each element is a dict with `message`,
+            `key`, `timestamp`, `offset`, and ragged `header_key` and
+            `header_value` instead of a `(message, key)` tuple. Default: False
           internal: Whether the dataset is being created from within the named scope.
             Default: True
         """
@@ -72,6 +83,34 @@ class KafkaIODataset(tf.data.Dataset):
                     self._resource, start=start, stop=stop
                 )
 
+            def g(start, stop):
+                (
+                    message,
+                    key,
+                    timestamp,
+                    offset,
+                    header_key,
+                    header_value,
+                    header_splits,
+                ) = core_ops.io_kafka_readable_read_records(
+                    self._resource, start=start, stop=stop
+                )
+                return {
+                    "message": message,
+                    "key": key,
+                    "timestamp": timestamp,
+                    "offset": offset,
+                    "header_key": tf.RaggedTensor.from_row_splits(
+                        header_key, header_splits
+                    ),
+                    "header_value": tf.RaggedTensor.from_row_splits(
+                        header_value, header_splits
+                    ),
+                }
+
+            if include_metadata:
+                f = g
+
             dataset = dataset.map(f)
             dataset = dataset.unbatch()
 
@@ -23,7 +23,15 @@ class PrometheusIODataset(tf.data.Dataset):
     """PrometheusIODataset"""
 
     def __init__(
-        self, query, length, offset=None, endpoint=None, spec=None, internal=True
+        self,
+        query,
+        length,
+        offset=None,
+        endpoint=None,
+        spec=None,
+        window=None,
+        concurrency=None,
+        internal=True,
     ):
         """PrometheusIODataset."""
         with tf.name_scope("PrometheusIODataset"):
@@ -35,6 +43,10 @@ class PrometheusIODataset(tf.data.Dataset):
                 metadata.append("offset=%d" % offset)
             if endpoint is not None:
                 metadata.append("endpoint=%s" % endpoint)
+            window = 1000 if window is None else window
+            concurrency = 4 if concurrency is None else concurrency
+            metadata.append("window=%d" % window)
+            metadata.append("concurrency=%d" % concurrency)
             resource, metrics = golang_ops.io_prometheus_readable_init(query, metadata)
             # Construct spec in eager mode, and take spec from user in graph mode.
             if spec is None:
@@ -84,7 +96,9 @@ class PrometheusIODataset(tf.data.Dataset):
                 value = tf.unstack(value, num=len(flatten))
                 return timestamp, tf.nest.pack_sequence_as(entries, value)
 
-            step = 1 * 1000  # 1 second
+            # Every read covers `concurrency` sub-windows of `window` seconds,
+            # which are fetched in parallel.
+            step = window * concurrency * 1000
 
             self._resource = resource
             start, stop = golang_ops.io_prometheus_readable_spec(resource)
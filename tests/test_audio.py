@@ -63,8 +63,9 @@ def fixture_audio_data_24():
             lambda f: tfio.IOTensor.from_ffmpeg(f)("a:0"),
             marks=[pytest.mark.xfail(reason="does not support 24 bit yet")],
         ),
+        pytest.param(lambda f: tfio.audio.AudioIOTensor(f)),
     ],
-    ids=["from_ffmpeg"],
+    ids=["from_ffmpeg", "from_audio"],
 )
 def test_audio_io_tensor_24(audio_data_24, io_tensor_func):
     """test_audio_io_tensor_24"""
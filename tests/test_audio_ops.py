@@ -1027,3 +1027,149 @@ def test_audio_trim_split_remix():
 
         result = tfio.audio.remix(value, axis=axis, indices=indices)
         assert np.array_equal(ek, result)
+
+
+def test_audio_resampler():
+    """test_audio_resampler"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "ZASFX_ADSR_no_sustain.wav",
+    )
+    audio = tf.audio.decode_wav(tf.io.read_file(path))
+    value = audio.audio
+
+    expected = tfio.audio.resample(value, 44100, 16000)
+    for quality in [0, 4, 10]:
+        resampler = tfio.audio.AudioResampler(44100, 16000, 2, quality=quality)
+        chunks = [resampler(value[i : i + 1000]) for i in range(0, 14000, 1000)]
+        chunks.append(resampler(value[14000:], flush=True))
+        streamed = tf.concat(chunks, axis=0)
+        assert streamed.shape == [14336 * 16000 // 44100, 2]
+        if quality == 4:
+            assert np.allclose(streamed, expected, atol=1e-5)
+
+        # The resampler is reset after a flush.
+        again = resampler(value, flush=True)
+        assert np.allclose(again, streamed, atol=1e-5)
+
+    batch = tfio.audio.resample(tf.stack([value, value, value]), 44100, 16000)
+    for i in range(3):
+        assert np.array_equal(batch[i], expected)
+
+
+@pytest.mark.parametrize(
+    ("filename"),
+    [
+        pytest.param("ZASFX_ADSR_no_sustain.flac"),
+        pytest.param("ZASFX_ADSR_no_sustain.s24.flac"),
+        pytest.param("l1-fl6.bit"),
+        pytest.param("ZASFX_ADSR_no_sustain.ogg"),
+    ],
+)
+def test_audio_seek_index(filename, tmp_path, monkeypatch):
+    """test_audio_seek_index"""
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "test_audio")
+    # A copy under a fresh name is not in the in-process index cache yet.
+    copy = tmp_path / ("copy" + os.path.splitext(filename)[1])
+    copy.write_bytes(open(os.path.join(path, filename), "rb").read())
+    index_dir = tmp_path / "index"
+    index_dir.mkdir()
+    monkeypatch.setenv("TFIO_AUDIO_SEEK_INDEX_DIR", str(index_dir))
+
+    expected = tfio.audio.AudioIOTensor(os.path.join(path, filename)).to_tensor()
+    samples = expected.shape[0]
+    rng = np.random.RandomState(0)
+    for _ in range(8):
+        start = rng.randint(0, samples - 1)
+        stop = rng.randint(start + 1, samples + 1)
+        value = tfio.audio.AudioIOTensor(str(copy))[start:stop]
+        assert np.array_equal(value, expected[start:stop])
+    assert len(os.listdir(index_dir)) == 1
+
+    # Rewriting the file in place keeps its size, but the modification time
+    # is part of the key, so the index is not reused.
+    stat = os.stat(copy)
+    os.utime(copy, ns=(stat.st_atime_ns, stat.st_mtime_ns + 10**10))
+    start = samples // 2
+    value = tfio.audio.AudioIOTensor(str(copy))[start:]
+    assert np.array_equal(value, expected[start:])
+    assert len(os.listdir(index_dir)) == 2
+
+
+@pytest.mark.skipif(
+    (sys.platform == "linux" and sys.version_info < (3, 8))
+    or (sys.platform in ("win32", "darwin")),
+    reason="need ubuntu 20.04 which is python 3.8, and no windows",
+)
+def test_decode_aac_batch():
+    """test_decode_aac_batch"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "gs-16b-2c-44100hz.mp4",
+    )
+    content = tf.io.read_file(path)
+    clip = tfio.audio.encode_aac(tfio.audio.decode_aac(content)[:20000], rate=44100)
+    expected = [tfio.audio.decode_aac(e) for e in [content, clip, content]]
+
+    value, length = tfio.audio.decode_aac_batch(tf.stack([content, clip, content]))
+    assert value.shape == [3, expected[0].shape[0], 2]
+    for i, e in enumerate(expected):
+        assert length[i] == e.shape[0]
+        assert np.array_equal(value[i, : length[i]], e)
+        assert np.all(value[i, length[i] :] == 0)
+
+
+def test_decode_vorbis_batch():
+    """test_decode_vorbis_batch"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "ZASFX_ADSR_no_sustain.ogg",
+    )
+    content = tf.io.read_file(path)
+    audio = tfio.audio.decode_vorbis(content)
+    clip = tfio.audio.encode_vorbis(audio[:5000], rate=44100)
+    expected = [tfio.audio.decode_vorbis(e) for e in [clip, content]]
+
+    value, length = tfio.audio.decode_vorbis_batch(tf.stack([clip, content]))
+    assert value.shape == [2, audio.shape[0], 2]
+    for i, e in enumerate(expected):
+        assert length[i] == e.shape[0]
+        assert np.array_equal(value[i, : length[i]], e)
+        assert np.all(value[i, length[i] :] == 0)
+
+
+# Per clip latency of decoding a batch of short clips one by one, which sets
+# up a decoder for every clip, against the batched, pooled decode.
+@pytest.mark.benchmark(
+    group="decode_aac",
+)
+@pytest.mark.parametrize(("batched"), [False, True], ids=["clip", "batch"])
+@pytest.mark.skipif(
+    (sys.platform == "linux" and sys.version_info < (3, 8))
+    or (sys.platform in ("win32", "darwin")),
+    reason="need ubuntu 20.04 which is python 3.8, and no windows",
+)
+def test_decode_aac_benchmark(benchmark, batched):
+    """test_decode_aac_benchmark"""
+    path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_audio",
+        "gs-16b-2c-44100hz.mp4",
+    )
+    audio = tfio.audio.decode_aac(tf.io.read_file(path))
+    clips = tf.stack(
+        [
+            tfio.audio.encode_aac(audio[i : i + 4410], rate=44100)
+            for i in range(0, 64 * 441, 441)
+        ]
+    )
+
+    def f(clips):
+        if batched:
+            return tfio.audio.decode_aac_batch(clips)[0]
+        return [tfio.audio.decode_aac(clip) for clip in clips]
+
+    benchmark(f, clips)
@@ -143,6 +143,49 @@ def test_dicom_image_shape():
     dataset = dataset.map(lambda e: tf.image.resize(e, (224, 224)))
 
 
+@pytest.mark.parametrize(
+    "fname, frame_start, frame_count, exp_shape",
+    [
+        ("MR-MONO2-8-16x-heart.dcm", 0, -1, (16, 256, 256, 1)),
+        ("MR-MONO2-8-16x-heart.dcm", 4, 3, (3, 256, 256, 1)),
+        ("MR-MONO2-8-16x-heart.dcm", 15, -1, (1, 256, 256, 1)),
+        ("US-PAL-8-10x-echo.dcm", 2, 5, (5, 430, 600, 3)),
+        ("NM-MONO2-16-13x-heart.dcm", 6, 7, (7, 64, 64, 1)),
+    ],
+)
+def test_decode_dicom_image_frames(fname, frame_start, frame_count, exp_shape):
+    """test_decode_dicom_image_frames"""
+
+    dcm_path = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_dicom", fname
+    )
+
+    file_contents = tf.io.read_file(filename=dcm_path)
+
+    dcm_image = tfio.image.decode_dicom_image(
+        contents=file_contents, dtype=tf.uint16, on_error="strict"
+    )
+    dcm_frames = tfio.image.decode_dicom_image(
+        contents=file_contents,
+        dtype=tf.uint16,
+        on_error="strict",
+        frame_start=frame_start,
+        frame_count=frame_count,
+    )
+    assert dcm_frames.numpy().shape == exp_shape
+    assert np.array_equal(
+        dcm_frames.numpy(),
+        dcm_image.numpy()[frame_start : frame_start + exp_shape[0]],
+    )
+
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.image.decode_dicom_image(
+            contents=file_contents,
+            frame_start=dcm_image.shape[0],
+            frame_count=1,
+        )
+
+
 def test_dicom_image_concurrency():
     """test_decode_dicom_image_currency"""
 
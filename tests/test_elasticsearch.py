@@ -137,6 +137,32 @@ def test_elasticsearch_io_dataset_batch():
             assert len(item[attr]) == BATCH_SIZE
 
 
+@pytest.mark.skipif(not is_container_running(), reason="The container is not running")
+def test_elasticsearch_io_dataset_sliced():
+    """Test the parallel sliced scroll reader of the ElasticsearchIODataset"""
+
+    dataset = tfio.experimental.elasticsearch.ElasticsearchIODataset(
+        nodes=[NODE],
+        index=INDEX,
+        doc_type=DOC_TYPE,
+        headers=HEADERS,
+        spec={"name": tf.string, "age": tf.int64, "fare": tf.double},
+        query={"query": {"range": {"age": {"gte": 30}}}},
+        slices=2,
+        size=1,
+    )
+
+    items = sorted(
+        (item["name"].numpy(), item["age"].numpy(), item["fare"].numpy())
+        for item in dataset
+    )
+    assert items == [
+        (b"person2", 30, 40.88),
+        (b"person3", 40, 20.73),
+        (b"person4", 50, 100.99),
+    ]
+
+
 @pytest.mark.skipif(not is_container_running(), reason="The container is not running")
 def test_elasticsearch_io_dataset_training():
     """Test the functionality of the ElasticsearchIODataset by training a
@@ -117,6 +117,30 @@ def test_ffmpeg_decode_video_invalid_index(video_path):
         tfio.experimental.ffmpeg.decode_video(content, 1)
 
 
+@pytest.mark.skipif(
+    sys.platform == "darwin",
+    reason="TODO: macOS on GitHub use ffmpeg 5.0, needs update",
+)
+def test_ffmpeg_read_video(video_path):
+    """test_ffmpeg_read_video"""
+    video = tfio.experimental.ffmpeg.decode_video(tf.io.read_file(video_path), 0)
+    video = video.numpy().astype(np.int32)
+
+    for start, stop, stride in [(0, -1, 1), (50, 80, 1), (100, 166, 7)]:
+        value = tfio.experimental.ffmpeg.read_video(
+            video_path, start=start, stop=stop, stride=stride
+        )
+        expected = video[start:stop:stride] if stop >= 0 else video[start::stride]
+        assert value.shape == expected.shape
+        assert np.abs(value.numpy().astype(np.int32) - expected).mean() < 2
+
+    value = tfio.experimental.ffmpeg.read_video(
+        video_path, start=2.0, stop=3.0, unit="second", size=[160, 280]
+    )
+    assert value.shape[1:] == [160, 280, 3]
+    assert 0 < value.shape[0] < 166
+
+
 @pytest.mark.skipif(sys.platform == "darwin", reason="macOS fails now")
 def test_video_predict(video_path):
     """test_video_predict"""
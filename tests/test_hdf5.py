@@ -178,5 +178,51 @@ def test_hdf5_bool():
     shutil.rmtree(runpath)
 
 
+def test_hdf5_remote():
+    """test_hdf5_remote: chunked reads through the virtual file driver"""
+    runpath = tempfile.mkdtemp()
+
+    features = np.random.random((100000, 8))
+    with h5py.File(f"{runpath}/file.h5", "w") as f:
+        f.create_dataset(
+            "features", data=features, chunks=(1000, 8), compression="gzip"
+        )
+
+    # file:// goes through tensorflow's filesystem instead of hdf5's sec2 driver
+    filename = "file://" + runpath + "/file.h5"
+    hdf5 = tfio.IOTensor.from_hdf5(filename)
+    assert hdf5("/features").shape == [100000, 8]
+    assert np.array_equal(hdf5("/features")[50000:50010], features[50000:50010])
+    assert np.array_equal(hdf5("/features")[0:100], features[0:100])
+    assert np.array_equal(hdf5("/features").to_tensor(), features)
+
+    shutil.rmtree(runpath)
+
+
+def test_hdf5_chunked():
+    """test_hdf5_chunked: parallel decompression of chunked hyperslab"""
+    runpath = tempfile.mkdtemp()
+
+    features = np.random.randint(0, 1000, size=(1003, 37, 5)).astype(np.int32)
+    with h5py.File(f"{runpath}/file.h5", "w") as f:
+        f.create_dataset(
+            "gzip", data=features, chunks=(10, 8, 3), compression="gzip"
+        )
+        f.create_dataset(
+            "shuffle",
+            data=features,
+            chunks=(10, 8, 3),
+            compression="gzip",
+            shuffle=True,
+        )
+
+    hdf5 = tfio.IOTensor.from_hdf5(f"{runpath}/file.h5")
+    for name in ["/gzip", "/shuffle"]:
+        assert np.array_equal(hdf5(name)[7:907], features[7:907])
+        assert np.array_equal(hdf5(name).to_tensor(), features)
+
+    shutil.rmtree(runpath)
+
+
 if __name__ == "__main__":
     test.main()
@@ -16,6 +16,7 @@
 
 import os
 import numpy as np
+import pytest
 
 import tensorflow as tf
 import tensorflow_io as tfio
@@ -433,6 +434,170 @@ def test_decode_jp2_uint16():
     assert rgb.shape == data.shape
     assert np.array_equal(rgb, data)
 
+    # 16 bit samples do not fit into uint8.
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.experimental.image.decode_jp2(contents, dtype=tf.uint8)
+
+
+def test_decode_batch():
+    """Test case for decode_batch"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_image",
+        "Jelly-Beans.jp2",
+    )
+    contents = tf.io.read_file(filename)
+    rgb = tfio.experimental.image.decode_jp2(contents)
+
+    batch = tf.stack([contents, contents, contents])
+    images = tfio.experimental.image.decode_batch(batch, "jp2")
+    assert images.dtype == tf.uint8
+    assert images.shape == [3] + rgb.shape
+    for image in images:
+        assert np.all(image == rgb)
+
+    size = [rgb.shape[0] // 2, rgb.shape[1] // 2]
+    resized = tf.cast(
+        tf.round(tf.image.resize(rgb, size, method="bilinear", antialias=False)),
+        tf.uint8,
+    )
+    images = tfio.experimental.image.decode_batch(batch, "jp2", size=size)
+    assert images.shape == [3] + size + [rgb.shape[2]]
+    for image in images:
+        assert np.max(np.abs(image.numpy().astype(np.int32) - resized.numpy())) <= 1
+
+    images = tfio.experimental.image.decode_batch(
+        batch, "jp2", size=[size[0], rgb.shape[1]], preserve_aspect_ratio=True
+    )
+    assert images.shape == [3, size[0], rgb.shape[1], rgb.shape[2]]
+    assert np.all(images[:, :, : rgb.shape[1] // 4] == 0)
+
+
+@pytest.mark.parametrize(
+    ("format", "filename", "dtype", "decode"),
+    [
+        ("webp", "sample.webp", None, tfio.image.decode_webp),
+        (
+            "pnm",
+            "r-1316653631.481244-81973200.ppm",
+            None,
+            tfio.experimental.image.decode_pnm,
+        ),
+        (
+            "pnm",
+            "d-1316653631.269651-68451027.pgm",
+            tf.uint16,
+            lambda contents: tfio.experimental.image.decode_pnm(
+                contents, dtype=tf.uint16
+            ),
+        ),
+        ("hdr", "glacier.hdr", None, tfio.experimental.image.decode_hdr),
+        (
+            "avif",
+            "kodim03_yuv420_8bpc.avif",
+            None,
+            tfio.experimental.image.decode_avif,
+        ),
+    ],
+)
+def test_decode_batch_formats(format, filename, dtype, decode):
+    """Test case for decode_batch against the single image decode ops"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_image", filename
+    )
+    contents = tf.io.read_file(filename)
+    image = decode(contents)
+
+    batch = tf.stack([contents, contents])
+    images = tfio.experimental.image.decode_batch(batch, format, dtype=dtype)
+    assert images.dtype == image.dtype
+    assert images.shape == [2] + image.shape
+    for e in images:
+        assert np.all(e == image)
+
+    size = [image.shape[0] // 2, image.shape[1] // 2]
+    resized = tf.image.resize(image, size, method="bilinear", antialias=False)
+    images = tfio.experimental.image.decode_batch(batch, format, dtype=dtype, size=size)
+    assert images.shape == [2] + size + [image.shape[2]]
+    for e in images:
+        if image.dtype == tf.float32:
+            assert np.allclose(e, resized, rtol=1e-4, atol=1e-4)
+        else:
+            diff = e.numpy().astype(np.float64) - np.round(resized.numpy())
+            assert np.max(np.abs(diff)) <= 1
+
+    # A wide slot is padded left and right around the scaled image.
+    images = tfio.experimental.image.decode_batch(
+        batch,
+        format,
+        dtype=dtype,
+        size=[size[0], image.shape[1]],
+        preserve_aspect_ratio=True,
+    )
+    assert images.shape == [2, size[0], image.shape[1], image.shape[2]]
+    assert np.all(images[:, :, : image.shape[1] // 4 - 1] == 0)
+    assert np.all(images[:, :, image.shape[1] - image.shape[1] // 4 + 1 :] == 0)
+
+
+def test_decode_yuv_batch():
+    """Test case for decode_yuv_batch"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_image", "Jelly-Beans.nv12"
+    )
+    contents = tf.io.read_file(filename)
+    rgb = tfio.experimental.image.decode_nv12(contents, size=[256, 256])
+
+    batch = tf.stack([contents, contents, contents])
+    images = tfio.experimental.image.decode_yuv_batch(batch, "nv12", [256, 256])
+    assert images.dtype == tf.uint8
+    assert images.shape == [3, 256, 256, 3]
+    for image in images:
+        assert np.all(image == rgb)
+
+    images = tfio.experimental.image.decode_yuv_batch(
+        batch, "nv12", [256, 256], crop=[64, 32, 128, 96], channel_order="BGR"
+    )
+    assert images.shape == [3, 128, 96, 3]
+    assert np.all(images[1] == rgb[64:192, 32:128, ::-1])
+
+    images = tfio.experimental.image.decode_yuv_batch(
+        batch, "nv12", [256, 256], data_format="NCHW", dtype=tf.float32
+    )
+    assert images.dtype == tf.float32
+    assert images.shape == [3, 3, 256, 256]
+    expected = np.transpose(rgb.numpy(), [2, 0, 1]).astype(np.float32) / 255
+    assert np.allclose(images[2], expected, atol=1e-6)
+
+    # Scaling happens in YUV space, so only compare loosely to a RGB resize.
+    resized = tf.image.resize(rgb, [128, 128], method="bilinear", antialias=False)
+    images = tfio.experimental.image.decode_yuv_batch(
+        batch, "nv12", [256, 256], resize=[128, 128]
+    )
+    assert images.shape == [3, 128, 128, 3]
+    assert np.mean(np.abs(images[0].numpy().astype(np.float32) - resized)) < 4
+
+    # I420 holds the same samples as NV12 with the chroma planes split.
+    data = np.frombuffer(contents.numpy(), np.uint8)
+    i420 = np.concatenate(
+        [data[: 256 * 256], data[256 * 256 :: 2], data[256 * 256 + 1 :: 2]]
+    )
+    images = tfio.experimental.image.decode_yuv_batch(
+        tf.stack([i420.tobytes()]), "i420", [256, 256]
+    )
+    assert np.max(np.abs(images[0].numpy().astype(np.int32) - rgb.numpy())) <= 1
+
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)), "test_image", "Jelly-Beans.yuy2"
+    )
+    contents = tf.io.read_file(filename)
+    rgb = tfio.experimental.image.decode_yuy2(contents, size=[256, 256])
+    images = tfio.experimental.image.decode_yuv_batch(
+        tf.stack([contents, contents]), "yuy2", [256, 256]
+    )
+    assert images.shape == [2, 256, 256, 3]
+    for image in images:
+        assert np.all(image == rgb)
+
 
 def test_encode_gif():
     """Test case for encode_gif."""
@@ -473,5 +638,78 @@ def test_decode_tiff_16bit():
     assert image.shape == [520, 696, 4]
 
 
+def test_decode_tiff_region():
+    """Test case for decode_tiff_region"""
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_image",
+        "IXMtest_A01_s1_w164FBEEF7-F77C-4892-86F5-72D0160D4FB2.tif",
+    )
+    contents = tf.io.read_file(filename)
+
+    image = tfio.experimental.image.decode_tiff_region(
+        contents, [0, 0], [-1, -1], dtype=tf.uint16
+    )
+    assert image.dtype == tf.uint16
+    assert image.shape == [520, 696, 1]
+
+    region = tfio.experimental.image.decode_tiff_region(
+        contents, [100, 200], [64, 128], dtype=tf.uint16
+    )
+    assert region.shape == [64, 128, 1]
+    assert np.all(region.numpy() == image[100:164, 200:328].numpy())
+
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.experimental.image.decode_tiff_region(
+            contents, [500, 0], [64, 64], dtype=tf.uint16
+        )
+    with pytest.raises(tf.errors.InvalidArgumentError):
+        tfio.experimental.image.decode_tiff_region(
+            contents, [0, 0], [64, 64], dtype=tf.uint8
+        )
+
+
+def test_decode_tiff_region_tiled_separate():
+    """Test case for decode_tiff_region with tiles and separate planes"""
+    # The image is a 40x56, 3 band uint16 TIFF with 16x16 tiles and
+    # PLANARCONFIG_SEPARATE, written sample by sample with:
+    # data[y, x, c] = c * 10000 + y * 100 + x
+    y, x, c = np.meshgrid(np.arange(40), np.arange(56), np.arange(3), indexing="ij")
+    data = (c * 10000 + y * 100 + x).astype(np.uint16)
+
+    filename = os.path.join(
+        os.path.dirname(os.path.abspath(__file__)),
+        "test_image",
+        "tiled_separate.tif",
+    )
+    contents = tf.io.read_file(filename)
+
+    image = tfio.experimental.image.decode_tiff_region(
+        contents, [0, 0], [-1, -1], dtype=tf.uint16
+    )
+    assert image.dtype == tf.uint16
+    assert np.array_equal(image, data)
+
+    # Windows inside one tile, across tile boundaries and over the partial
+    # tiles at the bottom right edge.
+    for offset, size in [
+        ([1, 2], [5, 7]),
+        ([10, 12], [20, 30]),
+        ([30, 40], [10, 16]),
+        ([0, 55], [-1, 1]),
+    ]:
+        region = tfio.experimental.image.decode_tiff_region(
+            contents, offset, size, dtype=tf.uint16
+        )
+        h = data.shape[0] - offset[0] if size[0] < 0 else size[0]
+        w = data.shape[1] - offset[1] if size[1] < 0 else size[1]
+        expected = data[offset[0] : offset[0] + h, offset[1] : offset[1] + w]
+        assert np.array_equal(region, expected)
+
+    shape, dtype = tfio.experimental.image.decode_tiff_info(contents)
+    assert np.array_equal(shape[0], [40, 56, 3])
+    assert dtype[0].numpy() == tf.uint16
+
+
 if __name__ == "__main__":
     test.main()
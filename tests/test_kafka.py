@@ -15,7 +15,9 @@
 """Tests for Kafka Output Sequence."""
 
 
+import os
 import sys
+import tempfile
 import time
 import pytest
 import numpy as np
@@ -151,6 +153,44 @@ def test_kafka_io_dataset():
         )
 
 
+def test_kafka_io_dataset_metadata():
+    dataset = tfio.IODataset.from_kafka("test", include_metadata=True)
+    records = list(dataset)
+    assert [r["message"].numpy() for r in records] == [
+        ("D" + str(i)).encode() for i in range(10)
+    ]
+    assert [r["offset"].numpy() for r in records] == list(range(10))
+    assert all(r["timestamp"].numpy() > 0 for r in records)
+    assert all(r["header_key"].shape == [0] for r in records)
+
+
+def test_kafka_partitioned_io_dataset():
+    """Reads both partitions of 'partitioned-dataset-test' and checks that a
+    checkpointed iterator resumes every partition where it left off."""
+    dataset = tfio.experimental.streaming.KafkaPartitionedIODataset(
+        "partitioned-dataset-test", batch_size=3, capacity=2
+    )
+    iterator = iter(dataset)
+    checkpoint = tf.train.Checkpoint(iterator=iterator)
+    message, _, _, _ = next(iterator)
+    path = checkpoint.save(os.path.join(tempfile.mkdtemp(), "kafka"))
+    # A batch is returned as soon as any partition has messages, so the
+    # first one may hold fewer than batch_size.
+    messages = message.numpy().tolist()
+    consumed = len(messages)
+    for message, _, _, _ in iterator:
+        messages.extend(message.numpy().tolist())
+    assert sorted(messages) == [("D" + str(i)).encode() for i in range(10)]
+
+    resumed = iter(dataset)
+    tf.train.Checkpoint(iterator=resumed).restore(path)
+    remaining = []
+    for message, _, partition, _ in resumed:
+        remaining.extend(message.numpy().tolist())
+        assert set(partition.numpy().tolist()) <= {0, 1}
+    assert sorted(remaining) == sorted(messages[consumed:])
+
+
 def test_avro_encode_decode():
     """test_avro_encode_decode"""
     schema = (
@@ -527,3 +567,26 @@ def test_kafka_batch_io_dataset():
         assert issubclass(type(mini_d), tf.data.Dataset)
         # Fits the model as long as the data keeps on streaming
         model.fit(mini_d, epochs=5)
+
+
+def test_kafka_writer():
+    """Writes two batches asynchronously and reads them back."""
+    writer = tfio.experimental.streaming.KafkaWriter(
+        "writer-test", partition=0, linger_ms=10, compression="lz4"
+    )
+    first = writer.write(tf.constant(["D" + str(i) for i in range(5)]))
+    second = writer.write(
+        tf.constant(["D" + str(i) for i in range(5, 10)]),
+        key=tf.constant(["K" + str(i) for i in range(5, 10)]),
+    )
+    writer.flush()
+    results = writer.results()
+    assert results["batch"].numpy().tolist() == [first.numpy(), second.numpy()]
+    assert results["delivered"].numpy().tolist() == [5, 5]
+    assert results["failed"].numpy().tolist() == [0, 0]
+
+    # The topic keeps the messages of earlier runs, only check the tail.
+    dataset = tfio.IODataset.from_kafka("writer-test")
+    assert [m.numpy() for (m, _) in dataset][-10:] == [
+        ("D" + str(i)).encode() for i in range(10)
+    ]
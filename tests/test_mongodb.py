@@ -93,6 +93,27 @@ def test_dataset_read():
     assert count == len(RECORDS)
 
 
+@pytest.mark.skipif(not is_container_running(), reason="The container is not running")
+def test_dataset_read_spec():
+    """Test decoding the projected BSON fields directly into tensors"""
+
+    dataset = tfio.experimental.mongodb.MongoDBIODataset(
+        uri=URI, database=DATABASE, collection=COLLECTION, spec=SPECS, batch_size=100
+    )
+    assert dataset.element_spec == SPECS
+    count = 0
+    for d in dataset:
+        expected = RECORDS[count]
+        assert d["name"].numpy().decode() == expected["name"]
+        assert d["gender"].numpy().decode() == expected["gender"]
+        assert d["age"].numpy() == expected["age"]
+        assert d["fare"].numpy() == expected["fare"]
+        assert d["vip"].numpy() == expected["vip"]
+        assert d["survived"].numpy() == expected["survived"]
+        count += 1
+    assert count == len(RECORDS)
+
+
 @pytest.mark.skipif(not is_container_running(), reason="The container is not running")
 def test_train_model():
     """Test the dataset by training a tf.keras model"""
@@ -454,6 +454,16 @@ class OSSFSTest(test.TestCase):
         self.assertEqual("t", f.read(1))
         self.assertEqual("esting3\n\ntesting5", f.read())
 
+    def test_read_zero_length(self):
+        file_path = file_io.join(self._base_dir, "temp_file")
+        with gfile.Open(file_path, mode="w") as f:
+            f.write("testing1\ntesting2\n")
+        with gfile.Open(file_path, mode="rb") as f:
+            self.assertEqual(b"", f.read(0))
+            f.seek(9)
+            self.assertEqual(b"", f.read(0))
+            self.assertEqual(b"testing2\n", f.read(9))
+
     def test_read_error_reacquires_gil(self):
         file_path = file_io.join(self._base_dir, "temp_file")
         with gfile.Open(file_path, mode="r+") as f:
@@ -0,0 +1,145 @@
+# Copyright 2020 The TensorFlow Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License.  You may obtain a copy of
+# the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations under
+# the License.
+# ==============================================================================
+"""Tests for PrometheusIODataset against a synthetic Prometheus server"""
+
+import datetime
+import http.server
+import json
+import math
+import threading
+import urllib.parse
+
+import pytest
+import tensorflow_io as tfio
+
+JOB, INSTANCE = "synthetic", "localhost:0"
+
+
+def parse_time(value):
+    try:
+        return float(value)
+    except ValueError:
+        return datetime.datetime.fromisoformat(value.replace("Z", "+00:00")).timestamp()
+
+
+class SyntheticPrometheusHandler(http.server.BaseHTTPRequestHandler):
+    """Answers /api/v1/query_range with two series whose values are derived
+    from the sample timestamps, and records every range it was asked for.
+    Samples of series "b" at seconds where `second % 7 == 3` are missing."""
+
+    def do_GET(self):  # pylint: disable=invalid-name
+        self.query_range(urllib.parse.urlparse(self.path).query)
+
+    def do_POST(self):  # pylint: disable=invalid-name
+        length = int(self.headers.get("Content-Length", 0))
+        self.query_range(self.rfile.read(length).decode())
+
+    def query_range(self, query):
+        params = urllib.parse.parse_qs(query)
+        start = int(round(parse_time(params["start"][0]) * 1000))
+        end = int(round(parse_time(params["end"][0]) * 1000))
+        step = int(round(parse_time(params["step"][0]) * 1000))
+        self.server.ranges.append((start, end, step))
+
+        a, b = [], []
+        for timestamp in range(start, end + 1, step):
+            second = timestamp // 1000
+            a.append([timestamp / 1000, str(float(second))])
+            if second % 7 != 3:
+                b.append([timestamp / 1000, str(float(second * 2))])
+        result = [
+            {
+                "metric": {"__name__": name, "job": JOB, "instance": INSTANCE},
+                "values": values,
+            }
+            for name, values in (("a", a), ("b", b))
+        ]
+        body = json.dumps(
+            {"status": "success", "data": {"resultType": "matrix", "result": result}}
+        ).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, *args):  # pylint: disable=arguments-differ
+        pass
+
+
+@pytest.fixture(name="synthetic_prometheus")
+def fixture_synthetic_prometheus():
+    server = http.server.ThreadingHTTPServer(
+        ("localhost", 0), SyntheticPrometheusHandler
+    )
+    server.ranges = []
+    thread = threading.Thread(target=server.serve_forever, daemon=True)
+    thread.start()
+    yield server
+    server.shutdown()
+    server.server_close()
+
+
+@pytest.mark.parametrize(
+    ("window", "concurrency"),
+    [(1, 1), (2, 2), (3, 2), (5, 4), (7, 3), (1000, 4)],
+)
+def test_prometheus_window(synthetic_prometheus, window, concurrency):
+    """Sub-windows cover [start, stop) exactly once and are stitched in order"""
+    offset = 1600000000000
+    length = 23
+    endpoint = "http://localhost:%d" % synthetic_prometheus.server_port
+    dataset = tfio.experimental.IODataset.from_prometheus(
+        "{job='synthetic'}",
+        length,
+        offset=offset,
+        endpoint=endpoint,
+        window=window,
+        concurrency=concurrency,
+    )
+    # Creating the dataset probes the series, every later query is a read.
+    probes = len(synthetic_prometheus.ranges)
+    entries = [
+        (
+            timestamp.numpy(),
+            value[JOB][INSTANCE]["a"].numpy(),
+            value[JOB][INSTANCE]["b"].numpy(),
+        )
+        for timestamp, value in dataset
+    ]
+
+    start = offset - length * 1000
+    timestamps = list(range(start, offset, 1000))
+    assert [e[0] for e in entries] == timestamps
+    assert [e[1] for e in entries] == [t / 1000 for t in timestamps]
+    for (_, _, b), timestamp in zip(entries, timestamps):
+        second = timestamp // 1000
+        if second % 7 == 3:
+            assert math.isnan(b)
+        else:
+            assert b == second * 2
+
+    # Sub-windows must not overlap, skip or exceed `window` samples.
+    ranges = synthetic_prometheus.ranges[probes:]
+    covered = []
+    for range_start, range_end, step in ranges:
+        assert step == 1000
+        assert (range_end - range_start) // step + 1 <= window
+        covered.extend(range(range_start, range_end + 1, step))
+    assert sorted(covered) == timestamps
+    chunk = window * concurrency
+    assert len(ranges) == sum(
+        math.ceil(min(chunk, length - i) / window) for i in range(0, length, chunk)
+    )
@@ -239,5 +239,51 @@ def test_pulsar_write_keyed_messages():
     assert kv["2"] == [("msg-" + str(i)).encode() for i in range(2, 10, 3)]
 
 
+@pytest.mark.skipif(
+    sys.platform in ("win32",),
+    reason="TODO Pulsar not setup properly on Windows yet",
+)
+@pytest.mark.parametrize("compression", ["lz4", "zlib", "zstd", "snappy"])
+def test_pulsar_batch_write_and_receive(compression):
+    """Test writing a tensor of messages with a batching producer and
+    consuming them with batchReceive"""
+
+    topic = "test-batch-messages-" + compression
+    writer = tfio.experimental.streaming.PulsarWriter(
+        service_url="pulsar://localhost:6650",
+        topic=topic,
+        batching=True,
+        compression=compression,
+    )
+    # 1. Write 100 messages in two calls
+    writer.write(tf.constant(["msg-" + str(i) for i in range(50)]))
+    writer.write(tf.constant(["msg-" + str(i) for i in range(50, 100)]), key="k")
+    writer.flush()
+
+    # 2. Consume messages in batches and verify
+    dataset = tfio.experimental.streaming.PulsarIODataset(
+        service_url="pulsar://localhost:6650",
+        topic=topic,
+        subscription="subscription-0",
+        timeout=default_pulsar_timeout,
+        batch_receive=True,
+    )
+    messages = [(m.numpy(), k.numpy()) for (m, k) in dataset]
+    assert [m for (m, _) in messages] == [
+        ("msg-" + str(i)).encode() for i in range(100)
+    ]
+    assert [k for (_, k) in messages] == [b""] * 50 + [b"k"] * 50
+
+    # 3. All messages were acknowledged
+    dataset = tfio.experimental.streaming.PulsarIODataset(
+        service_url="pulsar://localhost:6650",
+        topic=topic,
+        subscription="subscription-0",
+        timeout=default_pulsar_timeout,
+        batch_receive=True,
+    )
+    assert len(list(dataset)) == 0
+
+
 if __name__ == "__main__":
     test.main()
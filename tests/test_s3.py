@@ -56,3 +56,40 @@ def test_read_file():
 
     content = tf.io.read_file(f"s3://{bucket_name}/{key_name}")
     assert content == body
+
+
+@pytest.mark.skipif(
+    sys.platform in ("win32", "darwin"),
+    reason="TODO Localstack not setup properly on macOS/Windows yet",
+)
+def test_stat_cache_invalidation():
+    """Test case for the S3 stat cache being dropped on write and delete"""
+    import boto3
+
+    os.environ["AWS_REGION"] = "us-east-1"
+    os.environ["AWS_ACCESS_KEY_ID"] = "ACCESS_KEY"
+    os.environ["AWS_SECRET_ACCESS_KEY"] = "SECRET_KEY"
+    os.environ["S3_VERIFY_SSL"] = "0"
+    os.environ["S3_ENDPOINT"] = "http://localhost:4566"
+
+    client = boto3.client(
+        "s3", region_name="us-east-1", endpoint_url="http://localhost:4566"
+    )
+    bucket_name = f"s3e{time.time()}e"
+    client.create_bucket(Bucket=bucket_name)
+    filename = f"s3://{bucket_name}/stat"
+
+    with tf.io.gfile.GFile(filename, "w") as f:
+        f.write("1234567")
+    assert tf.io.gfile.exists(filename)
+    assert tf.io.gfile.stat(filename).length == 7
+
+    tf.io.gfile.remove(filename)
+    assert not tf.io.gfile.exists(filename)
+    with pytest.raises(tf.errors.NotFoundError):
+        tf.io.gfile.stat(filename)
+
+    with tf.io.gfile.GFile(filename, "w") as f:
+        f.write("123")
+    assert tf.io.gfile.exists(filename)
+    assert tf.io.gfile.stat(filename).length == 3